@@ -0,0 +1,5 @@
+#pragma once
+
+#include <jank/c_api.h>
+
+extern "C" jank_object_ref jank_load_clojure_edn_native();
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <jank/analyze/expression.hpp>
+#include <jank/analyze/primitive_type.hpp>
 
 namespace jank::runtime::obj
 {
@@ -30,5 +31,13 @@ namespace jank::analyze::expr
      * back to it if an exception is thrown during eval. */
     runtime::obj::persistent_list_ref form{};
     native_vector<expression_ref> arg_exprs;
+    /* When the source is a var which, at analysis time, holds a jit_function with a fixed
+     * arity matching this call, these are that function's arity flags. Codegen uses them to
+     * guard a direct call to the arity, falling back to a dynamic call if the var has since
+     * been rebound to something with a different shape. */
+    jtl::option<u8> direct_call_arity_flags;
+    /* Memoized by infer_primitive_type, the same way as local_binding::inferred_type. */
+    mutable primitive_type inferred_type{ primitive_type::none };
+    mutable u64 inferred_generation{};
   };
 }
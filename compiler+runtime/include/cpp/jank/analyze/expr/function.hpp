@@ -14,6 +14,11 @@ namespace jank::analyze
   using local_binding_ptr = jtl::ptr<struct local_binding>;
 }
 
+namespace jank::evaluate
+{
+  struct function_tier;
+}
+
 namespace jank::analyze::expr
 {
   using function_ref = jtl::ref<struct function>;
@@ -75,6 +80,8 @@ namespace jank::analyze::expr
     jtl::immutable_string unique_name;
     native_vector<function_arity> arities;
     runtime::obj::persistent_hash_map_ref meta{};
+    /* Created by the interpreter, the first time it creates an instance of this fn. */
+    evaluate::function_tier *tier{};
   };
 }
 
@@ -4,6 +4,7 @@
 #include <jtl/option.hpp>
 
 #include <jank/runtime/obj/symbol.hpp>
+#include <jank/analyze/primitive_type.hpp>
 
 namespace jank::runtime
 {
@@ -48,6 +49,15 @@ namespace jank::analyze
     bool needs_box{ true };
     bool has_boxed_usage{};
     bool has_unboxed_usage{};
+    /* Set for locals which hold the same primitive type for their whole lifetime, either
+     * through a ^long/^double hint or, for loop params, through inference. Let bindings
+     * without a hint are instead typed by their value_expr. */
+    primitive_type unboxed_type{ primitive_type::none };
+    /* The last type inferred from value_expr, valid while inferred_generation matches
+     * step::primitive_type_generation(). Let chains refer back to earlier bindings, so
+     * without this each binding is inferred once per path to it. */
+    mutable primitive_type inferred_type{ primitive_type::none };
+    mutable u64 inferred_generation{};
 
     runtime::object_ref to_runtime_data() const;
   };
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <jank/type.hpp>
+
+namespace jank::analyze
+{
+  /* The raw, unboxed representation of a value, when analysis can prove one. Anything else
+   * is `none`, which means it's a boxed object. Booleans only come out of numeric
+   * comparisons, so they can feed an `if` condition without going through `truthy`. */
+  enum class primitive_type : u8
+  {
+    none,
+    i64,
+    f64,
+    boolean
+  };
+
+  constexpr char const *primitive_type_str(primitive_type const type)
+  {
+    switch(type)
+    {
+      case primitive_type::none:
+        return "none";
+      case primitive_type::i64:
+        return "i64";
+      case primitive_type::f64:
+        return "f64";
+      case primitive_type::boolean:
+        return "boolean";
+    }
+    return "unknown";
+  }
+
+  constexpr bool is_numeric(primitive_type const type)
+  {
+    return type == primitive_type::i64 || type == primitive_type::f64;
+  }
+}
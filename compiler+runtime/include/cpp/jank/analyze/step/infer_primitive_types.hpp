@@ -0,0 +1,62 @@
+#pragma once
+
+#include <jank/analyze/primitive_type.hpp>
+#include <jank/analyze/expr/call.hpp>
+#include <jank/analyze/expr/function.hpp>
+
+namespace jank::runtime::obj
+{
+  using symbol_ref = oref<struct symbol>;
+}
+
+namespace jank::analyze
+{
+  struct local_binding;
+}
+
+namespace jank::analyze::step
+{
+  /* The clojure.core numeric fns which codegen can emit inline, as raw instructions, when
+   * all of their args are primitives. Like Clojure's :inline, this means rebinding these
+   * vars won't affect already compiled primitive math. */
+  enum class primitive_op : u8
+  {
+    none,
+    add,
+    sub,
+    mul,
+    negate,
+    inc,
+    dec,
+    lt,
+    lte,
+    gt,
+    gte,
+    equiv
+  };
+
+  primitive_op primitive_call_op(expr::call const &call);
+
+  /* Reads a ^long or ^double hint from the symbol's :tag meta. */
+  primitive_type hinted_primitive_type(runtime::obj::symbol_ref sym);
+
+  /* The numeric type a local holds for its whole lifetime, if we can prove one. */
+  primitive_type local_primitive_type(local_binding const &binding);
+
+  /* The primitive type the expression can be generated as, without any boxing. Results are
+   * memoized on locals and calls, so this is linear in the size of the expression, but
+   * nothing else is mutated and it can be asked again after loop params are typed. */
+  primitive_type infer_primitive_type(expression_ref e);
+
+  /* Memoized types are only valid for the generation they were inferred in. Anything which
+   * changes a local's unboxed_type or value_expr after it may have been inferred needs to
+   * invalidate them. */
+  u64 primitive_type_generation();
+  void invalidate_primitive_types();
+
+  /* Types each loop param based on its initial value and on every recur back into the loop.
+   * Params which see mixed or unknown types stay boxed. Hinted params keep their hint and
+   * codegen will coerce into them. Mutated in place. */
+  void infer_loop_primitive_types(expr::function_arity const &arity,
+                                  native_vector<expression_ref> const &init_exprs);
+}
@@ -79,4 +79,109 @@ namespace jank::analyze
     throw std::runtime_error{ "Invalid expression kind "
                               + std::to_string(static_cast<int>(e->kind)) };
   }
+
+  template <typename F>
+  void walk_expr(expression_ref const expr, F const &f);
+
+  template <typename F>
+  void walk_expr(native_vector<expression_ref> const &exprs, F const &f)
+  {
+    for(auto const &expr : exprs)
+    {
+      walk_expr(expr, f);
+    }
+  }
+
+  /* Visits every expression within the tree, including those within nested fns. */
+  template <typename F>
+  void walk_expr(expression_ref const expr, F const &f)
+  {
+    visit_expr(
+      [&](auto const typed_expr) {
+        using T = typename decltype(typed_expr)::value_type;
+
+        if constexpr(std::same_as<T, expr::def>)
+        {
+          if(typed_expr->value.is_some())
+          {
+            walk_expr(typed_expr->value.unwrap(), f);
+          }
+        }
+        else if constexpr(std::same_as<T, expr::call>)
+        {
+          walk_expr(typed_expr->source_expr, f);
+          walk_expr(typed_expr->arg_exprs, f);
+        }
+        else if constexpr(std::same_as<T, expr::list> || std::same_as<T, expr::vector>
+                          || std::same_as<T, expr::set>)
+        {
+          walk_expr(typed_expr->data_exprs, f);
+        }
+        else if constexpr(std::same_as<T, expr::map>)
+        {
+          for(auto const &pair : typed_expr->data_exprs)
+          {
+            walk_expr(pair.first, f);
+            walk_expr(pair.second, f);
+          }
+        }
+        else if constexpr(std::same_as<T, expr::function>)
+        {
+          for(auto const &arity : typed_expr->arities)
+          {
+            walk_expr(arity.body, f);
+          }
+        }
+        else if constexpr(std::same_as<T, expr::recur> || std::same_as<T, expr::named_recursion>)
+        {
+          walk_expr(typed_expr->arg_exprs, f);
+        }
+        else if constexpr(std::same_as<T, expr::let> || std::same_as<T, expr::letfn>)
+        {
+          for(auto const &pair : typed_expr->pairs)
+          {
+            walk_expr(pair.second, f);
+          }
+          walk_expr(typed_expr->body, f);
+        }
+        else if constexpr(std::same_as<T, expr::do_>)
+        {
+          walk_expr(typed_expr->values, f);
+        }
+        else if constexpr(std::same_as<T, expr::if_>)
+        {
+          walk_expr(typed_expr->condition, f);
+          walk_expr(typed_expr->then, f);
+          if(typed_expr->else_.is_some())
+          {
+            walk_expr(typed_expr->else_.unwrap(), f);
+          }
+        }
+        else if constexpr(std::same_as<T, expr::throw_>)
+        {
+          walk_expr(typed_expr->value, f);
+        }
+        else if constexpr(std::same_as<T, expr::try_>)
+        {
+          walk_expr(typed_expr->body, f);
+          if(typed_expr->catch_body.is_some())
+          {
+            walk_expr(typed_expr->catch_body.unwrap().body, f);
+          }
+          if(typed_expr->finally_body.is_some())
+          {
+            walk_expr(typed_expr->finally_body.unwrap(), f);
+          }
+        }
+        else if constexpr(std::same_as<T, expr::case_>)
+        {
+          walk_expr(typed_expr->value_expr, f);
+          walk_expr(typed_expr->exprs, f);
+          walk_expr(typed_expr->default_expr, f);
+        }
+
+        f(typed_expr);
+      },
+      expr);
+  }
 }
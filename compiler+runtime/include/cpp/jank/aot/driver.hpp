@@ -0,0 +1,77 @@
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+#include <jtl/immutable_string.hpp>
+#include <jtl/option.hpp>
+#include <jtl/result.hpp>
+
+#include <jank/runtime/object.hpp>
+
+namespace jank::util::cli
+{
+  struct options;
+}
+
+namespace jank::codegen
+{
+  struct reusable_context;
+}
+
+namespace jank::runtime
+{
+  struct thread_pool;
+}
+
+/* Compiles a module, and every module it requires, into object files for linking.
+ *
+ * Before anything is loaded, the dependency graph is built by reading the `ns` form of each
+ * module's source. Modules are then compiled in dependency order. Loading a module evaluates
+ * it, which can define macros which the modules after it use, so analysis and evaluation
+ * stay on the calling thread. Emitting each module's object file is independent of every
+ * other module, though, and it's the bulk of the work, so the generated IR is handed off to
+ * a pool of threads while the next module is loaded. */
+namespace jank::aot
+{
+  /* The libs named by each `:require` and `:use` clause of an `ns` form, including those
+   * within prefix lists. Anything which isn't an `ns` form has none. */
+  native_vector<jtl::immutable_string> ns_form_deps(runtime::object_ref form);
+
+  struct driver
+  {
+    driver() = delete;
+    driver(util::cli::options const &opts);
+    driver(driver const &) = delete;
+    driver(driver &&) noexcept = delete;
+    ~driver();
+
+    /* Finds the module, and everything it requires, on the module path. Each module comes
+     * after everything it requires in the resulting order. */
+    jtl::string_result<void> build_graph(jtl::immutable_string const &module);
+
+    /* Builds the graph for the module and then compiles everything in it which isn't
+     * already loaded. Returns once every object file has been written. */
+    jtl::string_result<void> compile(jtl::immutable_string const &module);
+
+    /* Takes ownership of a module's generated IR and writes its object file on the pool. */
+    void emit(std::unique_ptr<codegen::reusable_context> ctx);
+
+    /* Waits for every object file which has been handed off to be written. */
+    jtl::string_result<void> await_emitted();
+
+    /* Called by the pool once an object file has been written, or has failed to be. */
+    void finish_emit(jtl::string_result<void> const &res);
+
+    native_vector<jtl::immutable_string> order;
+    usize jobs{};
+
+  private:
+    runtime::thread_pool *pool{};
+    std::mutex mutex;
+    std::condition_variable emitted_cv;
+    usize pending{};
+    jtl::option<jtl::immutable_string> error;
+  };
+}
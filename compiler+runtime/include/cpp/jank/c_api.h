@@ -283,6 +283,8 @@ extern "C"
   jank_bool jank_equal(jank_object_ref l, jank_object_ref r);
   jank_uhash jank_to_hash(jank_object_ref o);
   jank_i64 jank_to_integer(jank_object_ref o);
+  jank_i64 jank_unbox_integer(jank_object_ref o);
+  jank_f64 jank_unbox_real(jank_object_ref o);
   jank_i64 jank_shift_mask_case_integer(jank_object_ref o, jank_i64 shift, jank_i64 mask);
 
   void jank_set_meta(jank_object_ref o, jank_object_ref meta);
@@ -295,6 +297,9 @@ extern "C"
   void jank_profile_exit(char const *label);
   void jank_profile_report(char const *label);
 
+  char const *jank_allocation_fn_enter(char const *fn);
+  void jank_allocation_fn_exit(char const *prev);
+
   int jank_init(int const argc,
                 char const ** const argv,
                 jank_bool const init_default_ctx,
@@ -12,6 +12,7 @@
 #include <jtl/ptr.hpp>
 
 #include <jank/analyze/processor.hpp>
+#include <jank/analyze/primitive_type.hpp>
 
 namespace jank::runtime::obj
 {
@@ -71,6 +72,9 @@ namespace jank::codegen
   {
     reusable_context(jtl::immutable_string const &module_name);
 
+    /* Runs the pipeline for the CLI optimization level over the whole module. */
+    void optimize();
+
     jtl::immutable_string module_name;
     jtl::immutable_string ctor_name;
 
@@ -90,7 +94,7 @@ namespace jank::codegen
     native_unordered_map<jtl::immutable_string, llvm::Value *> c_string_globals;
 
     /* Optimization details. */
-    std::unique_ptr<llvm::FunctionPassManager> fpm;
+    std::unique_ptr<llvm::ModulePassManager> mpm;
     std::unique_ptr<llvm::LoopAnalysisManager> lam;
     std::unique_ptr<llvm::FunctionAnalysisManager> fam;
     std::unique_ptr<llvm::CGSCCAnalysisManager> cgam;
@@ -143,6 +147,23 @@ namespace jank::codegen
     llvm::Value *gen(analyze::expr::try_ref, analyze::expr::function_arity const &);
     llvm::Value *gen(analyze::expr::case_ref, analyze::expr::function_arity const &);
 
+    llvm::Value *gen_direct_call(llvm::Value *callee,
+                                 llvm::ArrayRef<llvm::Value *> arg_handles,
+                                 u8 arity_flags,
+                                 llvm::FunctionCallee fallback_fn);
+
+    /* Primitive codegen. These work with raw i64, double, and i1 values, rather than boxed
+     * objects. Inference decides where they're used and gen_box is how the values escape. */
+    llvm::Value *gen_unboxed(analyze::expression_ref,
+                             analyze::primitive_type type,
+                             analyze::expr::function_arity const &);
+    llvm::Value *gen_unboxed_call(analyze::expr::call_ref,
+                                  analyze::primitive_type type,
+                                  analyze::expr::function_arity const &);
+    llvm::Value *gen_box(llvm::Value *unboxed, analyze::primitive_type type) const;
+    llvm::Value *gen_unbox(llvm::Value *boxed, analyze::primitive_type type) const;
+    llvm::Value *gen_primitive_cast(llvm::Value *unboxed, analyze::primitive_type type) const;
+
     llvm::Value *gen_var(obj::symbol_ref qualified_name) const;
     llvm::Value *gen_c_string(jtl::immutable_string const &s) const;
 
@@ -151,6 +172,7 @@ namespace jank::codegen
     void create_function();
     void create_function(analyze::expr::function_arity const &arity);
     void create_global_ctor() const;
+    void gen_allocation_fn_scope() const;
     llvm::GlobalVariable *create_global_var(jtl::immutable_string const &name) const;
 
     llvm::Value *gen_global(runtime::obj::nil_ref) const;
@@ -175,6 +197,13 @@ namespace jank::codegen
     jtl::ptr<llvm::Function> fn{};
     std::unique_ptr<reusable_context> ctx;
     native_unordered_map<obj::symbol_ref, llvm::Value *> locals;
+    /* Locals which are kept as raw i64/double values. A local is in either this map or
+     * `locals`, never both. Unboxed locals are boxed on demand, where they escape. */
+    native_unordered_map<obj::symbol_ref, llvm::Value *> unboxed_locals;
+    /* For tail recursive arities, recur branches back to this block, which has a phi for
+     * each param, rather than calling the fn again. */
+    llvm::BasicBlock *recur_block{};
+    native_vector<llvm::PHINode *> recur_phis;
     /* TODO: Use gc allocator to avoid leaks. */
     std::list<deferred_init> deferred_inits{};
   };
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <initializer_list>
+
+#include <jank/runtime/object.hpp>
+#include <jank/runtime/behavior/callable.hpp>
+
+namespace jank::runtime::obj
+{
+  using symbol_ref = oref<struct symbol>;
+  struct interpreted_function;
+}
+
+namespace jank::analyze
+{
+  using expression_ref = jtl::ref<struct expression>;
+
+  namespace expr
+  {
+    struct function;
+  }
+}
+
+/* The interpreter runs analyzed expressions directly, rather than generating IR for them.
+ * Cold code, like most top-level forms and fns which are only called a few times, is
+ * much cheaper to interpret than to JIT compile. Fns count their calls and, once they're
+ * hot, they're queued to be JIT compiled on a background thread. The interpreted fn acts
+ * as a trampoline; it keeps interpreting until the compiled code is ready and then
+ * forwards every call to it. */
+namespace jank::evaluate
+{
+  /* The locals which are in scope at some point of interpretation. Each let, letfn, catch,
+   * and fn call gets its own environment, which points at the one it's nested in. Fns hold
+   * onto the environment in which they were created. */
+  struct environment : gc
+  {
+    /* Locals are found by name, innermost first, so shadowing works as it does in the
+     * analyzer. */
+    runtime::object_ref find(runtime::obj::symbol_ref sym) const;
+    /* The instance of the fn which is being called, for named recursion. */
+    runtime::object_ref find_fn(analyze::expr::function const *expr) const;
+
+    environment *parent{};
+    /* Only set for fn calls. */
+    analyze::expr::function const *fn_expr{};
+    runtime::object *fn{};
+    native_vector<std::pair<runtime::obj::symbol_ref, runtime::object_ref>> locals;
+  };
+
+  enum class function_tier_state : u8
+  {
+    interpreted,
+    /* Queued for compilation, or being compiled. Calls are still interpreted meanwhile. */
+    compiling,
+    compiled,
+    /* Some fns can't be compiled on their own, such as those which recurse into a fn
+     * which encloses them. These are always interpreted. */
+    failed
+  };
+
+  /* What we know about a fn expression, across every instance of it. */
+  struct function_tier : gc
+  {
+    runtime::behavior::callable::arity_flag_t arity_flags{};
+    jtl::option<runtime::object_ref> meta;
+    std::atomic<u32> calls{};
+    std::atomic<function_tier_state> state{ function_tier_state::interpreted };
+    /* Indexed by param count. These are set before the state becomes compiled. */
+    std::array<void *, runtime::max_params + 1> arities{};
+    /* The order of the captures within the closure context of the compiled fn. */
+    native_vector<runtime::obj::symbol_ref> captures;
+    /* The module the fn is compiled into, which is named after the ns it was hot in. */
+    jtl::immutable_string module;
+  };
+
+  runtime::object_ref interpret(analyze::expression_ref expr);
+  runtime::object_ref interpret_call(runtime::obj::interpreted_function &fn,
+                                     std::initializer_list<runtime::object_ref> args);
+
+  /* Blocks until every fn which has been queued for background compilation is compiled. */
+  void await_background_jit();
+}
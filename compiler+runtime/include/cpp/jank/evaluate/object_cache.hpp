@@ -0,0 +1,60 @@
+#pragma once
+
+#include <jtl/option.hpp>
+
+#include <jank/runtime/object.hpp>
+
+namespace jank::runtime
+{
+  using var_ref = oref<struct var>;
+}
+
+namespace jank::analyze::expr
+{
+  using function_ref = jtl::ref<struct function>;
+}
+
+/* A content addressed cache of the objects which eval JIT compiles. Each top-level form is
+ * keyed on a SHA-256 of the jank binary version, its ns, its source text, and the keys of
+ * the forms which defined every var it refers to, transitively. The transitive vars are
+ * found when the key is built, by following each var's form_deps, so a change to a var's
+ * definition changes the key of every form which depends on it, however indirectly. Macros
+ * are covered by this, too, since they're vars which are referred to by the source, or by
+ * the source of the macros which expand into them.
+ *
+ * Each fn which is compiled while evaluating a form gets its own object file, named after
+ * the form's key and the order in which it was compiled. Its symbols are named after its
+ * key, rather than the ns symbol counter, so they're stable across processes. */
+namespace jank::evaluate::object_cache
+{
+  /* Marks the top-level form which is being evaluated on this thread. Compiles outside of
+   * any form, or while the cache is disabled, aren't cached. */
+  struct form_scope
+  {
+    /* For evaluating data which has no source, like with eval. Its content isn't part of
+     * any key, so nothing compiled within it is cached. */
+    form_scope();
+    form_scope(runtime::object_ref form, native_persistent_string_view const &source);
+    ~form_scope();
+
+    jtl::immutable_string key;
+    /* Every var the key was built from, which any var this form defines will depend on. */
+    native_vector<runtime::var_ref> deps;
+    usize compiles{};
+    form_scope *prev{};
+  };
+
+  /* Whether the form being evaluated on this thread has a key, so what it compiles can be
+   * cached. Such forms are compiled, even when the interpreter is on, since interpreting
+   * them would leave nothing to load from the cache on the next start. */
+  bool caching();
+
+  /* Records that the current form defines this var. */
+  void note_def(runtime::var_ref var);
+
+  /* Loads the fn from the cache, compiling and caching it first on a miss, and then calls
+   * it. Nothing is returned if the fn can't be cached, in which case it should be compiled
+   * as normal. */
+  jtl::option<runtime::object_ref>
+  eval(analyze::expr::function_ref wrapped, jtl::immutable_string const &module);
+}
@@ -2,6 +2,7 @@
 
 #include <filesystem>
 #include <memory>
+#include <mutex>
 
 #include <clang/Interpreter/Interpreter.h>
 
@@ -41,6 +42,7 @@ namespace jank::jit
     template <typename T>
     jtl::string_result<T> find_symbol(jtl::immutable_string const &name) const
     {
+      std::lock_guard<std::recursive_mutex> const lock{ mutex };
       if(auto symbol{ interpreter->getSymbolAddress(name.c_str()) })
       {
         return symbol.get().toPtr<T>();
@@ -58,5 +60,9 @@ namespace jank::jit
     std::unique_ptr<clang::Interpreter> interpreter;
     i64 optimization_level{};
     native_vector<std::filesystem::path> library_dirs;
+    /* Hot fns are compiled on a background thread, while the calling thread may be
+     * loading modules or evaluating C++. The interpreter isn't safe to share, so everything
+     * which touches it takes this lock. */
+    mutable std::recursive_mutex mutex;
   };
 }
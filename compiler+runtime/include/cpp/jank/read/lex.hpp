@@ -239,6 +239,11 @@ namespace jank::read::lex
 
     jtl::result<token, error_ref> next();
     jtl::result<codepoint, error_ref> peek(usize const ahead = 1) const;
+    /* Where the comment starting at the offset ends, exclusive. That's at the next newline,
+     * the end of the file, or the first invalid character. */
+    usize comment_end(usize offset) const;
+    /* Moves past the ASCII symbol chars which follow the current position. */
+    void skip_symbol_chars();
     jtl::option<error_ref> check_whitespace(bool const found_space);
 
     iterator begin();
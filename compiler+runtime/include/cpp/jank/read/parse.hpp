@@ -6,9 +6,15 @@
 
 #include <jtl/result.hpp>
 #include <jank/read/lex.hpp>
+#include <jank/util/arena.hpp>
 #include <jank/runtime/object.hpp>
 #include <jank/runtime/var.hpp>
 
+namespace jank::runtime::obj
+{
+  using persistent_hash_map_ref = oref<struct persistent_hash_map>;
+}
+
 /* TODO: Rename file to processor. */
 namespace jank::read::parse
 {
@@ -106,11 +112,17 @@ namespace jank::read::parse
     /* Splicing, in reader conditionals, is not allowed at the top level. When we're parsing
      * some other form, such as a list, we'll bind this var to true. */
     runtime::var_ref splicing_allowed_var;
+    /* Every collection binds the var the same way, so the bindings are only made once. */
+    runtime::obj::persistent_hash_map_ref splicing_allowed_bindings;
     /* When we've spliced some forms, we'll put them into this list. Before reading the next
      * token, we should check this list to see if there's already a form we should pull out.
      * This is needed because parse iteration works one form at a time and splicing potentially
      * turns one form into many. */
     std::list<runtime::object_ref> pending_forms;
+    /* Scratch space for each collection as it's being read, like its items before they're put
+     * into the collection itself. Each collection rewinds it once it's done, so a whole
+     * top-level form is released in bulk, without the GC needing to see any of it. */
+    util::arena arena;
     lex::token latest_token;
     jtl::option<shorthand_function_details> shorthand;
     /* Whether or not the next form is considered quoted. */
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <jtl/primitive.hpp>
+
+/* Vectorized scanners for the lexer's hot loops. Each finds how long a run of bytes of
+ * some class is, from the start of the data, so the lexer can skip the whole run at once,
+ * rather than decoding it one codepoint at a time.
+ *
+ * Every run only contains ASCII. The lexer validates, and decodes, everything else, so a
+ * run stopping early is always safe; the lexer just picks up from there one codepoint at
+ * a time, as it always has.
+ *
+ * On x86_64, SSE2 is always there and AVX2 is used when the CPU supports it. Elsewhere,
+ * the scanners are scalar. */
+namespace jank::read::lex::scan
+{
+  enum class isa : u8
+  {
+    scalar,
+    sse2,
+    avx2
+  };
+
+  constexpr char const *isa_str(isa const i)
+  {
+    switch(i)
+    {
+      case isa::scalar:
+        return "scalar";
+      case isa::sse2:
+        return "sse2";
+      case isa::avx2:
+        return "avx2";
+    }
+    return "unknown";
+  }
+
+  /* The best which this CPU supports. This is what's used by default. */
+  isa best_isa();
+  /* Switches every scanner to the given ISA, which must be supported. This is for tests
+   * and benchmarks. */
+  void use_isa(isa i);
+  isa current_isa();
+
+  /* Spaces, tabs, newlines, and the rest of what std::isspace accepts, as well as commas. */
+  usize whitespace(char const *data, usize size);
+  /* Anything other than a newline. */
+  usize comment(char const *data, usize size);
+  /* ASCII chars which can be within a symbol, or keyword. This matches the lexer's
+   * is_symbol_char. */
+  usize symbol(char const *data, usize size);
+  /* Anything other than a null, a double quote, or a backslash. */
+  usize string(char const *data, usize size);
+
+  struct newlines
+  {
+    usize count{};
+    /* Only valid if the count isn't zero. */
+    usize last{};
+  };
+
+  newlines find_newlines(char const *data, usize size);
+}
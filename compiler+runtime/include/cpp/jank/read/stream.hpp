@@ -0,0 +1,58 @@
+#pragma once
+
+#include <optional>
+
+#include <jank/read/lex.hpp>
+#include <jank/read/parse.hpp>
+
+namespace jank::read
+{
+  /* Reads forms, one at a time, from a file descriptor, like a pipe, a socket, or a file
+   * too big to keep in memory. Input is read in chunks and only as much is kept as is
+   * needed for the form being read, so memory is bounded by the largest form, rather than
+   * the whole input.
+   *
+   * The lexer and parser still work on a contiguous buffer. When a form may continue past
+   * what's been read so far, the buffer is refilled and the form is read again from its
+   * start. A form is known to be done when it ends with a closing delimiter, or when
+   * anything follows it. A trailing symbol or number, for example, isn't done until
+   * there's a delimiter after it, or the input ends.
+   *
+   * Positions in forms and errors are relative to the buffer, since the input before it
+   * is gone by then. */
+  struct stream : gc_cleanup
+  {
+    static constexpr usize default_chunk_size{ 64 * 1024 };
+
+    stream() = delete;
+    stream(int fd, bool owns_fd, usize chunk_size = default_chunk_size);
+    stream(stream const &) = delete;
+    stream(stream &&) noexcept = delete;
+    ~stream();
+
+    static jtl::string_result<stream *> open(jtl::immutable_string const &path);
+
+    /* The next form, or none once the input is exhausted. Closing the stream also ends the
+     * input. */
+    parse::processor::object_result next();
+    void close();
+
+    int fd{ -1 };
+    bool owns_fd{};
+    bool eof{};
+    usize chunk_size{};
+
+  private:
+    jtl::string_result<void> refill();
+    void restart();
+
+    native_transient_string buffer;
+    /* Where the form being read starts within the buffer. Everything before it is done. */
+    usize form_start{};
+    std::optional<lex::processor> lexer;
+    std::optional<parse::processor> parser;
+    /* Once a form fails to read, there's no telling where the next one starts, so every
+     * read after that fails the same way. */
+    jtl::option<error_ref> failure;
+  };
+}
@@ -185,6 +185,22 @@ namespace jank::runtime
         return (arity_flags & 0b01000000);
       }
 
+      /* Determines whether a call with the specified number of args would be dispatched
+       * straight to the arity with that many params, as opposed to the variadic arity.
+       * This mirrors the switches in dynamic_call. */
+      static constexpr bool is_fixed_arity_call(arity_flag_t const arity_flags,
+                                                u8 const arg_count)
+      {
+        if(!(arity_flags & 0b10000000))
+        {
+          return true;
+        }
+
+        auto const required_args(arity_flags & 0b00111111);
+        return arg_count < required_args
+          || (arg_count == required_args && is_variadic_ambiguous(arity_flags));
+      }
+
       static constexpr arity_flag_t build_arity_flags(u8 const highest_fixed_arity,
                                                       bool const is_variadic,
                                                       bool const is_variadic_ambiguous)
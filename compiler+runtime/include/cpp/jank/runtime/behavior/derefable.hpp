@@ -6,4 +6,17 @@ namespace jank::runtime::behavior
   concept derefable = requires(T * const t) {
     { t->deref() } -> std::convertible_to<object_ref>;
   };
+
+  /* Derefing these may block, so they also support giving up after a timeout, in which
+   * case the timeout value is returned instead. */
+  template <typename T>
+  concept blocking_derefable = requires(T * const t) {
+    { t->deref(i64{}, object_ref{}) } -> std::convertible_to<object_ref>;
+  };
+
+  /* Values which are produced at some point after the object is created. */
+  template <typename T>
+  concept pending = requires(T const * const t) {
+    { t->is_realized() } -> std::convertible_to<bool>;
+  };
 }
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <jank/runtime/object.hpp>
+
+namespace jank::runtime::behavior
+{
+  /* References to state which changes over time, which can have a validator to reject
+   * new states and watches to be told about them. */
+  template <typename T>
+  concept ref_like = requires(T * const t) {
+    { t->set_validator(object_ref{}) } -> std::same_as<void>;
+    { t->get_validator() } -> std::convertible_to<object_ref>;
+    { t->add_watch(object_ref{}, object_ref{}) } -> std::same_as<void>;
+    { t->remove_watch(object_ref{}) } -> std::same_as<void>;
+  };
+}
@@ -9,6 +9,7 @@
 #include <jank/runtime/module/loader.hpp>
 #include <jank/runtime/ns.hpp>
 #include <jank/runtime/var.hpp>
+#include <jank/runtime/detail/intern_table.hpp>
 #include <jank/jit/processor.hpp>
 #include <jank/util/cli.hpp>
 
@@ -23,6 +24,11 @@ namespace jank
   {
     struct reusable_context;
   }
+
+  namespace aot
+  {
+    struct driver;
+  }
 }
 
 namespace jank::runtime
@@ -73,6 +79,11 @@ namespace jank::runtime
     jtl::result<obj::keyword_ref, jtl::immutable_string>
     intern_keyword(jtl::immutable_string const &s);
 
+    /* Canonical symbols, without meta, which compare by identity with each other. */
+    obj::symbol_ref intern_symbol(jtl::immutable_string const &ns,
+                                  jtl::immutable_string const &name);
+    obj::symbol_ref intern_symbol(jtl::immutable_string const &s);
+
     object_ref macroexpand1(object_ref o);
     object_ref macroexpand(object_ref o);
 
@@ -105,6 +116,8 @@ namespace jank::runtime
 
     jtl::string_result<void> write_module(jtl::immutable_string const &module_name,
                                           std::unique_ptr<llvm::Module> const &module) const;
+    jtl::string_result<void> write_object(std::filesystem::path const &path,
+                                          std::unique_ptr<llvm::Module> const &module) const;
 
     /* Generates a unique name for use with anything from codgen structs,
      * lifted vars, to shadowed locals. */
@@ -114,12 +127,14 @@ namespace jank::runtime
     obj::symbol unique_symbol(native_persistent_string_view const &prefix) const;
 
     folly::Synchronized<native_unordered_map<obj::symbol_ref, ns_ref>> namespaces;
-    folly::Synchronized<native_unordered_map<jtl::immutable_string, obj::keyword_ref>> keywords;
+    detail::keyword_table keywords;
+    detail::symbol_table symbols;
 
     struct binding_scope
     {
       binding_scope(context &rt_ctx);
       binding_scope(context &rt_ctx, obj::persistent_hash_map_ref const bindings);
+      binding_scope(context &rt_ctx, thread_binding_frame const *frame);
       ~binding_scope();
 
       context &rt_ctx;
@@ -130,19 +145,43 @@ namespace jank::runtime
     jtl::string_result<void> push_thread_bindings(obj::persistent_hash_map_ref const bindings);
     jtl::string_result<void> pop_thread_bindings();
     obj::persistent_hash_map_ref get_thread_bindings() const;
-    jtl::option<thread_binding_frame> current_thread_binding_frame();
+    /* Captures the calling thread's bindings, in constant time. Pushing the captured frame,
+     * on any thread, replaces that thread's bindings with them until it's popped. The
+     * bindings themselves are shared, rather than copied, so only the thread which made a
+     * binding can set! it, like in Clojure. */
+    thread_binding_frame const *capture_thread_bindings() const;
+    jtl::string_result<void> push_thread_bindings(thread_binding_frame const *frame);
+    /* The calling thread's bindings within this context. */
+    thread_bindings &current_thread_bindings() const;
 
     /* The analyze processor is reused across evaluations so we can keep the semantic information
      * of previous code. This is essential for REPL use. */
     /* TODO: This needs to be synchronized. */
     analyze::processor an_prc{ *this };
     jit::processor jit_prc;
-    /* TODO: This needs to be a dynamic var. */
-    native_unordered_map<jtl::immutable_string, native_vector<jtl::immutable_string>>
+    /* Whether top-level forms and cold fns are interpreted, rather than JIT compiled. */
+    bool interpret{};
+    /* How many calls, or loop iterations, an interpreted fn gets before it's JIT compiled.
+     * Zero means never. */
+    u32 jit_threshold{};
+    /* Whether hot fns are compiled on a background thread, rather than by the call which
+     * made them hot. */
+    bool background_jit{};
+    /* Whether the reader builds its symbols from canonical, interned symbols. */
+    bool intern_symbols{};
+    /* Whether objects JIT compiled by eval are cached on disk, keyed on the form's content.
+     * Forms which are cached are compiled, even when interpreting. */
+    bool jit_cache{};
+    /* Filled in up front by the compile driver, from each module's ns form. */
+    folly::Synchronized<
+      native_unordered_map<jtl::immutable_string, native_vector<jtl::immutable_string>>>
       module_dependencies;
     folly::Synchronized<native_deque<jtl::immutable_string>> loaded_modules_in_order;
     jtl::immutable_string binary_cache_dir;
     module::loader module_loader;
+    /* While set, compiled modules are handed to it to be written, rather than being
+     * written by the thread which compiled them. */
+    aot::driver *compile_driver{};
 
     var_ref current_file_var;
     var_ref current_ns_var;
@@ -151,12 +190,12 @@ namespace jank::runtime
     var_ref loaded_libs_var;
     var_ref current_module_var;
     var_ref assert_var;
+    var_ref agent_var;
     var_ref no_recur_var;
     var_ref gensym_env_var;
 
-    /* TODO: Remove this map. Just use the list. */
-    static thread_local native_unordered_map<context const *, std::list<thread_binding_frame>>
-      thread_binding_frames;
+    static thread_local native_unordered_map<context const *, thread_bindings>
+      thread_bindings_by_context;
   };
 
   /* NOLINTNEXTLINE */
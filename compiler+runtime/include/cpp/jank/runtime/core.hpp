@@ -52,6 +52,8 @@ namespace jank::runtime
 
   object_ref atom(object_ref o);
   object_ref deref(object_ref o);
+  object_ref deref(object_ref o, object_ref timeout_ms, object_ref timeout_val);
+  bool is_realized(object_ref o);
   object_ref swap_atom(object_ref atom, object_ref fn);
   object_ref swap_atom(object_ref atom, object_ref fn, object_ref a1);
   object_ref swap_atom(object_ref atom, object_ref fn, object_ref a1, object_ref a2);
@@ -75,9 +77,39 @@ namespace jank::runtime
   void push_thread_bindings(object_ref o);
   void pop_thread_bindings();
   object_ref get_thread_bindings();
+  /* The calling thread's innermost thread_binding_frame, or nil if nothing is bound. It can
+   * be installed on any thread with call_with_thread_bindings, which throws for anything
+   * else. */
+  object_ref capture_thread_bindings();
+  object_ref call_with_thread_bindings(object_ref bindings, object_ref f, object_ref args);
 
   object_ref force(object_ref o);
 
+  object_ref future_call(object_ref fn);
+  bool is_future(object_ref o);
+  bool is_future_done(object_ref o);
+  bool future_cancel(object_ref o);
+  bool is_future_cancelled(object_ref o);
+
+  object_ref agent(object_ref state);
+  object_ref agent_send(object_ref a, object_ref fn, object_ref args);
+  object_ref agent_send_off(object_ref a, object_ref fn, object_ref args);
+  object_ref agent_await(object_ref agents);
+  bool agent_await_for(object_ref timeout_ms, object_ref agents);
+  i64 release_pending_sends();
+  object_ref agent_error(object_ref a);
+  object_ref restart_agent(object_ref a, object_ref new_state, object_ref clear_actions);
+  object_ref set_error_handler(object_ref a, object_ref fn);
+  object_ref error_handler(object_ref a);
+  object_ref set_error_mode(object_ref a, object_ref mode);
+  object_ref error_mode(object_ref a);
+  object_ref shutdown_agents();
+
+  object_ref set_validator(object_ref ref, object_ref fn);
+  object_ref get_validator(object_ref ref);
+  object_ref add_watch(object_ref ref, object_ref key, object_ref fn);
+  object_ref remove_watch(object_ref ref, object_ref key);
+
   object_ref tagged_literal(object_ref tag, object_ref form);
   bool is_tagged_literal(object_ref o);
 }
@@ -25,15 +25,20 @@ namespace jank::runtime
   }
 
   [[gnu::always_inline, gnu::flatten, gnu::hot]]
-  inline auto make_box(int const i)
+  inline obj::integer_ref make_box(i64 const i)
   {
-    return make_box<obj::integer>(static_cast<i64>(i));
+    if(is_integer_cached(i))
+    {
+      detail::count_cached_box();
+      return cached_integer(i);
+    }
+    return make_box<obj::integer>(i);
   }
 
   [[gnu::always_inline, gnu::flatten, gnu::hot]]
-  inline auto make_box(i64 const i)
+  inline auto make_box(int const i)
   {
-    return make_box<obj::integer>(i);
+    return make_box(static_cast<i64>(i));
   }
 
   [[gnu::always_inline, gnu::flatten, gnu::hot]]
@@ -45,13 +50,14 @@ namespace jank::runtime
   [[gnu::always_inline, gnu::flatten, gnu::hot]]
   inline auto make_box(char const i)
   {
-    return make_box<obj::character>(i);
+    detail::count_cached_box();
+    return cached_character(i);
   }
 
   [[gnu::always_inline, gnu::flatten, gnu::hot]]
   inline auto make_box(usize const i)
   {
-    return make_box<obj::integer>(static_cast<i64>(i));
+    return make_box(static_cast<i64>(i));
   }
 
   [[gnu::always_inline, gnu::flatten, gnu::hot]]
@@ -98,7 +104,7 @@ namespace jank::runtime
   [[gnu::always_inline, gnu::flatten, gnu::hot]]
   inline auto make_box(T const d)
   {
-    return make_box<obj::integer>(d);
+    return make_box(static_cast<i64>(d));
   }
 
   template <typename T>
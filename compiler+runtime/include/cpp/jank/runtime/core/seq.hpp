@@ -146,6 +146,10 @@ namespace jank::runtime
   usize sequence_length(object_ref const s, usize const max);
 
   object_ref reduce(object_ref f, object_ref init, object_ref s);
+  /* A parallel reduce, like clojure.core.reducers/fold. Persistent vectors, hash maps and
+   * hash sets are split along their leaf nodes into pieces of roughly n elements. Hash
+   * maps are reduced with (reducef acc k v). Everything else is reduced serially. */
+  object_ref fold(object_ref n, object_ref combinef, object_ref reducef, object_ref coll);
   object_ref reduced(object_ref o);
   bool is_reduced(object_ref o);
 
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <limits>
+
+#include <jank/type.hpp>
+
+namespace jank::runtime
+{
+  enum class object_type : u8;
+}
+
+namespace jank::runtime::detail
+{
+  /* Counts of what make_box has done. These are relaxed, so they're only meaningful
+   * as totals, after the fact. They're here so we can measure how much boxing some
+   * code does and whether the box caches are getting hit.
+   *
+   * Each thread counts into its own block, so boxing on many threads doesn't bounce a
+   * shared cache line between them. Reading the totals sums every block. */
+  struct allocation_stats
+  {
+    /* Boxes which were actually allocated from the GC. */
+    std::atomic<u64> boxes{};
+    /* Boxes which were served from a preallocated cache, without allocating. */
+    std::atomic<u64> cached_boxes{};
+    /* Allocated boxes, indexed by object_type. */
+    std::array<std::atomic<u64>, std::numeric_limits<u8>::max() + 1> boxes_by_type{};
+  };
+
+  struct allocation_totals
+  {
+    u64 boxes{};
+    u64 cached_boxes{};
+    std::array<u64, std::numeric_limits<u8>::max() + 1> boxes_by_type{};
+  };
+
+  /* Sums the counts of every thread, including those which have since exited. */
+  allocation_totals box_allocation_totals();
+
+  /* This is null until the thread boxes something. */
+  /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+  extern constinit thread_local allocation_stats *thread_allocation_stats;
+  allocation_stats &register_thread_allocation_stats();
+
+  [[gnu::always_inline]]
+  inline allocation_stats &current_allocation_stats()
+  {
+    auto const stats(thread_allocation_stats);
+    if(!stats) [[unlikely]]
+    {
+      return register_thread_allocation_stats();
+    }
+    return *stats;
+  }
+
+  /* Every this many boxes, on each thread, where the box was made is recorded. Zero, the
+   * default, turns sampling off. */
+  /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+  extern std::atomic<u64> allocation_sample_interval;
+  void sample_box_allocation(object_type type);
+
+  /* The qualified name of the jank fn which is running on this thread, if it's known.
+   * Sampled boxes are attributed to it, since JIT compiled frames can't be symbolized.
+   * The interpreter sets it on every call. JIT compiled fns only set it if sampling was
+   * on when they were compiled, so that they don't pay for it otherwise. */
+  /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+  extern constinit thread_local char const *current_allocation_fn;
+
+  /* Sets the current fn for its lifetime. JIT compiled fns restore the previous fn on
+   * return, but not when an exception unwinds through them, so anything which catches
+   * jank exceptions keeps one of these around to restore its own. */
+  struct allocation_fn_scope
+  {
+    explicit allocation_fn_scope(char const * const fn)
+      : prev{ current_allocation_fn }
+    {
+      current_allocation_fn = fn;
+    }
+
+    allocation_fn_scope(allocation_fn_scope const &) = delete;
+    allocation_fn_scope(allocation_fn_scope &&) = delete;
+
+    ~allocation_fn_scope()
+    {
+      current_allocation_fn = prev;
+    }
+
+    allocation_fn_scope &operator=(allocation_fn_scope const &) = delete;
+    allocation_fn_scope &operator=(allocation_fn_scope &&) = delete;
+
+    char const *prev{};
+  };
+
+  [[gnu::always_inline]]
+  inline void count_box_allocation(object_type const type)
+  {
+    auto &stats(current_allocation_stats());
+    stats.boxes.fetch_add(1, std::memory_order_relaxed);
+    stats.boxes_by_type[static_cast<u8>(type)].fetch_add(1, std::memory_order_relaxed);
+    if(allocation_sample_interval.load(std::memory_order_relaxed) != 0) [[unlikely]]
+    {
+      sample_box_allocation(type);
+    }
+  }
+
+  [[gnu::always_inline]]
+  inline void count_cached_box()
+  {
+    current_allocation_stats().cached_boxes.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /* What we know of the GC's collections, from its collection events. Pauses are timed from
+   * the start of a collection to its end, since jank doesn't use incremental collection, so
+   * the world is stopped throughout. */
+  struct collection_stats
+  {
+    u64 collections{};
+    u64 total_pause_ns{};
+    u64 max_pause_ns{};
+  };
+
+  /* Starts listening for collection events. This needs to happen once the GC is up. */
+  void track_collections();
+  collection_stats current_collection_stats();
+
+  struct allocation_site
+  {
+    jtl::immutable_string site;
+    u64 samples{};
+  };
+
+  /* Resolves where each sampled box was made, grouping by the jank fn which was running,
+   * or, outside of any known jank fn, by the first frame outside of the runtime's
+   * allocation pipework. Resolving is slow, so this is meant to be done rarely. */
+  native_vector<allocation_site> sampled_allocation_sites();
+  void clear_allocation_samples();
+}
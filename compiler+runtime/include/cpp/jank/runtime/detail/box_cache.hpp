@@ -0,0 +1,105 @@
+#pragma once
+
+#include <gc/gc.h>
+
+#include <jank/type.hpp>
+
+namespace jank::runtime::detail
+{
+  /* Allocating from the GC takes its allocation lock, which gets contended once a few
+   * threads are boxing numbers or building seqs at the same time. Instead, each thread keeps
+   * a free list for each small size class, which it refills in batches with GC_malloc_many,
+   * so the lock is taken once per batch rather than once per box.
+   *
+   * An object type opts in with
+   *
+   *   static constexpr bool thread_cached{ true };
+   *
+   * Boxes with pointers come from the scanned heap and are linked through their first word,
+   * which the GC follows. Pointer free boxes come from the pointer free heap, like
+   * GC_malloc_atomic, so their payloads are never scanned. The GC wouldn't follow links
+   * through them, though, so they're kept on a stack within the cache instead. */
+  struct box_cache
+  {
+    static constexpr usize granule_size{ 16 };
+    static constexpr usize max_size{ 256 };
+    static constexpr usize class_count{ max_size / granule_size };
+    /* Pointer free boxes are numbers, so there's no need for bigger classes. */
+    static constexpr usize max_pointer_free_size{ 32 };
+    static constexpr usize pointer_free_class_count{ max_pointer_free_size / granule_size };
+    /* About a page worth of the smallest boxes, which is about what a batch holds. */
+    static constexpr usize pointer_free_capacity{ 256 };
+
+    /* Each list is linked through the first word of each box. */
+    void *free_lists[class_count]{};
+    void *pointer_free_boxes[pointer_free_class_count][pointer_free_capacity]{};
+    usize pointer_free_counts[pointer_free_class_count]{};
+  };
+
+  /* This is null until the thread allocates its first cached box. The cache itself is
+   * uncollectable, so the GC sees it, and everything on its lists, as a root. */
+  /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+  extern constinit thread_local box_cache *thread_box_cache;
+
+  /* Sets up the thread's cache, if need be, and refills the given class. Returns one box from
+   * the new batch. */
+  void *refill_box_cache(usize size_class);
+  void *refill_pointer_free_box_cache(usize size_class);
+
+  template <typename T>
+  concept thread_cached = requires { T::thread_cached; } && T::thread_cached;
+
+  template <typename T>
+  concept pointer_free = requires { T::pointer_free; } && T::pointer_free;
+
+  template <usize Size>
+  [[gnu::always_inline]]
+  inline void *allocate_cached_box()
+  {
+    static_assert(Size <= box_cache::max_size, "this type is too big to be thread cached");
+    static constexpr usize size_class{ (Size + box_cache::granule_size - 1)
+                                         / box_cache::granule_size
+                                       - 1 };
+
+    auto const cache(thread_box_cache);
+    if(cache)
+    {
+      auto &head(cache->free_lists[size_class]);
+      if(head)
+      {
+        auto const ret(head);
+        head = GC_NEXT(ret);
+        GC_NEXT(ret) = nullptr;
+        return ret;
+      }
+    }
+    return refill_box_cache(size_class);
+  }
+
+  template <usize Size>
+  [[gnu::always_inline]]
+  inline void *allocate_cached_pointer_free_box()
+  {
+    static_assert(Size <= box_cache::max_pointer_free_size,
+                  "this pointer free type is too big to be thread cached");
+    static constexpr usize size_class{ (Size + box_cache::granule_size - 1)
+                                         / box_cache::granule_size
+                                       - 1 };
+
+    auto const cache(thread_box_cache);
+    if(cache)
+    {
+      auto &count(cache->pointer_free_counts[size_class]);
+      if(count)
+      {
+        --count;
+        auto &slot(cache->pointer_free_boxes[size_class][count]);
+        auto const ret(slot);
+        /* Otherwise, the stack would keep the box alive after it's garbage. */
+        slot = nullptr;
+        return ret;
+      }
+    }
+    return refill_pointer_free_box_cache(size_class);
+  }
+}
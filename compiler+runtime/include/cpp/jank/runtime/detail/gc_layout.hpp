@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+
+#include <gc/gc_typed.h>
+
+#include <jank/type.hpp>
+
+namespace jank::runtime::detail
+{
+  /* By default, the GC scans every word of an object, since any of them could be a pointer.
+   * For objects which are mostly string bytes or numbers, that's a lot of wasted work. An
+   * object can instead describe which of its words may hold pointers, by defining
+   *
+   *   static void gc_layout(runtime::detail::gc_layout &layout);
+   *
+   * and marking each of its pointer members. make_box will then allocate it with a typed
+   * descriptor and the GC will only scan the marked words. Anything which isn't marked is
+   * never scanned, so a missed member will be collected out from under us. When in doubt,
+   * mark the whole member with words(). */
+  struct gc_layout
+  {
+    /* A member which is exactly one pointer. */
+    void pointer(usize const offset)
+    {
+      mark(offset);
+    }
+
+    /* Every word of a member, for members where we can't say which words are pointers, like
+     * an option. */
+    void words(usize const offset, usize const size)
+    {
+      for(usize i{}; i < size; i += sizeof(GC_word))
+      {
+        mark(offset + i);
+      }
+    }
+
+    /* Only the first word of an immutable_string can point anywhere, since it's the data
+     * pointer of a large string. The rest is the size, flags, and hash, or the chars of a
+     * small string. */
+    void string(usize const offset)
+    {
+      mark(offset);
+    }
+
+    void mark(usize const offset)
+    {
+      GC_set_bit(bitmap, offset / sizeof(GC_word));
+    }
+
+    GC_word *bitmap{};
+  };
+
+  template <typename T>
+  GC_descr gc_descriptor()
+  {
+    static GC_descr const descr{ [] {
+      GC_word bitmap[GC_BITMAP_SIZE(T)]{};
+      gc_layout layout{ bitmap };
+      T::gc_layout(layout);
+      return GC_make_descriptor(bitmap, GC_WORD_LEN(T));
+    }() };
+    return descr;
+  }
+
+  /* When the GC isn't recognizing all interior pointers, a pointer to an object's base is
+   * only recognized if its offset has been registered. Most objects have their base first,
+   * so there's nothing to do. */
+  template <typename T>
+  void register_base_displacement()
+  {
+    if constexpr(offsetof(T, base) != 0)
+    {
+      static bool const registered{ [] {
+        GC_register_displacement(offsetof(T, base));
+        return true;
+      }() };
+      static_cast<void>(registered);
+    }
+  }
+}
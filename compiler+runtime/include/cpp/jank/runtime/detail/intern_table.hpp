@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+
+#include <jank/runtime/object.hpp>
+
+namespace jank::runtime::obj
+{
+  using keyword_ref = oref<struct keyword>;
+  using symbol_ref = oref<struct symbol>;
+}
+
+namespace jank::runtime::detail
+{
+  /* Every interned keyword, or symbol, keyed by its ns and name. These are looked up far
+   * more often than they're created, so lookups don't take a lock. They probe an open
+   * addressed table which is only published once it's complete and which is only ever
+   * added to. Inserts are serialized by a mutex. When the table fills up, the insert builds
+   * a bigger one and publishes it in place of the old one. Old tables are left to the GC,
+   * since readers may still be probing them. */
+  template <typename T>
+  struct intern_table
+  {
+    struct slot
+    {
+      /* Set last, so a non-null value means the hash is valid. */
+      std::atomic<T *> value{};
+      uhash hash{};
+    };
+
+    struct table
+    {
+      /* Always a power of two. */
+      usize capacity{};
+      slot *slots{};
+    };
+
+    intern_table();
+
+    /* An empty ns means an unqualified name. */
+    oref<T> intern(jtl::immutable_string const &ns, jtl::immutable_string const &name);
+
+    usize size() const;
+
+  private:
+    std::atomic<table *> current{};
+    /* Guarded by the mutex. */
+    usize count{};
+    mutable std::mutex mutex;
+  };
+
+  extern template struct intern_table<obj::keyword>;
+  extern template struct intern_table<obj::symbol>;
+
+  using keyword_table = intern_table<obj::keyword>;
+  using symbol_table = intern_table<obj::symbol>;
+}
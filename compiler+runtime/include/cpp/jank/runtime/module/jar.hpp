@@ -0,0 +1,77 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+
+#include <jank/runtime/module/loader.hpp>
+
+namespace libzippp
+{
+  class ZipArchive;
+}
+
+namespace jank::runtime::module
+{
+  /* An open JAR on the module path. Every JAR is opened, and memory mapped, once per
+   * process and its central directory is indexed, so reading an entry is just a lookup.
+   * Stored entries are viewed directly within the mapping, without copying. Compressed
+   * entries are decompressed on their first read and kept, so later reads are views, too.
+   *
+   * The index can be persisted to disk, keyed by the JAR's path, size, and modification
+   * time, so a JAR which hasn't changed doesn't need its central directory walked again. */
+  struct jar : gc
+  {
+    struct entry
+    {
+      /* Where the entry's local header starts. Its data comes right after that header, but
+       * the header's length is only known once we read it. */
+      usize header_offset{};
+      usize compressed_size{};
+      usize size{};
+      /* The zip compression method. Zero means the entry is stored as is. */
+      u16 method{};
+    };
+
+    jar() = delete;
+    jar(jar const &) = delete;
+    jar(jar &&) noexcept = delete;
+    ~jar();
+
+    /* Opens the JAR, or returns the one which is already open at this path. When an index
+     * dir is given, the index is read from there, if it's still valid, and written there
+     * otherwise. */
+    static jtl::string_result<jar *>
+    open(jtl::immutable_string const &path, jtl::immutable_string const &index_dir = "");
+
+    /* Where the index for the JAR at this path is kept, within the index dir. */
+    static jtl::immutable_string
+    index_file(jtl::immutable_string const &path, jtl::immutable_string const &index_dir);
+
+    bool contains(jtl::immutable_string const &name) const;
+
+    /* The returned view is valid for as long as the process runs. */
+    jtl::string_result<file_view> read(jtl::immutable_string const &name);
+
+    jtl::immutable_string path;
+    /* Keyed by the path within the JAR. Directories aren't included. */
+    native_unordered_map<jtl::immutable_string, entry> entries;
+
+  private:
+    jar(jtl::immutable_string const &path);
+
+    jtl::string_result<void> index_central_directory();
+    bool read_index(jtl::immutable_string const &index_path);
+    void write_index(jtl::immutable_string const &index_path) const;
+    void unmap();
+
+    int fd{ -1 };
+    char const *head{};
+    usize len{};
+    std::time_t modified_at{};
+
+    /* Guards everything below, which is only needed for compressed entries. */
+    std::mutex mutex;
+    std::unique_ptr<libzippp::ZipArchive> archive;
+    native_unordered_map<jtl::immutable_string, jtl::immutable_string> inflated;
+  };
+}
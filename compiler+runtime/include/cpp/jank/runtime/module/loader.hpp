@@ -60,15 +60,18 @@ namespace jank::runtime::module
   };
 
   /* When reading a file, we may find it on the filesystem or within a JAR. In the
-   * first case, we map it with `mmap`, but we can't do that for JAR files since
-   * we need to decompress them into memory. This `file_view` gives us one view
-   * into either type of file, with the same interface. */
+   * first case, we map it with `mmap`. Entries within JARs are viewed within the JAR's
+   * own mapping, or within the buffer they were decompressed into, both of which the JAR
+   * keeps around. This `file_view` gives us one view into any type of file, with the
+   * same interface. */
   struct file_view
   {
     file_view() = default;
     file_view(file_view const &) = delete;
     file_view(file_view &&) noexcept;
     file_view(int const f, char const * const h, usize const s);
+    /* A view of memory which is owned by someone else, so it's not unmapped. */
+    file_view(char const * const h, usize const s);
     file_view(jtl::immutable_string const &buff);
     ~file_view();
 
@@ -80,9 +83,10 @@ namespace jank::runtime::module
   private:
     /* In the case where we map a file, we track this information so we can read it and
      * later unmap it. */
-    int fd{};
+    int fd{ -1 };
     char const *head{};
     usize len{};
+    bool owns_head{};
 
     /* In the case where we're not mapping, such as when we read the file from a JAR,
      * we'll just have the data instead. Checking data.empty() is how we know which
@@ -140,6 +144,11 @@ namespace jank::runtime::module
 
     static jtl::string_result<file_view> read_file(jtl::immutable_string const &path);
 
+    /* Where the index for the directory at this canonical path is kept, within the index
+     * dir. */
+    static jtl::immutable_string directory_index_file(std::filesystem::path const &path,
+                                                      jtl::immutable_string const &index_dir);
+
     jtl::string_result<find_result> find(jtl::immutable_string const &module, origin const ori);
 
     bool is_loaded(jtl::immutable_string const &module);
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+#include <jank/runtime/object.hpp>
+
+namespace jank::runtime
+{
+  struct thread_binding_frame;
+}
+
+namespace jank::runtime::obj
+{
+  using agent_ref = oref<struct agent>;
+
+  enum class agent_error_mode : u8
+  {
+    continue_,
+    fail
+  };
+
+  enum class agent_executor : u8
+  {
+    /* The fixed size pool, for CPU bound actions. */
+    send,
+    /* The unbounded pool, for actions which may block. */
+    send_off
+  };
+
+  /* Holds whoever is waiting in await until the agents it's waiting on have gotten to
+   * its action. */
+  struct agent_latch : gc
+  {
+    agent_latch(usize count);
+
+    void count_down();
+    void wait();
+    bool wait_for(i64 timeout_ms);
+
+    usize count{};
+    std::mutex mutex;
+    std::condition_variable cv;
+  };
+
+  struct agent_action : gc
+  {
+    /* When there's a latch, this action just counts it down, rather than calling
+     * anything. */
+    object_ref fn{};
+    object_ref args{};
+    agent_latch *latch{};
+    agent_executor executor{};
+    thread_binding_frame const *bindings{};
+    agent_action *next{};
+  };
+
+  /* Asynchronous, uncoordinated state. Actions are sent to an agent and each one is run,
+   * one at a time and in the order it was sent, on one of the shared pools.
+   *
+   * Senders push onto a lock-free stack. Whoever bumps the pending count up from zero
+   * schedules the agent, after which it's owned by exactly one pool task at a time. That
+   * task moves the stack into the ready queue, in send order, runs one action, and then
+   * schedules the agent again if more are pending. So nothing on the consuming side needs
+   * a lock. */
+  struct agent : gc
+  {
+    static constexpr object_type obj_type{ object_type::agent };
+    static constexpr bool pointer_free{ false };
+
+    agent() = default;
+    agent(object_ref state);
+
+    /* behavior::object_like */
+    bool equal(object const &) const;
+    jtl::immutable_string to_string() const;
+    void to_string(util::string_builder &buff) const;
+    jtl::immutable_string to_code_string() const;
+    uhash to_hash() const;
+
+    /* behavior::derefable */
+    object_ref deref() const;
+
+    /* behavior::ref_like */
+    void set_validator(object_ref fn);
+    object_ref get_validator() const;
+    void add_watch(object_ref key, object_ref fn);
+    void remove_watch(object_ref key);
+
+    /* Queues the action. Throws if the agent has failed. Sends which happen from within
+     * an action are held until that action has finished. */
+    agent_ref dispatch(object_ref fn, object_ref args, agent_executor executor);
+
+    /* Blocks until every action which was sent to these agents, before this call, has
+     * been run. */
+    static void await(object_ref agents);
+    static bool await_for(i64 timeout_ms, object_ref agents);
+
+    /* Dispatches the sends held by the current action, if there is one. Returns how
+     * many were dispatched. */
+    static usize release_pending_sends();
+
+    /* Clears the agent's error and gives it a new state, so it can run actions again.
+     * Held actions are run, unless they're cleared. */
+    object_ref restart(object_ref new_state, bool clear_actions);
+
+    object_ref get_error() const;
+    usize queue_count() const;
+
+    void set_error_handler(object_ref fn);
+    object_ref get_error_handler() const;
+    void set_error_mode(agent_error_mode mode);
+    agent_error_mode get_error_mode() const;
+
+    /* Runs the next ready action. This is called from the pools. */
+    void execute();
+
+    object base{ obj_type };
+    std::atomic<object *> state{};
+    std::atomic<object *> validator{};
+    std::atomic<object *> watches{};
+    std::atomic<object *> error{};
+    std::atomic<object *> error_handler{};
+    std::atomic<agent_error_mode> error_mode{ agent_error_mode::fail };
+
+    /* Sends land here, newest first. */
+    std::atomic<agent_action *> incoming{};
+    /* The number of actions which have been sent but not yet run. */
+    std::atomic<usize> pending{};
+    /* Only touched by whoever is currently running this agent's actions. */
+    native_deque<agent_action *> ready;
+
+  private:
+    void enqueue(agent_action *action);
+    void schedule();
+    void validate(object_ref fn, object_ref new_state) const;
+    void notify_watches(object_ref old_state, object_ref new_state);
+  };
+
+  /* Shuts down both of the pools which back agents. */
+  void shutdown_agents();
+}
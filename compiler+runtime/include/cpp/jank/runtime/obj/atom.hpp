@@ -44,7 +44,19 @@ namespace jank::runtime::obj
 
     object_ref compare_and_set(object_ref old_val, object_ref new_val);
 
+    /* behavior::ref_like */
+    void set_validator(object_ref fn);
+    object_ref get_validator() const;
+    void add_watch(object_ref key, object_ref fn);
+    void remove_watch(object_ref key);
+
     object base{ obj_type };
     std::atomic<object *> val{};
+    std::atomic<object *> validator{};
+    std::atomic<object *> watches{};
+
+  private:
+    void validate(object_ref new_state) const;
+    void notify_watches(object_ref old_state, object_ref new_state);
   };
 }
@@ -17,6 +17,11 @@ namespace jank::runtime::obj
     character(jtl::immutable_string const &);
     character(char);
 
+    static void gc_layout(runtime::detail::gc_layout &layout)
+    {
+      layout.string(offsetof(character, data));
+    }
+
     /* behavior::object_like */
     bool equal(object const &) const;
     jtl::immutable_string to_string() const;
@@ -29,3 +34,9 @@ namespace jank::runtime::obj
     jtl::immutable_string data;
   };
 }
+
+namespace jank::runtime
+{
+  /* Every single byte character is boxed once, on first use, and shared from then on. */
+  obj::character_ref cached_character(char ch);
+}
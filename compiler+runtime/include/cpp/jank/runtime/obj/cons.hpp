@@ -12,6 +12,7 @@ namespace jank::runtime::obj
   {
     static constexpr object_type obj_type{ object_type::cons };
     static constexpr bool pointer_free{ false };
+    static constexpr bool thread_cached{ true };
     static constexpr bool is_sequential{ true };
 
     cons() = default;
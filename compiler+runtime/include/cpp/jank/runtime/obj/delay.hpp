@@ -24,10 +24,13 @@ namespace jank::runtime::obj
     /* behavior::derefable */
     object_ref deref();
 
+    /* behavior::pending */
+    bool is_realized() const;
+
     object base{ obj_type };
     object_ref val{};
     object_ref fn{};
     object_ref error{};
-    std::mutex mutex;
+    mutable std::mutex mutex;
   };
 }
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+
+#include <jank/runtime/object.hpp>
+
+namespace jank::runtime
+{
+  struct thread_binding_frame;
+}
+
+namespace jank::runtime::obj
+{
+  using future_ref = oref<struct future>;
+
+  enum class future_state : u8
+  {
+    pending,
+    running,
+    done,
+    failed,
+    cancelled
+  };
+
+  /* A value which is being computed on another thread. The fn is run on the default
+   * thread pool, with the thread bindings which were in place when the future was
+   * created. Derefing blocks until it's done. */
+  struct future : gc
+  {
+    static constexpr object_type obj_type{ object_type::future };
+    static constexpr bool pointer_free{ false };
+
+    future() = default;
+    future(object_ref fn, thread_binding_frame const *bindings);
+
+    /* Creates the future and submits it to the default thread pool. */
+    static future_ref create(object_ref fn);
+
+    /* behavior::object_like */
+    bool equal(object const &) const;
+    jtl::immutable_string to_string() const;
+    void to_string(util::string_builder &buff) const;
+    jtl::immutable_string to_code_string() const;
+    uhash to_hash() const;
+
+    /* behavior::derefable */
+    object_ref deref();
+
+    /* behavior::blocking_derefable */
+    object_ref deref(i64 timeout_ms, object_ref timeout_val);
+
+    /* behavior::pending */
+    bool is_realized() const;
+
+    /* Runs the fn on the calling thread, unless some thread has already started it. */
+    void run();
+
+    /* Only a future which hasn't started yet can be cancelled. Running fns aren't
+     * interrupted. */
+    bool cancel();
+    bool is_cancelled() const;
+
+    object base{ obj_type };
+    object_ref fn{};
+    thread_binding_frame const *bindings{};
+    object_ref val{};
+    object_ref error{};
+    std::exception_ptr native_error;
+    std::atomic<future_state> state{ future_state::pending };
+    mutable std::mutex mutex;
+    std::condition_variable cv;
+  };
+}
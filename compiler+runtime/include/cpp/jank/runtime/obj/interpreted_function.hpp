@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+
+#include <jank/runtime/object.hpp>
+#include <jank/runtime/behavior/callable.hpp>
+
+namespace jank::analyze::expr
+{
+  struct function;
+}
+
+namespace jank::evaluate
+{
+  struct environment;
+  struct function_tier;
+}
+
+namespace jank::runtime::obj
+{
+  using interpreted_function_ref = oref<struct interpreted_function>;
+
+  /* A fn which hasn't been JIT compiled. Its body is walked by the interpreter, within the
+   * environment the fn was created in. Once the fn has been called enough, across all of
+   * its instances, it's compiled and calls are forwarded to the compiled fn. */
+  struct interpreted_function
+    : gc
+    , behavior::callable
+  {
+    static constexpr object_type obj_type{ object_type::interpreted_function };
+    static constexpr bool pointer_free{ false };
+
+    interpreted_function() = default;
+    interpreted_function(analyze::expr::function *expr,
+                         evaluate::function_tier *tier,
+                         evaluate::environment *env,
+                         arity_flag_t arity_flags);
+
+    /* behavior::object_like */
+    bool equal(object const &) const;
+    jtl::immutable_string to_string();
+    void to_string(util::string_builder &buff);
+    jtl::immutable_string to_code_string();
+    uhash to_hash() const;
+
+    /* behavior::metadatable */
+    interpreted_function_ref with_meta(object_ref m);
+
+    /* behavior::callable */
+    object_ref call() final;
+    object_ref call(object_ref) final;
+    object_ref call(object_ref, object_ref) final;
+    object_ref call(object_ref, object_ref, object_ref) final;
+    object_ref call(object_ref, object_ref, object_ref, object_ref) final;
+    object_ref call(object_ref, object_ref, object_ref, object_ref, object_ref) final;
+    object_ref call(object_ref, object_ref, object_ref, object_ref, object_ref, object_ref) final;
+    object_ref
+      call(object_ref, object_ref, object_ref, object_ref, object_ref, object_ref, object_ref)
+        final;
+    object_ref call(object_ref,
+                    object_ref,
+                    object_ref,
+                    object_ref,
+                    object_ref,
+                    object_ref,
+                    object_ref,
+                    object_ref) final;
+    object_ref call(object_ref,
+                    object_ref,
+                    object_ref,
+                    object_ref,
+                    object_ref,
+                    object_ref,
+                    object_ref,
+                    object_ref,
+                    object_ref) final;
+    object_ref call(object_ref,
+                    object_ref,
+                    object_ref,
+                    object_ref,
+                    object_ref,
+                    object_ref,
+                    object_ref,
+                    object_ref,
+                    object_ref,
+                    object_ref) final;
+
+    arity_flag_t get_arity_flags() const final;
+    object_ref this_object_ref() final;
+
+    object base{ obj_type };
+    analyze::expr::function *expr{};
+    /* Shared by every instance of the same fn expression. */
+    evaluate::function_tier *tier{};
+    evaluate::environment *env{};
+    /* Set once this instance has been compiled. */
+    std::atomic<object *> compiled{};
+    jtl::option<object_ref> meta;
+    arity_flag_t arity_flags{};
+  };
+}
@@ -72,6 +72,9 @@ namespace jank::runtime::obj
     arity_flag_t get_arity_flags() const final;
     object_ref this_object_ref() final;
 
+    /* Whether there's a native fn for the arity with the specified number of params. */
+    bool has_arity(usize param_count) const;
+
     object base{ obj_type };
     object *(*arity_0)(){};
     object *(*arity_1)(object *){};
@@ -15,6 +15,7 @@ namespace jank::runtime::obj
   {
     static constexpr object_type obj_type{ object_type::lazy_sequence };
     static constexpr bool pointer_free{ false };
+    static constexpr bool thread_cached{ true };
     static constexpr bool is_sequential{ true };
 
     lazy_sequence() = default;
@@ -11,6 +11,7 @@ namespace jank::runtime::obj
   {
     static constexpr object_type obj_type{ object_type::native_array_sequence };
     static constexpr bool pointer_free{ false };
+    static constexpr bool thread_cached{ true };
     static constexpr bool is_sequential{ true };
 
     native_array_sequence() = delete;
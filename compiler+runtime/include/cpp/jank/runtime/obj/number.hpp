@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+
 #include <jank/runtime/object.hpp>
 
 namespace jank::runtime::obj
@@ -39,11 +41,17 @@ namespace jank::runtime::obj
   {
     static constexpr object_type obj_type{ object_type::integer };
     static constexpr bool pointer_free{ true };
+    static constexpr bool thread_cached{ true };
 
     integer() = default;
     integer(integer &&) noexcept = default;
     integer(integer const &) = default;
-    integer(i64 const d);
+
+    /* This is constexpr so that the small integer cache can be built at compile time. */
+    constexpr integer(i64 const d)
+      : data{ d }
+    {
+    }
 
     /* behavior::object_like */
     bool equal(object const &) const;
@@ -73,6 +81,7 @@ namespace jank::runtime::obj
   {
     static constexpr object_type obj_type{ object_type::real };
     static constexpr bool pointer_free{ true };
+    static constexpr bool thread_cached{ true };
 
     real() = default;
     real(real &&) noexcept = default;
@@ -107,4 +116,36 @@ namespace jank::runtime
   extern obj::boolean_ref jank_true;
   /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
   extern obj::boolean_ref jank_false;
+
+  /* Integers in this range are boxed once, up front, and make_box hands out those same
+   * boxes rather than allocating. Most integers in a typical program are small counters,
+   * indices, and lengths, so this saves a lot of garbage. It also means that two boxes
+   * of the same small integer may be identical, but nothing may rely on that. */
+  constexpr i64 integer_cache_min{ -128 };
+  constexpr i64 integer_cache_max{ 1023 };
+  constexpr usize integer_cache_size{ integer_cache_max - integer_cache_min + 1 };
+
+  constexpr bool is_integer_cached(i64 const i)
+  {
+    return integer_cache_min <= i && i <= integer_cache_max;
+  }
+}
+
+/* This has C linkage so that generated code can point directly into it, without needing
+ * a global ctor to box its integer constants. */
+extern "C"
+{
+  /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+  extern std::array<jank::runtime::obj::integer, jank::runtime::integer_cache_size>
+    jank_integer_cache;
+}
+
+namespace jank::runtime
+{
+  [[gnu::always_inline]]
+  inline obj::integer_ref cached_integer(i64 const i)
+  {
+    jank_debug_assert(is_integer_cached(i));
+    return &jank_integer_cache[static_cast<usize>(i - integer_cache_min)];
+  }
 }
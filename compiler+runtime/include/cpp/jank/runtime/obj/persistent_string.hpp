@@ -20,6 +20,12 @@ namespace jank::runtime::obj
     persistent_string(jtl::immutable_string const &d);
     persistent_string(jtl::immutable_string &&d);
 
+    /* Only the string's data pointer is scanned, never its bytes. */
+    static void gc_layout(runtime::detail::gc_layout &layout)
+    {
+      layout.string(offsetof(persistent_string, data));
+    }
+
     static persistent_string_ref empty()
     {
       static auto const ret(make_box<persistent_string>());
@@ -13,6 +13,7 @@ namespace jank::runtime::obj
   {
     static constexpr object_type obj_type{ object_type::persistent_vector };
     static constexpr bool pointer_free{ false };
+    static constexpr bool thread_cached{ true };
     static constexpr bool is_sequential{ true };
 
     using transient_type = transient_vector;
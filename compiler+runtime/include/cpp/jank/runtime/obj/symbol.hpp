@@ -4,6 +4,11 @@
 
 #include <jank/runtime/object.hpp>
 
+namespace jank::runtime::detail
+{
+  struct must_be_interned;
+}
+
 namespace jank::runtime::obj
 {
   using persistent_array_map_ref = oref<struct persistent_array_map>;
@@ -23,10 +28,21 @@ namespace jank::runtime::obj
     symbol(jtl::immutable_string &&ns, jtl::immutable_string &&n);
     symbol(object_ref meta, jtl::immutable_string const &ns, jtl::immutable_string const &n);
     symbol(object_ref ns, object_ref n);
+    symbol(runtime::detail::must_be_interned,
+           jtl::immutable_string const &ns,
+           jtl::immutable_string const &n);
 
     symbol &operator=(symbol const &) = default;
     symbol &operator=(symbol &&) = default;
 
+    static void gc_layout(runtime::detail::gc_layout &layout)
+    {
+      layout.string(offsetof(symbol, ns));
+      layout.string(offsetof(symbol, name));
+      layout.words(offsetof(symbol, meta), sizeof(meta));
+      layout.pointer(offsetof(symbol, canonical));
+    }
+
     /* behavior::object_like */
     bool equal(object const &) const;
     jtl::immutable_string to_string() const;
@@ -64,6 +80,10 @@ namespace jank::runtime::obj
 
     jtl::option<object_ref> meta;
     mutable uhash hash{};
+    /* The interned symbol with the same ns and name, if this symbol came from the symbol
+     * table, or is a copy of one which did. Two symbols with canonical forms are equal
+     * only if their canonical forms are the same object, so we needn't compare strings. */
+    symbol const *canonical{};
   };
 }
 
@@ -66,6 +66,7 @@ namespace jank::runtime
     native_function_wrapper,
     jit_function,
     jit_closure,
+    interpreted_function,
     multi_function,
 
     native_pointer_wrapper,
@@ -74,11 +75,14 @@ namespace jank::runtime
     volatile_,
     reduced,
     delay,
+    future,
+    agent,
     ns,
 
     var,
     var_thread_binding,
     var_unbound_root,
+    thread_binding_frame,
 
     tagged_literal,
   };
@@ -188,6 +192,8 @@ namespace jank::runtime
         return "jit_function";
       case object_type::jit_closure:
         return "jit_closure";
+      case object_type::interpreted_function:
+        return "interpreted_function";
       case object_type::multi_function:
         return "multi_function";
 
@@ -202,6 +208,10 @@ namespace jank::runtime
         return "reduced";
       case object_type::delay:
         return "delay";
+      case object_type::future:
+        return "future";
+      case object_type::agent:
+        return "agent";
       case object_type::ns:
         return "ns";
 
@@ -211,6 +221,8 @@ namespace jank::runtime
         return "var_thread_binding";
       case object_type::var_unbound_root:
         return "var_unbound_root";
+      case object_type::thread_binding_frame:
+        return "thread_binding_frame";
 
       case object_type::tagged_literal:
         return "tagged_literal";
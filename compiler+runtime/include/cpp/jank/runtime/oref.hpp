@@ -8,6 +8,9 @@
 #include <jtl/assert.hpp>
 
 #include <jank/runtime/object.hpp>
+#include <jank/runtime/detail/allocation_stats.hpp>
+#include <jank/runtime/detail/box_cache.hpp>
+#include <jank/runtime/detail/gc_layout.hpp>
 
 namespace jank::runtime
 {
@@ -427,8 +430,27 @@ namespace jank::runtime
   oref<T> make_box(Args &&...args)
   {
     static_assert(sizeof(oref<T>) == sizeof(T *));
+    detail::register_base_displacement<T>();
     oref<T> ret;
-    if constexpr(requires { T::pointer_free; })
+    if constexpr(detail::thread_cached<T> && detail::pointer_free<T>)
+    {
+      ret = new(detail::allocate_cached_pointer_free_box<sizeof(T)>())
+        T{ std::forward<Args>(args)... };
+    }
+    else if constexpr(detail::thread_cached<T>)
+    {
+      ret = new(detail::allocate_cached_box<sizeof(T)>()) T{ std::forward<Args>(args)... };
+    }
+    else if constexpr(requires(detail::gc_layout &layout) { T::gc_layout(layout); })
+    {
+      auto const mem(GC_malloc_explicitly_typed(sizeof(T), detail::gc_descriptor<T>()));
+      if(!mem)
+      {
+        throw std::runtime_error{ "unable to allocate box" };
+      }
+      ret = new(mem) T{ std::forward<Args>(args)... };
+    }
+    else if constexpr(requires { T::pointer_free; })
     {
       if constexpr(T::pointer_free)
       {
@@ -444,6 +466,7 @@ namespace jank::runtime
       ret = new(GC) T{ std::forward<Args>(args)... };
     }
 
+    detail::count_box_allocation(T::obj_type);
     return ret;
   }
 
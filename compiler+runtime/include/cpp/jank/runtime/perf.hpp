@@ -5,4 +5,14 @@
 namespace jank::runtime::perf
 {
   object_ref benchmark(object_ref opts, object_ref f);
+
+  /* A map of what the GC and make_box have done so far in this process. Cheap enough to
+   * poll, for metrics. */
+  object_ref gc_stats();
+  /* Records where one in every n boxes is made, on each thread. Zero stops sampling. */
+  object_ref sample_allocations(object_ref n);
+  /* A map of each sampled allocation site to how many samples it has. This is slow, since
+   * each sample needs to be symbolized. */
+  object_ref allocation_sites();
+  object_ref clear_allocation_sites();
 }
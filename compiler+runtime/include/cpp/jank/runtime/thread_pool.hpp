@@ -0,0 +1,102 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include <jtl/option.hpp>
+
+#include <jank/runtime/object.hpp>
+
+namespace jank::runtime
+{
+  /* A fixed size, work stealing pool of threads. Each worker has its own deque of tasks.
+   * Workers push and pop at the back of their own deque, so nested work stays hot in
+   * cache, and idle workers steal from the front of the others. Tasks submitted from
+   * outside of the pool are spread across the workers round robin.
+   *
+   * Every worker is registered with the GC, so tasks are free to allocate. Tasks are
+   * just a fn pointer and an object, rather than a std::function, so that everything
+   * queued is visible to the GC. */
+  struct thread_pool : gc
+  {
+    using task_fn = void (*)(object_ref);
+
+    struct task
+    {
+      task_fn fn{};
+      object_ref arg;
+    };
+
+    struct worker : gc
+    {
+      std::mutex mutex;
+      native_deque<task> tasks;
+    };
+
+    thread_pool() = delete;
+    thread_pool(usize thread_count);
+
+    void submit(task_fn fn, object_ref arg);
+
+    /* Runs every task which is already queued and then joins all of the workers. Nothing
+     * can be submitted afterward. */
+    void shutdown();
+
+    usize thread_count() const;
+
+    /* Whether or not the calling thread is one of this pool's workers. */
+    bool is_worker_thread() const;
+
+  private:
+    void work(usize index);
+    jtl::option<task> next_task(usize index);
+
+    native_vector<worker *> workers;
+    native_vector<std::thread> threads;
+    std::atomic<usize> queued{};
+    std::atomic<usize> next_worker{};
+    std::atomic_bool stopping{};
+    std::mutex sleep_mutex;
+    std::condition_variable sleep_cv;
+  };
+
+  /* A pool which starts a new thread whenever a task is submitted and every existing
+   * thread is busy. Threads which sit idle for a while exit. This is for tasks which may
+   * block, like IO, where a fixed pool could be starved. There's a single queue, since
+   * there's nothing to steal when every task gets a thread. */
+  struct cached_thread_pool : gc
+  {
+    using task_fn = thread_pool::task_fn;
+    using task = thread_pool::task;
+
+    cached_thread_pool();
+
+    void submit(task_fn fn, object_ref arg);
+
+    /* Runs every task which is already queued and then waits for every thread to exit.
+     * Nothing can be submitted afterward. */
+    void shutdown();
+
+    usize thread_count() const;
+
+  private:
+    void work();
+
+    native_deque<task> tasks;
+    usize threads{};
+    usize idle_threads{};
+    bool stopping{};
+    mutable std::mutex mutex;
+    std::condition_variable task_cv;
+    std::condition_variable exit_cv;
+  };
+
+  /* The shared pool, with one worker per hardware thread, which futures, pmap, and agent
+   * sends run on. It's created on first use and lives until the process exits. */
+  thread_pool &default_thread_pool();
+
+  /* The shared, unbounded pool, which agent send-offs run on. */
+  cached_thread_pool &default_cached_thread_pool();
+}
@@ -1,8 +1,8 @@
 #pragma once
 
 #include <functional>
-
-#include <folly/Synchronized.h>
+#include <atomic>
+#include <mutex>
 
 #include <jtl/result.hpp>
 #include <jank/runtime/object.hpp>
@@ -14,6 +14,7 @@ namespace jank::runtime
   using var_ref = oref<struct var>;
   using var_thread_binding_ref = oref<struct var_thread_binding>;
   using var_unbound_root_ref = oref<struct var_unbound_root>;
+  using thread_binding_frame_ref = oref<struct thread_binding_frame>;
 
   namespace obj
   {
@@ -32,7 +33,7 @@ namespace jank::runtime
         obj::symbol_ref const &name,
         object_ref const root,
         bool dynamic,
-        bool thread_bound);
+        u32 binding_slot);
 
     /* behavior::object_like */
     bool equal(object const &) const;
@@ -59,6 +60,8 @@ namespace jank::runtime
     var_ref set_dynamic(bool dyn);
 
     var_thread_binding_ref get_thread_binding() const;
+    /* Gives this var a binding slot, if it doesn't have one yet. */
+    u32 get_binding_slot();
 
     /* behavior::derefable */
     object_ref deref() const;
@@ -73,13 +76,27 @@ namespace jank::runtime
     obj::symbol_ref name{};
     jtl::option<object_ref> meta;
     mutable uhash hash{};
+    /* The cache key of the top-level form which last defined this var, if the JIT object
+     * cache is enabled. Forms which refer to this var are keyed on it, too. */
+    jtl::immutable_string form_key;
+    /* The vars which that form referred to. Keys are built by following these, so that
+     * redefining a var changes the key of every form which depends on it, transitively,
+     * even if the vars in between haven't been redefined. */
+    native_vector<var_ref> form_deps;
 
   private:
-    folly::Synchronized<object_ref> root;
+    /* Every deref of a var goes through here, so the root is read without any lock. Writers
+     * serialize on the mutex, so that alter_root sees a stable root while applying its fn,
+     * and then publish the new root with a release store. */
+    std::atomic<object *> root;
+    std::mutex root_mutex;
 
   public:
     std::atomic_bool dynamic{ false };
-    std::atomic_bool thread_bound{ false };
+    /* An index into each thread's binding slots, which is given to a var the first time it's
+     * bound and never changes. Zero means it has never been bound, on any thread, so a deref
+     * needn't look for a binding at all. */
+    std::atomic<u32> binding_slot{};
   };
 
   struct var_thread_binding : gc
@@ -97,13 +114,60 @@ namespace jank::runtime
     uhash to_hash() const;
 
     object base{ obj_type };
-    object_ref value{};
+    /* Only the binding thread sets this, but once the binding is conveyed, other threads
+     * deref it at the same time. Like var roots, it's published with a release store. */
+    std::atomic<object *> value{};
     std::thread::id thread_id;
   };
 
-  struct thread_binding_frame
+  /* The bindings made by one push. Frames never change once they're pushed and each links to
+   * the frame it was pushed over, so a thread's bindings can be captured just by keeping its
+   * innermost frame. That's how bindings are conveyed to futures and agents. Frames are
+   * objects so that jank code can hold a captured one, with its type intact. */
+  struct thread_binding_frame : gc
+  {
+    static constexpr object_type obj_type{ object_type::thread_binding_frame };
+    static constexpr bool pointer_free{ false };
+
+    struct binding
+    {
+      var_ref var;
+      u32 slot{};
+      var_thread_binding_ref value;
+    };
+
+    thread_binding_frame(thread_binding_frame const *parent);
+
+    /* behavior::object_like */
+    bool equal(object const &) const;
+    jtl::immutable_string to_string() const;
+    void to_string(util::string_builder &buff) const;
+    jtl::immutable_string to_code_string() const;
+    uhash to_hash() const;
+
+    /* Every binding in effect, as a map of vars to their var_thread_binding. It's only
+     * needed by get-thread-bindings, so it's built on demand and kept. */
+    obj::persistent_hash_map_ref bindings() const;
+
+    object base{ obj_type };
+    thread_binding_frame const *parent{};
+    native_vector<binding> pushed;
+    mutable std::atomic<obj::persistent_hash_map *> cached_bindings{};
+  };
+
+  /* One thread's bindings, within one context. The slots hold the innermost binding of each
+   * var, indexed by its binding slot, so a deref doesn't need to look anything up. */
+  struct thread_bindings
   {
-    obj::persistent_hash_map_ref bindings{};
+    /* The innermost frame. This is null when nothing is bound. */
+    thread_binding_frame const *frame{};
+    native_vector<var_thread_binding_ref> slots;
+
+    /* Each slot changed by a push, with the binding it had before, so a pop only needs to
+     * put those back. Each push marks where its slots start, along with the frame it was
+     * pushed over. */
+    native_vector<std::pair<u32, var_thread_binding_ref>> shadowed;
+    native_vector<std::pair<thread_binding_frame const *, usize>> pushes;
   };
 
   struct var_unbound_root : gc
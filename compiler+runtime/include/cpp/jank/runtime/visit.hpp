@@ -38,6 +38,7 @@
 #include <jank/runtime/obj/ratio.hpp>
 #include <jank/runtime/obj/jit_function.hpp>
 #include <jank/runtime/obj/jit_closure.hpp>
+#include <jank/runtime/obj/interpreted_function.hpp>
 #include <jank/runtime/obj/multi_function.hpp>
 #include <jank/runtime/obj/native_function_wrapper.hpp>
 #include <jank/runtime/obj/native_pointer_wrapper.hpp>
@@ -50,6 +51,8 @@
 #include <jank/runtime/obj/atom.hpp>
 #include <jank/runtime/obj/volatile.hpp>
 #include <jank/runtime/obj/delay.hpp>
+#include <jank/runtime/obj/future.hpp>
+#include <jank/runtime/obj/agent.hpp>
 #include <jank/runtime/obj/reduced.hpp>
 #include <jank/runtime/obj/tagged_literal.hpp>
 #include <jank/runtime/ns.hpp>
@@ -312,6 +315,12 @@ namespace jank::runtime
           return fn(expect_object<obj::jit_closure>(erased), std::forward<Args>(args)...);
         }
         break;
+      case object_type::interpreted_function:
+        {
+          return fn(expect_object<obj::interpreted_function>(erased),
+                    std::forward<Args>(args)...);
+        }
+        break;
       case object_type::multi_function:
         {
           return fn(expect_object<obj::multi_function>(erased), std::forward<Args>(args)...);
@@ -337,6 +346,16 @@ namespace jank::runtime
           return fn(expect_object<obj::delay>(erased), std::forward<Args>(args)...);
         }
         break;
+      case object_type::future:
+        {
+          return fn(expect_object<obj::future>(erased), std::forward<Args>(args)...);
+        }
+        break;
+      case object_type::agent:
+        {
+          return fn(expect_object<obj::agent>(erased), std::forward<Args>(args)...);
+        }
+        break;
       case object_type::ns:
         {
           return fn(expect_object<ns>(erased), std::forward<Args>(args)...);
@@ -357,6 +376,11 @@ namespace jank::runtime
           return fn(expect_object<var_unbound_root>(erased), std::forward<Args>(args)...);
         }
         break;
+      case object_type::thread_binding_frame:
+        {
+          return fn(expect_object<thread_binding_frame>(erased), std::forward<Args>(args)...);
+        }
+        break;
       case object_type::tagged_literal:
         {
           return fn(expect_object<obj::tagged_literal>(erased), std::forward<Args>(args)...);
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include <jtl/primitive.hpp>
+
+namespace jank::util
+{
+  /* A bump allocator for short lived scratch data, like the reader's intermediate state.
+   * Allocating is just moving a pointer and freeing one thing does nothing; everything is
+   * released in bulk, either all at once or back to some earlier mark.
+   *
+   * The chunks are scanned by the GC, but never collected by it, so scratch data can hold
+   * onto GC objects without them being collected from under it. */
+  struct arena
+  {
+    struct mark
+    {
+      usize chunk{};
+      usize used{};
+    };
+
+    struct stats
+    {
+      /* Everything which has been allocated, including what's since been released. */
+      usize allocations{};
+      usize allocated_bytes{};
+      /* What the chunks take up right now. */
+      usize reserved_bytes{};
+    };
+
+    /* Rewinds the arena back to where it was when the scope was entered. These need to be
+     * nested, like the stack, since everything allocated after the mark goes away. */
+    struct scope
+    {
+      scope(arena &a);
+      scope(scope const &) = delete;
+      scope(scope &&) noexcept = delete;
+      ~scope();
+
+      arena &a;
+      struct mark m;
+    };
+
+    static constexpr usize default_chunk_size{ 64 * 1024 };
+
+    arena(usize chunk_size = default_chunk_size);
+    arena(arena const &) = delete;
+    arena(arena &&) noexcept = delete;
+    ~arena();
+
+    void *allocate(usize size, usize alignment);
+    struct mark current_mark() const;
+    void rewind(struct mark const &m);
+    /* Releases everything, keeping only the first chunk around for reuse. */
+    void release();
+
+    void clear_since(struct mark const &m);
+
+    struct chunk
+    {
+      char *data{};
+      usize size{};
+    };
+
+    usize chunk_size{};
+    std::vector<chunk> chunks;
+    /* The chunk being bumped and how much of it is used. */
+    usize current{};
+    usize used{};
+    struct stats stats;
+  };
+
+  template <typename T>
+  struct arena_allocator
+  {
+    using value_type = T;
+
+    arena_allocator(arena &a) noexcept
+      : a{ &a }
+    {
+    }
+
+    template <typename U>
+    arena_allocator(arena_allocator<U> const &rhs) noexcept
+      : a{ rhs.a }
+    {
+    }
+
+    T *allocate(usize const n)
+    {
+      return static_cast<T *>(a->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *, usize) noexcept
+    {
+    }
+
+    template <typename U>
+    bool operator==(arena_allocator<U> const &rhs) const noexcept
+    {
+      return a == rhs.a;
+    }
+
+    arena *a{};
+  };
+
+  template <typename T>
+  using arena_vector = std::vector<T, arena_allocator<T>>;
+  template <typename K, typename V, typename Hash = std::hash<K>, typename Pred = std::equal_to<K>>
+  using arena_unordered_map
+    = std::unordered_map<K, V, Hash, Pred, arena_allocator<std::pair<K const, V>>>;
+}
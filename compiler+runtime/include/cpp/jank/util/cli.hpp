@@ -21,6 +21,11 @@ namespace jank::util::cli
     bool profiler_enabled{};
     native_transient_string profiler_file{ "jank.profile" };
     bool gc_incremental{};
+    bool interpret{ true };
+    i64 jit_threshold{ 200 };
+    bool background_jit{ true };
+    bool intern_symbols{ true };
+    bool jit_cache{};
 
     /* Native dependencies. */
     native_vector<jtl::immutable_string> include_dirs;
@@ -30,6 +35,8 @@ namespace jank::util::cli
 
     /* Compilation. */
     i64 optimization_level{};
+    /* How many threads write object files while compiling. Zero means one per core. */
+    i64 jobs{};
 
     /* Run command. */
     native_transient_string target_file;
@@ -20,6 +20,13 @@ namespace jank::util
   void print_exception(runtime::object_ref const e);
   void print_exception(jtl::immutable_string const &e);
   void print_exception(error_ref e);
+
+  /* Just the message of each exception type, without a stack trace, for when the error
+   * needs to be passed along rather than printed. */
+  jtl::immutable_string exception_message(std::exception const &e);
+  jtl::immutable_string exception_message(runtime::object_ref const e);
+  jtl::immutable_string exception_message(jtl::immutable_string const &e);
+  jtl::immutable_string exception_message(error_ref e);
 }
 
 /* We use cpptrace to wrap our try/catch blocks so that we
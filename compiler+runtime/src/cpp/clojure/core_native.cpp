@@ -114,10 +114,16 @@ namespace clojure::core_native
     return make_box<obj::delay>(fn);
   }
 
+  static i64 available_processors()
+  {
+    return std::max(1u, std::thread::hardware_concurrency());
+  }
+
   static object_ref is_fn(object_ref const o)
   {
     return make_box(o->type == object_type::native_function_wrapper
-                    || o->type == object_type::jit_function);
+                    || o->type == object_type::jit_function
+                    || o->type == object_type::interpreted_function);
   }
 
   static object_ref is_multi_fn(object_ref const o)
@@ -382,10 +388,14 @@ extern "C" jank_object_ref jank_load_clojure_core_native()
   intern_fn("dissoc-in-place!", &dissoc_in_place);
   intern_fn("pop-in-place!", &pop_in_place);
   intern_fn("disj-in-place!", &disj_in_place);
-  intern_fn("deref", &deref);
+  intern_fn("deref", static_cast<object_ref (*)(object_ref)>(&deref));
+  intern_fn("deref-timeout",
+            static_cast<object_ref (*)(object_ref, object_ref, object_ref)>(&deref));
+  intern_fn("realized?", &is_realized);
   intern_fn("reduced", &reduced);
   intern_fn("reduced?", &is_reduced);
   intern_fn("reduce", &reduce);
+  intern_fn("fold", &fold);
   intern_fn("peek", &peek);
   intern_fn("pop", &pop);
   intern_fn("atom", &atom);
@@ -467,6 +477,8 @@ extern "C" jank_object_ref jank_load_clojure_core_native()
   intern_fn("push-thread-bindings", &push_thread_bindings);
   intern_fn("pop-thread-bindings", &pop_thread_bindings);
   intern_fn("get-thread-bindings", &get_thread_bindings);
+  intern_fn("capture-thread-bindings", &capture_thread_bindings);
+  intern_fn("call-with-thread-bindings", &call_with_thread_bindings);
   intern_fn("keyword?", &is_keyword);
   intern_fn("simple-keyword?", &is_simple_keyword);
   intern_fn("qualified-keyword?", &is_qualified_keyword);
@@ -476,6 +488,29 @@ extern "C" jank_object_ref jank_load_clojure_core_native()
   intern_fn("iterate", &iterate);
   intern_fn("delay*", &core_native::delay);
   intern_fn("force", &force);
+  intern_fn("future-call", &future_call);
+  intern_fn("future?", &is_future);
+  intern_fn("future-done?", &is_future_done);
+  intern_fn("future-cancel", &future_cancel);
+  intern_fn("future-cancelled?", &is_future_cancelled);
+  intern_fn("available-processors", &core_native::available_processors);
+  intern_fn("agent*", &agent);
+  intern_fn("send*", &agent_send);
+  intern_fn("send-off*", &agent_send_off);
+  intern_fn("await*", &agent_await);
+  intern_fn("await-for*", &agent_await_for);
+  intern_fn("release-pending-sends", &release_pending_sends);
+  intern_fn("agent-error", &agent_error);
+  intern_fn("restart-agent*", &restart_agent);
+  intern_fn("set-error-handler!", &set_error_handler);
+  intern_fn("error-handler", &error_handler);
+  intern_fn("set-error-mode!", &set_error_mode);
+  intern_fn("error-mode", &error_mode);
+  intern_fn("shutdown-agents", &shutdown_agents);
+  intern_fn("set-validator!", &set_validator);
+  intern_fn("get-validator", &get_validator);
+  intern_fn("add-watch", &add_watch);
+  intern_fn("remove-watch", &remove_watch);
   intern_fn("ifn?", &is_callable);
   intern_fn("fn?", &core_native::is_fn);
   intern_fn("multi-fn?", &core_native::is_multi_fn);
@@ -0,0 +1,86 @@
+#include <clojure/edn_native.hpp>
+#include <jank/read/stream.hpp>
+#include <jank/runtime/core.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/obj/keyword.hpp>
+#include <jank/runtime/obj/native_function_wrapper.hpp>
+#include <jank/runtime/obj/native_pointer_wrapper.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/runtime/convert/function.hpp>
+#include <jank/runtime/rtti.hpp>
+#include <jank/util/fmt.hpp>
+
+namespace clojure::edn_native
+{
+  using namespace jank;
+  using namespace jank::runtime;
+
+  /* Readers are read::streams, wrapped up so they can be passed around in jank. */
+  static read::stream *expect_stream(object_ref const reader)
+  {
+    return try_object<obj::native_pointer_wrapper>(reader)->as<read::stream>();
+  }
+
+  static object_ref reader(object_ref const source)
+  {
+    if(source->type == object_type::integer)
+    {
+      auto const fd(static_cast<int>(to_int(source)));
+      return make_box<obj::native_pointer_wrapper>(new(GC) read::stream{ fd, false });
+    }
+
+    auto const opened(read::stream::open(runtime::to_string(source)));
+    if(opened.is_err())
+    {
+      throw std::runtime_error{ opened.expect_err().c_str() };
+    }
+    return make_box<obj::native_pointer_wrapper>(opened.expect_ok());
+  }
+
+  static object_ref read(object_ref const reader, object_ref const eof_error, object_ref const eof)
+  {
+    auto const res(expect_stream(reader)->next());
+    if(res.is_err())
+    {
+      throw res.expect_err();
+    }
+    if(res.expect_ok().is_none())
+    {
+      if(truthy(eof_error))
+      {
+        throw std::runtime_error{ "EOF while reading" };
+      }
+      return eof;
+    }
+    return res.expect_ok().unwrap().ptr;
+  }
+
+  static object_ref close(object_ref const reader)
+  {
+    expect_stream(reader)->close();
+    return jank_nil;
+  }
+}
+
+extern "C" jank_object_ref jank_load_clojure_edn_native()
+{
+  using namespace jank;
+  using namespace jank::runtime;
+  using namespace clojure;
+
+  auto const ns(__rt_ctx->intern_ns("clojure.edn-native"));
+
+  auto const intern_fn([=](jtl::immutable_string const &name, auto const fn) {
+    ns->intern_var(name)->bind_root(
+      make_box<obj::native_function_wrapper>(convert_function(fn))
+        ->with_meta(obj::persistent_hash_map::create_unique(std::make_pair(
+          __rt_ctx->intern_keyword("name").expect_ok(),
+          make_box(obj::symbol{ __rt_ctx->current_ns()->to_string(), name }.to_string())))));
+  });
+
+  intern_fn("reader", &edn_native::reader);
+  intern_fn("read", &edn_native::read);
+  intern_fn("close", &edn_native::close);
+
+  return jank_nil.erase();
+}
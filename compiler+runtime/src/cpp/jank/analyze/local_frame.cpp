@@ -37,7 +37,9 @@ namespace jank::analyze
       make_box("has_boxed_usage"),
       make_box(has_boxed_usage),
       make_box("has_unboxed_usage"),
-      make_box(has_unboxed_usage));
+      make_box(has_unboxed_usage),
+      make_box("unboxed_type"),
+      make_box(primitive_type_str(unboxed_type)));
   }
 
   local_frame::local_frame(frame_type const &type,
@@ -16,6 +16,7 @@
 #include <jank/runtime/core/seq.hpp>
 #include <jank/analyze/processor.hpp>
 #include <jank/analyze/step/force_boxed.hpp>
+#include <jank/analyze/step/infer_primitive_types.hpp>
 #include <jank/evaluate.hpp>
 #include <jtl/result.hpp>
 #include <jank/util/scope_exit.hpp>
@@ -561,7 +562,12 @@ namespace jank::analyze
         }
       }
 
-      frame->locals.emplace(sym, local_binding{ sym, none, current_frame });
+      auto const local(frame->locals.emplace(sym, local_binding{ sym, none, current_frame }));
+      /* The variadic param is always a seq, so a hint on it can't make it a primitive. */
+      if(!is_variadic)
+      {
+        local.first->second.unboxed_type = step::hinted_primitive_type(sym);
+      }
       param_symbols.emplace_back(sym);
     }
 
@@ -955,9 +961,21 @@ namespace jank::analyze
         return res.expect_err_move();
       }
       auto it(ret->pairs.emplace_back(sym, res.expect_ok_move()));
-      ret->frame->locals.emplace(
+      auto const local(ret->frame->locals.emplace(
         sym,
-        local_binding{ sym, it.second, current_frame, it.second->needs_box });
+        local_binding{ sym, it.second, current_frame, it.second->needs_box }));
+      if(local.second)
+      {
+        local.first->second.unboxed_type = step::hinted_primitive_type(sym);
+      }
+      else
+      {
+        /* The same name is bound more than once in this let, but all references share the
+         * first binding. Since they may see either value, we can't type it by either. */
+        local.first->second.value_expr = none;
+        local.first->second.unboxed_type = primitive_type::none;
+        step::invalidate_primitive_types();
+      }
     }
 
     usize const form_count{ o->count() - 2 };
@@ -1222,7 +1240,20 @@ namespace jank::analyze
                                                            bindings_obj,
                                                            call));
 
-    return analyze_let(let, current_frame, position, fn_ctx, true);
+    auto res(analyze_let(let, current_frame, position, fn_ctx, true));
+    if(res.is_err())
+    {
+      return res;
+    }
+
+    /* Now that the whole loop body has been analyzed, we know every recur into it, so we
+     * can figure out which loop params can stay unboxed. */
+    auto const let_expr(llvm::cast<expr::let>(res.expect_ok().data));
+    auto const loop_call(llvm::cast<expr::call>(let_expr->body->values.back().data));
+    auto const loop_fn(llvm::cast<expr::function>(loop_call->source_expr.data));
+    step::infer_loop_primitive_types(loop_fn->arities[0], loop_call->arg_exprs);
+
+    return res;
   }
 
   processor::expression_result
@@ -1766,6 +1797,40 @@ namespace jank::analyze
       o);
   }
 
+  /* The arity flags codegen can guard a direct call on, if the fn has a fixed arity for
+   * this many args. An interpreted fn is still compiled once it's hot and its compiled fn
+   * has the same arity flags, so codegen's guard looks through it at runtime. */
+  static jtl::option<u8> direct_call_arity_flags(object_ref const root, u8 const arg_count)
+  {
+    if(root->type == runtime::object_type::jit_function)
+    {
+      auto const typed_root(runtime::expect_object<runtime::obj::jit_function>(root));
+      auto const arity_flags(typed_root->get_arity_flags());
+      if(typed_root->has_arity(arg_count)
+         && runtime::behavior::callable::is_fixed_arity_call(arity_flags, arg_count))
+      {
+        return arity_flags;
+      }
+    }
+    else if(root->type == runtime::object_type::interpreted_function)
+    {
+      auto const typed_root(runtime::expect_object<runtime::obj::interpreted_function>(root));
+      auto const arity_flags(typed_root->get_arity_flags());
+      if(!runtime::behavior::callable::is_fixed_arity_call(arity_flags, arg_count))
+      {
+        return none;
+      }
+      for(auto const &arity : typed_root->expr->arities)
+      {
+        if(!arity.fn_ctx->is_variadic && arity.params.size() == arg_count)
+        {
+          return arity_flags;
+        }
+      }
+    }
+    return none;
+  }
+
   processor::expression_result
   processor::analyze_call(runtime::obj::persistent_list_ref const o,
                           local_frame_ptr const current_frame,
@@ -1945,12 +2010,24 @@ namespace jank::analyze
     }
     else
     {
-      return jtl::make_ref<expr::call>(position,
-                                       current_frame,
-                                       needs_ret_box,
-                                       source.as_ref(),
-                                       o,
-                                       std::move(arg_exprs));
+      auto const ret(jtl::make_ref<expr::call>(position,
+                                               current_frame,
+                                               needs_ret_box,
+                                               source.as_ref(),
+                                               o,
+                                               std::move(arg_exprs)));
+
+      /* If the var currently holds a plain fn with a fixed arity for this call, we can let
+       * codegen skip the dynamic dispatch. Dynamic vars are left alone, since their value
+       * depends on the bindings in place when the call happens. */
+      auto const var_deref(llvm::dyn_cast<expr::var_deref>(source.data));
+      if(var_deref && arg_count <= runtime::max_params && !var_deref->var->dynamic.load())
+      {
+        ret->direct_call_arity_flags
+          = direct_call_arity_flags(var_deref->var->get_root(), static_cast<u8>(arg_count));
+      }
+
+      return ret;
     }
   }
 
@@ -0,0 +1,317 @@
+#include <atomic>
+
+#include <jank/analyze/step/infer_primitive_types.hpp>
+#include <jank/analyze/local_frame.hpp>
+#include <jank/analyze/rtti.hpp>
+#include <jank/analyze/visit.hpp>
+#include <jank/analyze/expr/primitive_literal.hpp>
+#include <jank/analyze/expr/var_deref.hpp>
+#include <jank/analyze/expr/local_reference.hpp>
+#include <jank/analyze/expr/recur.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core/seq.hpp>
+#include <jank/runtime/obj/symbol.hpp>
+
+namespace jank::analyze::step
+{
+  /* Starts at 1 so that a zeroed generation is never considered cached. */
+  static std::atomic<u64> generation{ 1 };
+
+  u64 primitive_type_generation()
+  {
+    return generation.load(std::memory_order_acquire);
+  }
+
+  void invalidate_primitive_types()
+  {
+    generation.fetch_add(1, std::memory_order_acq_rel);
+  }
+
+  primitive_op primitive_call_op(expr::call const &call)
+  {
+    auto const var_deref(llvm::dyn_cast<expr::var_deref>(call.source_expr.data));
+    if(!var_deref || var_deref->qualified_name->ns != "clojure.core")
+    {
+      return primitive_op::none;
+    }
+
+    auto const &name(var_deref->qualified_name->name);
+    switch(call.arg_exprs.size())
+    {
+      case 1:
+        if(name == "inc")
+        {
+          return primitive_op::inc;
+        }
+        if(name == "dec")
+        {
+          return primitive_op::dec;
+        }
+        if(name == "-")
+        {
+          return primitive_op::negate;
+        }
+        return primitive_op::none;
+      case 2:
+        if(name == "+")
+        {
+          return primitive_op::add;
+        }
+        if(name == "-")
+        {
+          return primitive_op::sub;
+        }
+        if(name == "*")
+        {
+          return primitive_op::mul;
+        }
+        if(name == "<")
+        {
+          return primitive_op::lt;
+        }
+        if(name == "<=")
+        {
+          return primitive_op::lte;
+        }
+        if(name == ">")
+        {
+          return primitive_op::gt;
+        }
+        if(name == ">=")
+        {
+          return primitive_op::gte;
+        }
+        if(name == "==")
+        {
+          return primitive_op::equiv;
+        }
+        return primitive_op::none;
+      default:
+        return primitive_op::none;
+    }
+  }
+
+  primitive_type hinted_primitive_type(runtime::obj::symbol_ref const sym)
+  {
+    if(sym->meta.is_none())
+    {
+      return primitive_type::none;
+    }
+
+    auto const tag(runtime::get(sym->meta.unwrap(),
+                                runtime::__rt_ctx->intern_keyword("tag").expect_ok()));
+    if(tag->type != runtime::object_type::symbol)
+    {
+      return primitive_type::none;
+    }
+
+    auto const tag_sym(runtime::expect_object<runtime::obj::symbol>(tag));
+    if(!tag_sym->ns.empty())
+    {
+      return primitive_type::none;
+    }
+    if(tag_sym->name == "long")
+    {
+      return primitive_type::i64;
+    }
+    if(tag_sym->name == "double")
+    {
+      return primitive_type::f64;
+    }
+    return primitive_type::none;
+  }
+
+  primitive_type local_primitive_type(local_binding const &binding)
+  {
+    if(binding.unboxed_type != primitive_type::none)
+    {
+      return binding.unboxed_type;
+    }
+
+    /* Only let bindings have a value expr which we can type them by. Params, without a
+     * hint, only get a type once loop inference has run. */
+    if(binding.value_expr.is_none())
+    {
+      return primitive_type::none;
+    }
+
+    auto const current(primitive_type_generation());
+    if(binding.inferred_generation != current)
+    {
+      auto const type(infer_primitive_type(binding.value_expr.unwrap()));
+      binding.inferred_type = is_numeric(type) ? type : primitive_type::none;
+      binding.inferred_generation = current;
+    }
+    return binding.inferred_type;
+  }
+
+  static primitive_type infer_call(expr::call const &call)
+  {
+    auto const op(primitive_call_op(call));
+    if(op == primitive_op::none)
+    {
+      return primitive_type::none;
+    }
+
+    bool has_f64{};
+    for(auto const &arg : call.arg_exprs)
+    {
+      auto const type(infer_primitive_type(arg));
+      if(!is_numeric(type))
+      {
+        return primitive_type::none;
+      }
+      has_f64 |= type == primitive_type::f64;
+    }
+
+    switch(op)
+    {
+      case primitive_op::lt:
+      case primitive_op::lte:
+      case primitive_op::gt:
+      case primitive_op::gte:
+      case primitive_op::equiv:
+        return primitive_type::boolean;
+      default:
+        return has_f64 ? primitive_type::f64 : primitive_type::i64;
+    }
+  }
+
+  primitive_type infer_primitive_type(expression_ref const e)
+  {
+    switch(e->kind)
+    {
+      case expression_kind::primitive_literal:
+        {
+          auto const data(llvm::cast<expr::primitive_literal>(e.data)->data);
+          if(data->type == runtime::object_type::integer)
+          {
+            return primitive_type::i64;
+          }
+          if(data->type == runtime::object_type::real)
+          {
+            return primitive_type::f64;
+          }
+          return primitive_type::none;
+        }
+      case expression_kind::local_reference:
+        return local_primitive_type(*llvm::cast<expr::local_reference>(e.data)->binding);
+      case expression_kind::call:
+        {
+          auto const &call(*llvm::cast<expr::call>(e.data));
+          auto const current(primitive_type_generation());
+          if(call.inferred_generation != current)
+          {
+            call.inferred_type = infer_call(call);
+            call.inferred_generation = current;
+          }
+          return call.inferred_type;
+        }
+      default:
+        return primitive_type::none;
+    }
+  }
+
+  /* recur is always in tail position, so we only need to walk tail positions to find
+   * every recur for this arity. Nested fns aren't in tail position, so their recurs
+   * aren't picked up. */
+  static void collect_recurs(expression_ref const e, native_vector<expr::recur_ref> &recurs)
+  {
+    visit_expr(
+      [&](auto const typed_expr) {
+        using T = typename decltype(typed_expr)::value_type;
+
+        if constexpr(std::same_as<T, expr::recur>)
+        {
+          recurs.emplace_back(typed_expr);
+        }
+        else if constexpr(std::same_as<T, expr::if_>)
+        {
+          collect_recurs(typed_expr->then, recurs);
+          if(typed_expr->else_.is_some())
+          {
+            collect_recurs(typed_expr->else_.unwrap(), recurs);
+          }
+        }
+        else if constexpr(std::same_as<T, expr::do_>)
+        {
+          if(!typed_expr->values.empty())
+          {
+            collect_recurs(typed_expr->values.back(), recurs);
+          }
+        }
+        else if constexpr(std::same_as<T, expr::let> || std::same_as<T, expr::letfn>)
+        {
+          collect_recurs(typed_expr->body, recurs);
+        }
+        else if constexpr(std::same_as<T, expr::case_>)
+        {
+          collect_recurs(typed_expr->default_expr, recurs);
+          for(auto const &branch : typed_expr->exprs)
+          {
+            collect_recurs(branch, recurs);
+          }
+        }
+      },
+      e);
+  }
+
+  void infer_loop_primitive_types(expr::function_arity const &arity,
+                                  native_vector<expression_ref> const &init_exprs)
+  {
+    if(arity.fn_ctx->is_variadic || init_exprs.size() != arity.params.size())
+    {
+      return;
+    }
+
+    /* Hinted params are left alone. Everything else starts out with the type of its
+     * initial value. */
+    native_vector<local_binding *> inferred(arity.params.size(), nullptr);
+    for(usize i{}; i < arity.params.size(); ++i)
+    {
+      auto const local(arity.frame->locals.find(arity.params[i]));
+      if(local == arity.frame->locals.end()
+         || local->second.unboxed_type != primitive_type::none)
+      {
+        continue;
+      }
+
+      auto const type(infer_primitive_type(init_exprs[i]));
+      if(is_numeric(type))
+      {
+        local->second.unboxed_type = type;
+        inferred[i] = &local->second;
+        invalidate_primitive_types();
+      }
+    }
+
+    native_vector<expr::recur_ref> recurs;
+    collect_recurs(arity.body, recurs);
+
+    /* Demoting one param can change the type of a recur arg for another param, so we
+     * iterate until nothing changes. Params only ever go to none, so this terminates. */
+    bool changed{ true };
+    while(changed)
+    {
+      changed = false;
+      for(auto const &recur : recurs)
+      {
+        for(usize i{}; i < inferred.size(); ++i)
+        {
+          auto const local(inferred[i]);
+          if(!local || local->unboxed_type == primitive_type::none)
+          {
+            continue;
+          }
+
+          if(infer_primitive_type(recur->arg_exprs[i]) != local->unboxed_type)
+          {
+            local->unboxed_type = primitive_type::none;
+            invalidate_primitive_types();
+            changed = true;
+          }
+        }
+      }
+    }
+  }
+}
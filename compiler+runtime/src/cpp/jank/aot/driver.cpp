@@ -0,0 +1,320 @@
+#include <algorithm>
+#include <thread>
+
+#include <jank/aot/driver.hpp>
+#include <jank/read/lex.hpp>
+#include <jank/read/parse.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core.hpp>
+#include <jank/runtime/core/seq.hpp>
+#include <jank/runtime/rtti.hpp>
+#include <jank/runtime/thread_pool.hpp>
+#include <jank/runtime/obj/native_pointer_wrapper.hpp>
+#include <jank/codegen/llvm_processor.hpp>
+#include <jank/profile/time.hpp>
+#include <jank/util/cli.hpp>
+#include <jank/util/scope_exit.hpp>
+#include <jank/util/try.hpp>
+#include <jank/util/fmt.hpp>
+
+namespace jank::aot
+{
+  using namespace jank::runtime;
+
+  struct emit_task
+  {
+    driver *d{};
+    std::unique_ptr<codegen::reusable_context> ctx;
+  };
+
+  enum class visit_state : u8
+  {
+    visiting,
+    visited
+  };
+
+  static bool is_keyword(object_ref const o, native_persistent_string_view const &name)
+  {
+    return o->type == object_type::keyword
+      && expect_object<obj::keyword>(o)->get_namespace().empty()
+      && expect_object<obj::keyword>(o)->get_name() == name;
+  }
+
+  /* Adds the lib named by a single lib spec, which is either a symbol or a vector starting
+   * with a symbol. Any prefix comes from an enclosing prefix list. */
+  static void add_lib(object_ref const spec,
+                      jtl::immutable_string const &prefix,
+                      native_vector<jtl::immutable_string> &deps)
+  {
+    object_ref lib{ spec };
+    if(spec->type == object_type::persistent_vector)
+    {
+      lib = first(spec);
+    }
+    if(lib->type != object_type::symbol)
+    {
+      return;
+    }
+
+    auto const &name(expect_object<obj::symbol>(lib)->to_string());
+    deps.emplace_back(prefix.empty() ? name : util::format("{}.{}", prefix, name));
+  }
+
+  /* Options like `:reload` are skipped, as are forms which don't look like an `ns` form at
+   * all, since loading the module will report those properly. */
+  native_vector<jtl::immutable_string> ns_form_deps(object_ref const form)
+  {
+    native_vector<jtl::immutable_string> deps;
+    if(form->type != object_type::persistent_list)
+    {
+      return deps;
+    }
+
+    auto const head(first(form));
+    if(head->type != object_type::symbol || expect_object<obj::symbol>(head)->name != "ns")
+    {
+      return deps;
+    }
+
+    for(auto clauses(next(next(form))); !clauses.is_nil(); clauses = next(clauses))
+    {
+      auto const clause(first(clauses));
+      if(clause->type != object_type::persistent_list)
+      {
+        continue;
+      }
+
+      auto const kind(first(clause));
+      if(!is_keyword(kind, "require") && !is_keyword(kind, "use"))
+      {
+        continue;
+      }
+
+      for(auto specs(next(clause)); !specs.is_nil(); specs = next(specs))
+      {
+        auto const spec(first(specs));
+        if(spec->type == object_type::persistent_list)
+        {
+          auto const prefix(first(spec));
+          if(prefix->type != object_type::symbol)
+          {
+            continue;
+          }
+          for(auto prefixed(next(spec)); !prefixed.is_nil(); prefixed = next(prefixed))
+          {
+            add_lib(first(prefixed), expect_object<obj::symbol>(prefix)->to_string(), deps);
+          }
+        }
+        else
+        {
+          add_lib(spec, "", deps);
+        }
+      }
+    }
+
+    return deps;
+  }
+
+  /* Reads just the first form of the module's source, which is where its `ns` form lives.
+   * Modules without a jank source, like native modules, or object files without their
+   * source, don't require anything we can know about up front. */
+  static jtl::string_result<native_vector<jtl::immutable_string>>
+  module_deps(jtl::immutable_string const &module_name)
+  {
+    auto const found(__rt_ctx->module_loader.find(module_name, module::origin::source));
+    if(found.is_err())
+    {
+      return ok(native_vector<jtl::immutable_string>{});
+    }
+
+    auto const &sources(found.expect_ok().sources);
+    auto const &source(sources.jank.is_some() ? sources.jank : sources.cljc);
+    if(source.is_none())
+    {
+      return ok(native_vector<jtl::immutable_string>{});
+    }
+
+    auto const &entry(source.unwrap());
+    auto const path(entry.archive_path.is_some()
+                      ? util::format("{}:{}", entry.archive_path.unwrap(), entry.path)
+                      : entry.path);
+    auto const file(module::loader::read_file(path));
+    if(file.is_err())
+    {
+      return err(
+        util::format("Unable to map file {} due to error: {}", path, file.expect_err()));
+    }
+
+    read::lex::processor l_prc{ file.expect_ok().view() };
+    read::parse::processor p_prc{ l_prc.begin(), l_prc.end() };
+    for(auto const &form : p_prc)
+    {
+      if(form.is_err())
+      {
+        return err(util::format("Unable to read the ns form of {}: {}",
+                                module_name,
+                                form.expect_err()->message));
+      }
+      if(form.expect_ok().is_none())
+      {
+        break;
+      }
+      return ok(ns_form_deps(form.expect_ok().unwrap().ptr));
+    }
+
+    return ok(native_vector<jtl::immutable_string>{});
+  }
+
+  static jtl::string_result<void>
+  visit_module(jtl::immutable_string const &module,
+               native_unordered_map<jtl::immutable_string, visit_state> &states,
+               native_vector<jtl::immutable_string> &order)
+  {
+    auto const found(states.find(module));
+    if(found != states.end())
+    {
+      if(found->second == visit_state::visiting)
+      {
+        return err(util::format("Cyclic module dependency on {}", module));
+      }
+      return ok();
+    }
+    states.emplace(module, visit_state::visiting);
+
+    auto const deps(module_deps(module));
+    if(deps.is_err())
+    {
+      return err(deps.expect_err());
+    }
+
+    for(auto const &dep : deps.expect_ok())
+    {
+      auto const res(visit_module(dep, states, order));
+      if(res.is_err())
+      {
+        return res;
+      }
+    }
+
+    __rt_ctx->module_dependencies.wlock()->insert_or_assign(module, deps.expect_ok());
+    states[module] = visit_state::visited;
+    order.emplace_back(module);
+    return ok();
+  }
+
+  static void run_emit(object_ref const arg)
+  {
+    std::unique_ptr<emit_task> const task{
+      expect_object<obj::native_pointer_wrapper>(arg)->as<emit_task>()
+    };
+    auto const &ctx(*task->ctx);
+
+    /* The driver waits for every emit to finish, so one which throws still needs to
+     * finish, with its error, or the driver would never stop waiting. */
+    JANK_TRY
+    {
+      task->d->finish_emit(__rt_ctx->write_module(ctx.module_name, ctx.module));
+    }
+    JANK_CATCH([&](auto const &e) {
+      task->d->finish_emit(err(util::format("Unable to write module {}: {}",
+                                            ctx.module_name,
+                                            util::exception_message(e))));
+    })
+    catch(...)
+    {
+      task->d->finish_emit(err(util::format("Unable to write module {}", ctx.module_name)));
+    }
+  }
+
+  driver::driver(util::cli::options const &opts)
+    : jobs{ opts.jobs > 0 ? static_cast<usize>(opts.jobs)
+                          : std::max(std::thread::hardware_concurrency(), 1u) }
+    , pool{ new(GC) thread_pool{ jobs } }
+  {
+  }
+
+  driver::~driver()
+  {
+    pool->shutdown();
+  }
+
+  jtl::string_result<void> driver::build_graph(jtl::immutable_string const &module)
+  {
+    profile::timer const timer{ util::format("module graph {}", module) };
+    native_unordered_map<jtl::immutable_string, visit_state> states;
+    for(auto const &it : order)
+    {
+      states.emplace(it, visit_state::visited);
+    }
+    return visit_module(module, states, order);
+  }
+
+  jtl::string_result<void> driver::compile(jtl::immutable_string const &module_name)
+  {
+    auto const graph_res(build_graph(module_name));
+    if(graph_res.is_err())
+    {
+      return graph_res;
+    }
+
+    __rt_ctx->compile_driver = this;
+    util::scope_exit const reset{ []() { __rt_ctx->compile_driver = nullptr; } };
+    context::binding_scope const preserve{ *__rt_ctx,
+                                           obj::persistent_hash_map::create_unique(
+                                             std::make_pair(__rt_ctx->compile_files_var,
+                                                            jank_true)) };
+
+    /* Everything a module requires comes before it, so each load only loads that module.
+     * Anything the graph missed, like a require outside of the ns form, is just loaded
+     * along with the module which requires it. */
+    for(auto const &it : order)
+    {
+      if(__rt_ctx->module_loader.is_loaded(it))
+      {
+        continue;
+      }
+
+      auto const res(__rt_ctx->load_module(util::format("/{}", it), module::origin::latest));
+      if(res.is_err())
+      {
+        /* The pool still has our IR, so it needs to finish before we can return. */
+        static_cast<void>(await_emitted());
+        return res;
+      }
+    }
+
+    return await_emitted();
+  }
+
+  void driver::emit(std::unique_ptr<codegen::reusable_context> ctx)
+  {
+    {
+      std::lock_guard<std::mutex> const lock{ mutex };
+      ++pending;
+    }
+    auto const task(new emit_task{ this, std::move(ctx) });
+    pool->submit(&run_emit, make_box<obj::native_pointer_wrapper>(task));
+  }
+
+  void driver::finish_emit(jtl::string_result<void> const &res)
+  {
+    std::lock_guard<std::mutex> const lock{ mutex };
+    if(res.is_err() && error.is_none())
+    {
+      error = res.expect_err();
+    }
+    --pending;
+    emitted_cv.notify_all();
+  }
+
+  jtl::string_result<void> driver::await_emitted()
+  {
+    std::unique_lock<std::mutex> lock{ mutex };
+    emitted_cv.wait(lock, [this]() { return pending == 0; });
+    if(error.is_some())
+    {
+      return err(error.unwrap());
+    }
+    return ok();
+  }
+}
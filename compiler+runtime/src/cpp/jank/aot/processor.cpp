@@ -70,6 +70,7 @@ extern "C" jank_object_ref jank_call0(jank_object_ref f);
     sb(R"(
 extern "C" jank_object_ref jank_load_clojure_core_native();
 extern "C" jank_object_ref jank_load_clojure_string_native();
+extern "C" jank_object_ref jank_load_clojure_edn_native();
 extern "C" jank_object_ref jank_load_jank_compiler_native();
 extern "C" jank_object_ref jank_load_clojure_core();
 extern "C" jank_object_ref jank_var_intern_c(char const *, char const *);
@@ -94,6 +95,7 @@ int main(int argc, const char** argv)
   auto const fn{ [](int const argc, char const **argv) {
     jank_load_clojure_core_native();
     jank_load_clojure_string_native();
+    jank_load_clojure_edn_native();
     jank_load_jank_compiler_native();
 
     )");
@@ -173,7 +175,7 @@ int main(int argc, const char** argv)
       }
       else
       {
-        auto const find_res{ __rt_ctx->module_loader.find(module, module::origin::latest) };
+        auto const find_res{ __rt_ctx->module_loader.find(it, module::origin::latest) };
         if(find_res.is_ok() && find_res.expect_ok().sources.o.is_some())
         {
           compiler_args.push_back(strdup(find_res.expect_ok().sources.o.unwrap().path.c_str()));
@@ -181,7 +183,7 @@ int main(int argc, const char** argv)
         else
         {
           return error::internal_aot_failure(
-            util::format("Compiled module '{}' not found.", module));
+            util::format("Compiled module '{}' not found.", it));
         }
       }
     }
@@ -11,6 +11,7 @@
 #include <jank/runtime/visit.hpp>
 #include <jank/runtime/context.hpp>
 #include <jank/runtime/core.hpp>
+#include <jank/runtime/detail/allocation_stats.hpp>
 #include <jank/profile/time.hpp>
 #include <jank/util/scope_exit.hpp>
 #include <jank/util/try.hpp>
@@ -424,7 +425,7 @@ extern "C"
   jank_object_ref jank_character_create(char const *s)
   {
     jank_debug_assert(s);
-    return make_box<obj::character>(read::parse::get_char_from_literal(s).unwrap()).erase();
+    return make_box(read::parse::get_char_from_literal(s).unwrap()).erase();
   }
 
   jank_object_ref jank_list_create(jank_u64 const size, ...)
@@ -861,6 +862,20 @@ extern "C"
     return to_integer_or_hash(o_obj);
   }
 
+  /* Unlike jank_to_integer, these are numeric conversions, which will throw for anything
+   * which isn't a number. They're used to unbox values for primitive codegen. */
+  jank_i64 jank_unbox_integer(jank_object_ref const o)
+  {
+    auto const o_obj(reinterpret_cast<object *>(o));
+    return to_int(object_ref{ o_obj });
+  }
+
+  jank_f64 jank_unbox_real(jank_object_ref const o)
+  {
+    auto const o_obj(reinterpret_cast<object *>(o));
+    return to_real(object_ref{ o_obj });
+  }
+
   jank_i64
   jank_shift_mask_case_integer(jank_object_ref const o, jank_i64 const shift, jank_i64 const mask)
   {
@@ -907,6 +922,8 @@ extern "C"
                            jank_object_ref const catch_fn,
                            jank_object_ref const finally_fn)
   {
+    /* The try body's JIT frames won't restore the current fn if it throws. */
+    runtime::detail::allocation_fn_scope const fn_scope{ runtime::detail::current_allocation_fn };
     util::scope_exit const finally{ [=]() {
       auto const finally_fn_obj(reinterpret_cast<object *>(finally_fn));
       if(finally_fn_obj != jank_nil)
@@ -946,6 +963,18 @@ extern "C"
     profile::report(label);
   }
 
+  char const *jank_allocation_fn_enter(char const * const fn)
+  {
+    auto const prev(runtime::detail::current_allocation_fn);
+    runtime::detail::current_allocation_fn = fn;
+    return prev;
+  }
+
+  void jank_allocation_fn_exit(char const * const prev)
+  {
+    runtime::detail::current_allocation_fn = prev;
+  }
+
   int jank_init(int const argc,
                 char const ** const argv,
                 jank_bool const init_default_ctx,
@@ -959,9 +988,17 @@ extern "C"
       std::locale::global(std::locale(""));
 
       /* The GC needs to enabled even before arg parsing, since our native types,
-       * like strings, use the GC for allocations. It can still be configured later. */
-      GC_set_all_interior_pointers(1);
+       * like strings, use the GC for allocations. It can still be configured later.
+       *
+       * Recognizing interior pointers makes marking slower, since any word pointing anywhere
+       * into an object keeps it alive. It can be turned off with JANK_GC_INTERIOR_POINTERS=0,
+       * but that's only safe when nothing is kept alive solely by an interior pointer. Shared
+       * substrings, for example, point into the middle of another string's buffer. */
+      auto const interior_pointers(getenv("JANK_GC_INTERIOR_POINTERS"));
+      GC_set_all_interior_pointers(
+        interior_pointers && std::string_view{ interior_pointers } == "0" ? 0 : 1);
       GC_enable();
+      runtime::detail::track_collections();
 
       //obj::symbol_ref r;
       //r = make_box<obj::symbol>("foo");
@@ -13,9 +13,11 @@
 #include <jank/runtime/context.hpp>
 #include <jank/runtime/core/meta.hpp>
 #include <jank/runtime/core.hpp>
+#include <jank/runtime/detail/allocation_stats.hpp>
 #include <jank/evaluate.hpp>
 #include <jank/analyze/visit.hpp>
 #include <jank/analyze/rtti.hpp>
+#include <jank/analyze/step/infer_primitive_types.hpp>
 #include <jank/profile/time.hpp>
 #include <jank/util/fmt.hpp>
 
@@ -24,6 +26,21 @@ namespace jank::codegen
 {
   using namespace jank::analyze;
 
+  static llvm::OptimizationLevel llvm_optimization_level(i64 const level)
+  {
+    switch(level)
+    {
+      case 1:
+        return llvm::OptimizationLevel::O1;
+      case 2:
+        return llvm::OptimizationLevel::O2;
+      case 3:
+        return llvm::OptimizationLevel::O3;
+      default:
+        return llvm::OptimizationLevel::O0;
+    }
+  }
+
   reusable_context::reusable_context(jtl::immutable_string const &module_name)
     : module_name{ module_name }
     , ctor_name{ runtime::munge(__rt_ctx->unique_string("jank_global_init")) }
@@ -32,7 +49,7 @@ namespace jank::codegen
                                              *llvm_ctx) }
     , builder{ std::make_unique<llvm::IRBuilder<>>(*llvm_ctx) }
     , global_ctor_block{ llvm::BasicBlock::Create(*llvm_ctx, "entry") }
-    , fpm{ std::make_unique<llvm::FunctionPassManager>() }
+    , mpm{ std::make_unique<llvm::ModulePassManager>() }
     , lam{ std::make_unique<llvm::LoopAnalysisManager>() }
     , fam{ std::make_unique<llvm::FunctionAnalysisManager>() }
     , cgam{ std::make_unique<llvm::CGSCCAnalysisManager>() }
@@ -47,25 +64,61 @@ namespace jank::codegen
     module->setDataLayout(
       __rt_ctx->jit_prc.interpreter->getExecutionEngine().get().getDataLayout());
 
-    /* TODO: Configure these passes based on the CLI optimization flag. */
-
-    /* TODO: Add more passes and measure the order of the passes. */
-
     si->registerCallbacks(*pic, mam.get());
 
-    /* Do simple "peephole" optimizations and bit-twiddling optzns. */
-    fpm->addPass(llvm::InstCombinePass());
-    /* Reassociate expressions. */
-    fpm->addPass(llvm::ReassociatePass());
-    /* Eliminate Common SubExpressions. */
-    fpm->addPass(llvm::GVNPass());
-    /* Simplify the control flow graph (deleting unreachable blocks, etc). */
-    fpm->addPass(llvm::SimplifyCFGPass());
-
     llvm::PassBuilder pb;
     pb.registerModuleAnalyses(*mam);
+    pb.registerCGSCCAnalyses(*cgam);
     pb.registerFunctionAnalyses(*fam);
+    pb.registerLoopAnalyses(*lam);
     pb.crossRegisterProxies(*lam, *fam, *cgam, *mam);
+
+    auto const level(__rt_ctx->jit_prc.optimization_level);
+    if(level == 0)
+    {
+      /* Our IR is quite naive, so even unoptimized builds get some cleanup of each fn. */
+      llvm::FunctionPassManager fpm;
+      /* Do simple "peephole" optimizations and bit-twiddling optzns. */
+      fpm.addPass(llvm::InstCombinePass());
+      /* Reassociate expressions. */
+      fpm.addPass(llvm::ReassociatePass());
+      /* Eliminate Common SubExpressions. */
+      fpm.addPass(llvm::GVNPass());
+      /* Simplify the control flow graph (deleting unreachable blocks, etc). */
+      fpm.addPass(llvm::SimplifyCFGPass());
+      mpm->addPass(llvm::createModuleToFunctionPassAdaptor(std::move(fpm)));
+    }
+    else
+    {
+      /* The whole module is optimized at once, so the fns within it, like a fn and its
+       * closures, or the arities of a fn, can be inlined into each other. */
+      *mpm = pb.buildPerModuleDefaultPipeline(llvm_optimization_level(level));
+    }
+  }
+
+  void reusable_context::optimize()
+  {
+    profile::timer const timer{ util::format("ir optimize {}", module_name) };
+    mpm->run(*module, *mam);
+  }
+
+  /* Unboxed values carry their primitive type in their LLVM type, so we can always get back
+   * to it without tracking it separately. */
+  static primitive_type llvm_primitive_type(llvm::Type const * const type)
+  {
+    if(type->isIntegerTy(64))
+    {
+      return primitive_type::i64;
+    }
+    if(type->isDoubleTy())
+    {
+      return primitive_type::f64;
+    }
+    if(type->isIntegerTy(1))
+    {
+      return primitive_type::boolean;
+    }
+    return primitive_type::none;
   }
 
   llvm_processor::llvm_processor(expr::function_ref const expr,
@@ -153,6 +206,12 @@ namespace jank::codegen
           llvm::ConstantInt::get(ctx->builder->getInt64Ty(), current_ns->symbol_counter.load()) });
     }
 
+    /* Each arity is its own LLVM fn, so nothing from a previous arity is in scope. */
+    locals.clear();
+    unboxed_locals.clear();
+    recur_block = nullptr;
+    recur_phis.clear();
+
     for(usize i{}; i < arity.params.size(); ++i)
     {
       auto &param(arity.params[i]);
@@ -178,6 +237,46 @@ namespace jank::codegen
                                                          capture.first->name.c_str());
       }
     }
+
+    /* Params with a primitive type, either hinted or inferred for a loop, are unboxed once
+     * on entry. Everything within the fn then uses the raw value. */
+    for(auto const &param : arity.params)
+    {
+      auto const local(arity.frame->locals.find(param));
+      if(local == arity.frame->locals.end())
+      {
+        continue;
+      }
+
+      auto const type(step::local_primitive_type(local->second));
+      if(is_numeric(type))
+      {
+        unboxed_locals[param] = gen_unbox(locals[param], type);
+        locals.erase(param);
+      }
+    }
+
+    /* The special recur form doesn't call the fn again. Instead, it branches back up to
+     * here with the new param values. Since we stay within the same LLVM fn, unboxed params
+     * remain unboxed across iterations. */
+    if(arity.fn_ctx->is_tail_recursive)
+    {
+      auto const entry_block(ctx->builder->GetInsertBlock());
+      recur_block = llvm::BasicBlock::Create(*ctx->llvm_ctx, "recur", fn);
+      ctx->builder->CreateBr(recur_block);
+      ctx->builder->SetInsertPoint(recur_block);
+
+      recur_phis.reserve(arity.params.size());
+      for(auto const &param : arity.params)
+      {
+        auto const unboxed(unboxed_locals.find(param));
+        auto &value(unboxed == unboxed_locals.end() ? locals[param] : unboxed->second);
+        auto const phi(ctx->builder->CreatePHI(value->getType(), 2, param->get_name().c_str()));
+        phi->addIncoming(value, entry_block);
+        value = phi;
+        recur_phis.emplace_back(phi);
+      }
+    }
   }
 
   jtl::string_result<void> llvm_processor::gen()
@@ -202,6 +301,13 @@ namespace jank::codegen
       {
         ctx->builder->CreateRet(gen_global(jank_nil));
       }
+
+      /* AOT compiled frames can be symbolized, so only JIT compiled fns need this. */
+      if(target != compilation_target::module
+         && runtime::detail::allocation_sample_interval.load(std::memory_order_relaxed) != 0)
+      {
+        gen_allocation_fn_scope();
+      }
     }
 
     if(target == compilation_target::eval)
@@ -209,9 +315,6 @@ namespace jank::codegen
       //to_string();
     }
 
-    /* Run our optimization passes on the function, mutating it. */
-    ctx->fpm->run(*fn, *ctx->fam);
-
     if(target != compilation_target::function)
     {
       llvm::IRBuilder<>::InsertPointGuard const guard{ *ctx->builder };
@@ -228,6 +331,9 @@ namespace jank::codegen
       }
 
       ctx->builder->CreateRetVoid();
+
+      /* Nested fns build into our module, so once we're done, the whole module is. */
+      ctx->optimize();
     }
 
     return ok();
@@ -342,6 +448,20 @@ namespace jank::codegen
 
   llvm::Value *llvm_processor::gen(expr::call_ref const expr, expr::function_arity const &arity)
   {
+    /* Math on primitives is emitted inline and only boxed once the result is needed as an
+     * object. Nested math, like `(+ (* a b) c)`, doesn't box the intermediate value, since
+     * gen_unboxed handles the whole tree. */
+    auto const unboxed_type(step::infer_primitive_type(expr));
+    if(unboxed_type != primitive_type::none)
+    {
+      auto const ret(gen_box(gen_unboxed(expr, unboxed_type, arity), unboxed_type));
+      if(expr->position == expression_position::tail)
+      {
+        return ctx->builder->CreateRet(ret);
+      }
+      return ret;
+    }
+
     auto const callee(gen(expr->source_expr, arity));
 
     llvm::SmallVector<llvm::Value *> arg_handles;
@@ -362,7 +482,16 @@ namespace jank::codegen
 
     auto const fn_type(llvm::FunctionType::get(ctx->builder->getPtrTy(), arg_types, false));
     auto const fn(ctx->module->getOrInsertFunction(call_fn_name.c_str(), fn_type));
-    auto const call(ctx->builder->CreateCall(fn, arg_handles));
+
+    llvm::Value *call{};
+    if(expr->direct_call_arity_flags.is_some())
+    {
+      call = gen_direct_call(callee, arg_handles, expr->direct_call_arity_flags.unwrap(), fn);
+    }
+    else
+    {
+      call = ctx->builder->CreateCall(fn, arg_handles);
+    }
 
     if(expr->position == expression_position::tail)
     {
@@ -372,6 +501,120 @@ namespace jank::codegen
     return call;
   }
 
+  /* Byte offset of a jit_function field from the object base, since the object base is what
+   * we have in hand in generated code. The generated code always runs against the same jank
+   * build which generated it, so these offsets are stable. */
+  static u64 jit_function_field_offset(usize const field_offset)
+  {
+    return field_offset - offsetof(obj::jit_function, base);
+  }
+
+  /* Generated code loads the compiled fn as a plain pointer, with acquire ordering. */
+  static_assert(sizeof(std::atomic<object *>) == sizeof(object *)
+                  && std::atomic<object *>::is_always_lock_free,
+                "interpreted_function::compiled must be a lock free pointer");
+
+  static u64 interpreted_function_compiled_offset()
+  {
+    return offsetof(obj::interpreted_function, compiled)
+      - offsetof(obj::interpreted_function, base);
+  }
+
+  static_assert(offsetof(obj::jit_function, arity_10)
+                  == offsetof(obj::jit_function, arity_0) + (sizeof(void *) * 10),
+                "jit_function arities must be laid out contiguously");
+
+  /* Generates a guarded direct call to a jit_function arity. The guard checks that the callee
+   * is still a jit_function with the same arity flags seen during analysis and that it has a
+   * native fn for this arity. When that holds, we call the native fn directly, skipping
+   * dynamic_call's visitor and the virtual call. Otherwise, we fall back to jank_callN, which
+   * handles anything, such as the var having been rebound to a map or a variadic fn.
+   *
+   * Vars defined by the interpreter keep holding the interpreted fn, even once it has been
+   * compiled, so the guard looks through an interpreted fn to its compiled fn. Until it's
+   * compiled, the call is dynamic. */
+  llvm::Value *llvm_processor::gen_direct_call(llvm::Value * const callee,
+                                               llvm::ArrayRef<llvm::Value *> const arg_handles,
+                                               u8 const arity_flags,
+                                               llvm::FunctionCallee const fallback_fn)
+  {
+    auto const arg_count(arg_handles.size() - 1);
+    auto const entry_block(ctx->builder->GetInsertBlock());
+    auto const current_fn(entry_block->getParent());
+    auto const unwrap_block(
+      llvm::BasicBlock::Create(*ctx->llvm_ctx, "direct_unwrap", current_fn));
+    auto const type_block(llvm::BasicBlock::Create(*ctx->llvm_ctx, "direct_type", current_fn));
+    auto const guard_block(llvm::BasicBlock::Create(*ctx->llvm_ctx, "direct_guard", current_fn));
+    auto const direct_block(llvm::BasicBlock::Create(*ctx->llvm_ctx, "direct_call", current_fn));
+    auto const dynamic_block(llvm::BasicBlock::Create(*ctx->llvm_ctx, "dynamic_call", current_fn));
+    auto const merge_block(llvm::BasicBlock::Create(*ctx->llvm_ctx, "call_merge", current_fn));
+
+    /* The object type is the first field of every object base. */
+    auto const type(ctx->builder->CreateLoad(ctx->builder->getInt8Ty(), callee));
+    auto const is_interpreted(ctx->builder->CreateICmpEQ(
+      type,
+      ctx->builder->getInt8(static_cast<u8>(object_type::interpreted_function))));
+    ctx->builder->CreateCondBr(is_interpreted, unwrap_block, type_block);
+
+    ctx->builder->SetInsertPoint(unwrap_block);
+    auto const compiled_ptr(
+      ctx->builder->CreateConstInBoundsGEP1_64(ctx->builder->getInt8Ty(),
+                                               callee,
+                                               interpreted_function_compiled_offset()));
+    auto const compiled(ctx->builder->CreateLoad(ctx->builder->getPtrTy(), compiled_ptr));
+    compiled->setAtomic(llvm::AtomicOrdering::Acquire);
+    compiled->setAlignment(llvm::Align{ alignof(object *) });
+    ctx->builder->CreateCondBr(ctx->builder->CreateIsNotNull(compiled),
+                               type_block,
+                               dynamic_block);
+
+    ctx->builder->SetInsertPoint(type_block);
+    auto const target(ctx->builder->CreatePHI(ctx->builder->getPtrTy(), 2, "direct_target"));
+    target->addIncoming(callee, entry_block);
+    target->addIncoming(compiled, unwrap_block);
+    auto const target_type(ctx->builder->CreateLoad(ctx->builder->getInt8Ty(), target));
+    auto const is_jit_function(ctx->builder->CreateICmpEQ(
+      target_type,
+      ctx->builder->getInt8(static_cast<u8>(object_type::jit_function))));
+    ctx->builder->CreateCondBr(is_jit_function, guard_block, dynamic_block);
+
+    ctx->builder->SetInsertPoint(guard_block);
+    auto const flags_ptr(ctx->builder->CreateConstInBoundsGEP1_64(
+      ctx->builder->getInt8Ty(),
+      target,
+      jit_function_field_offset(offsetof(obj::jit_function, arity_flags))));
+    auto const flags(ctx->builder->CreateLoad(ctx->builder->getInt8Ty(), flags_ptr));
+    auto const flags_match(ctx->builder->CreateICmpEQ(flags, ctx->builder->getInt8(arity_flags)));
+    auto const arity_fn_ptr(ctx->builder->CreateConstInBoundsGEP1_64(
+      ctx->builder->getInt8Ty(),
+      target,
+      jit_function_field_offset(offsetof(obj::jit_function, arity_0)
+                                + (sizeof(void *) * arg_count))));
+    auto const arity_fn(ctx->builder->CreateLoad(ctx->builder->getPtrTy(), arity_fn_ptr));
+    auto const has_arity(ctx->builder->CreateIsNotNull(arity_fn));
+    ctx->builder->CreateCondBr(ctx->builder->CreateAnd(flags_match, has_arity),
+                               direct_block,
+                               dynamic_block);
+
+    ctx->builder->SetInsertPoint(direct_block);
+    std::vector<llvm::Type *> const direct_arg_types{ arg_count, ctx->builder->getPtrTy() };
+    auto const direct_fn_type(
+      llvm::FunctionType::get(ctx->builder->getPtrTy(), direct_arg_types, false));
+    auto const direct_call(
+      ctx->builder->CreateCall(direct_fn_type, arity_fn, arg_handles.drop_front()));
+    ctx->builder->CreateBr(merge_block);
+
+    ctx->builder->SetInsertPoint(dynamic_block);
+    auto const fallback_call(ctx->builder->CreateCall(fallback_fn, arg_handles));
+    ctx->builder->CreateBr(merge_block);
+
+    ctx->builder->SetInsertPoint(merge_block);
+    auto const phi(ctx->builder->CreatePHI(ctx->builder->getPtrTy(), 2, "call"));
+    phi->addIncoming(direct_call, direct_block);
+    phi->addIncoming(fallback_call, dynamic_block);
+    return phi;
+  }
+
   llvm::Value *
   llvm_processor::gen(expr::primitive_literal_ref const expr, expr::function_arity const &)
   {
@@ -524,7 +767,18 @@ namespace jank::codegen
   llvm::Value *
   llvm_processor::gen(expr::local_reference_ref const expr, expr::function_arity const &)
   {
-    auto const ret(locals[expr->binding->name]);
+    llvm::Value *ret{};
+    auto const unboxed(unboxed_locals.find(expr->binding->name));
+    if(unboxed != unboxed_locals.end())
+    {
+      /* Referencing an unboxed local outside of primitive codegen means it escapes, so this is
+       * where it gets boxed. */
+      ret = gen_box(unboxed->second, llvm_primitive_type(unboxed->second->getType()));
+    }
+    else
+    {
+      ret = locals[expr->binding->name];
+    }
     jank_debug_assert(ret);
 
     if(expr->position == expression_position::tail)
@@ -564,43 +818,32 @@ namespace jank::codegen
 
   llvm::Value *llvm_processor::gen(expr::recur_ref const expr, expr::function_arity const &arity)
   {
-    /* The codegen for the special recur form is very similar to the named recursion
-     * codegen, but it's simpler. The key difference is that named recursion requires
-     * arg packing, whereas the special recur form does not. This means, for variadic
-     * functions, the special recur form will be expected to supply a sequence for the
-     * variadic argument. */
-    auto const &fn_expr(*root_fn->arities[0].fn_ctx->fn);
-    auto const is_closure(!fn_expr.captures().empty());
-
+    /* The special recur form is always in tail position of the current arity, so we just
+     * feed the new param values into the phis at the top of the arity and branch back there.
+     * Unlike named recursion, there's no arg packing, so variadic functions will be expected
+     * to supply a sequence for the variadic argument. */
+    jank_debug_assert(recur_block);
+    jank_debug_assert(recur_phis.size() == expr->arg_exprs.size());
+
+    /* All args are generated before any phi is updated, since the args may refer to the
+     * current values of any param. */
     llvm::SmallVector<llvm::Value *> arg_handles;
-    llvm::SmallVector<llvm::Type *> arg_types;
-    arg_handles.reserve(expr->arg_exprs.size() + is_closure);
-    arg_types.reserve(expr->arg_exprs.size() + is_closure);
-
-    if(is_closure)
-    {
-      arg_handles.emplace_back(ctx->builder->GetInsertBlock()->getParent()->getArg(0));
-      arg_types.emplace_back(ctx->builder->getPtrTy());
-    }
-
-    for(auto const &arg_expr : expr->arg_exprs)
+    arg_handles.reserve(expr->arg_exprs.size());
+    for(usize i{}; i < expr->arg_exprs.size(); ++i)
     {
-      arg_handles.emplace_back(gen(arg_expr, arity));
-      arg_types.emplace_back(ctx->builder->getPtrTy());
+      auto const type(llvm_primitive_type(recur_phis[i]->getType()));
+      arg_handles.emplace_back(type == primitive_type::none
+                                 ? gen(expr->arg_exprs[i], arity)
+                                 : gen_unboxed(expr->arg_exprs[i], type, arity));
     }
 
-    auto const call_fn_name(
-      util::format("{}_{}", munge(fn_expr.unique_name), expr->arg_exprs.size()));
-    auto const fn_type(llvm::FunctionType::get(ctx->builder->getPtrTy(), arg_types, false));
-    auto const fn(ctx->module->getOrInsertFunction(call_fn_name.c_str(), fn_type));
-    auto const call(ctx->builder->CreateCall(fn, arg_handles));
-
-    if(expr->position == expression_position::tail)
+    auto const current_block(ctx->builder->GetInsertBlock());
+    for(usize i{}; i < arg_handles.size(); ++i)
     {
-      return ctx->builder->CreateRet(call);
+      recur_phis[i]->addIncoming(arg_handles[i], current_block);
     }
 
-    return call;
+    return ctx->builder->CreateBr(recur_block);
   }
 
   llvm::Value *
@@ -744,6 +987,7 @@ namespace jank::codegen
   llvm::Value *llvm_processor::gen(expr::let_ref const expr, expr::function_arity const &arity)
   {
     auto old_locals(locals);
+    auto old_unboxed_locals(unboxed_locals);
     for(auto const &pair : expr->pairs)
     {
       auto const local(expr->frame->find_local_or_capture(pair.first));
@@ -753,12 +997,25 @@ namespace jank::codegen
                                                pair.first->to_string()) };
       }
 
-      locals[pair.first] = gen(pair.second, arity);
-      locals[pair.first]->setName(pair.first->to_string().c_str());
+      auto const type(step::local_primitive_type(*local.unwrap().binding));
+      if(is_numeric(type))
+      {
+        auto const value(gen_unboxed(pair.second, type, arity));
+        value->setName(pair.first->to_string().c_str());
+        unboxed_locals[pair.first] = value;
+        locals.erase(pair.first);
+      }
+      else
+      {
+        locals[pair.first] = gen(pair.second, arity);
+        locals[pair.first]->setName(pair.first->to_string().c_str());
+        unboxed_locals.erase(pair.first);
+      }
     }
 
     auto const ret(gen(expr->body, arity));
     locals = std::move(old_locals);
+    unboxed_locals = std::move(old_unboxed_locals);
 
     /* XXX: No return creation, since we rely on the body to do that. */
 
@@ -788,6 +1045,7 @@ namespace jank::codegen
     deferred_inits = {};
 
     auto old_locals(locals);
+    auto old_unboxed_locals(unboxed_locals);
     for(auto const &pair : expr->pairs)
     {
       auto const local(expr->frame->find_local_or_capture(pair.first));
@@ -797,6 +1055,7 @@ namespace jank::codegen
                                                pair.first->to_string()) };
       }
 
+      unboxed_locals.erase(pair.first);
       locals[pair.first] = gen(pair.second, arity);
       locals[pair.first]->setName(pair.first->to_string().c_str());
     }
@@ -814,6 +1073,7 @@ namespace jank::codegen
 
     auto const ret(gen(expr->body, arity));
     locals = std::move(old_locals);
+    unboxed_locals = std::move(old_unboxed_locals);
     deferred_inits = std::move(old_deferred_inits);
 
     /* XXX: No return creation, since we rely on the body to do that. */
@@ -857,13 +1117,19 @@ namespace jank::codegen
      * for us. Since LLVM basic blocks can only have one terminating instruction, we need
      * to take care to not generate our own, too. */
     auto const is_return(expr->position == expression_position::tail);
-    auto const condition(gen(expr->condition, arity));
-    auto const truthy_fn_type(
-      llvm::FunctionType::get(ctx->builder->getInt8Ty(), { ctx->builder->getPtrTy() }, false));
-    auto const fn(ctx->module->getOrInsertFunction("jank_truthy", truthy_fn_type));
-    llvm::SmallVector<llvm::Value *, 1> const args{ condition };
-    auto const call(ctx->builder->CreateCall(fn, args));
-    auto const cmp(ctx->builder->CreateICmpEQ(call, ctx->builder->getInt8(1), "iftmp"));
+
+    /* Primitive comparisons give us an i1 directly, so there's no need to box the result
+     * just to check whether it's truthy. */
+    llvm::Value *cmp{};
+    if(step::infer_primitive_type(expr->condition) == primitive_type::boolean)
+    {
+      cmp = gen_unboxed(expr->condition, primitive_type::boolean, arity);
+    }
+    else
+    {
+      auto const condition(gen(expr->condition, arity));
+      cmp = gen_unbox(condition, primitive_type::boolean);
+    }
 
     auto const current_fn(ctx->builder->GetInsertBlock()->getParent());
     auto then_block(llvm::BasicBlock::Create(*ctx->llvm_ctx, "then", current_fn));
@@ -1045,6 +1311,223 @@ namespace jank::codegen
     return nullptr;
   }
 
+  llvm::Value *llvm_processor::gen_unboxed(expression_ref const ex,
+                                           primitive_type const type,
+                                           expr::function_arity const &arity)
+  {
+    jank_debug_assert(type != primitive_type::none);
+
+    auto const inferred(step::infer_primitive_type(ex));
+    if(inferred == primitive_type::none)
+    {
+      /* This is only reached for coercion into a hinted local or param. */
+      return gen_unbox(gen(ex, arity), type);
+    }
+
+    llvm::Value *ret{};
+    switch(ex->kind)
+    {
+      case expression_kind::primitive_literal:
+        {
+          auto const data(llvm::cast<expr::primitive_literal>(ex.data)->data);
+          if(inferred == primitive_type::i64)
+          {
+            ret = ctx->builder->getInt64(expect_object<obj::integer>(data)->data);
+          }
+          else
+          {
+            ret = llvm::ConstantFP::get(ctx->builder->getDoubleTy(),
+                                        expect_object<obj::real>(data)->data);
+          }
+        }
+        break;
+      case expression_kind::local_reference:
+        {
+          auto const &name(llvm::cast<expr::local_reference>(ex.data)->binding->name);
+          auto const unboxed(unboxed_locals.find(name));
+          /* Captured locals are always boxed in the closure context, so those need to be
+           * unboxed at each use. */
+          ret = unboxed == unboxed_locals.end() ? gen_unbox(locals[name], inferred)
+                                                : unboxed->second;
+        }
+        break;
+      case expression_kind::call:
+        ret = gen_unboxed_call(jtl::static_ref_cast<expr::call>(ex), inferred, arity);
+        break;
+      default:
+        throw std::runtime_error{ util::format("ICE: unexpected primitive expression kind: {}",
+                                               expression_kind_str(ex->kind)) };
+    }
+
+    return gen_primitive_cast(ret, type);
+  }
+
+  llvm::Value *llvm_processor::gen_unboxed_call(expr::call_ref const expr,
+                                                primitive_type const type,
+                                                expr::function_arity const &arity)
+  {
+    auto const op(step::primitive_call_op(*expr));
+
+    /* For arithmetic, the operand type is the result type. For comparisons, we compare as
+     * doubles if either side is a double. Runtime equivalence always compares as doubles, so
+     * we match that. */
+    auto operand_type(type);
+    if(type == primitive_type::boolean)
+    {
+      operand_type = primitive_type::i64;
+      for(auto const &arg : expr->arg_exprs)
+      {
+        if(op == step::primitive_op::equiv
+           || step::infer_primitive_type(arg) == primitive_type::f64)
+        {
+          operand_type = primitive_type::f64;
+        }
+      }
+    }
+
+    llvm::SmallVector<llvm::Value *, 2> args;
+    for(auto const &arg_expr : expr->arg_exprs)
+    {
+      args.emplace_back(gen_unboxed(arg_expr, operand_type, arity));
+    }
+
+    auto const is_int(operand_type == primitive_type::i64);
+    auto const one(is_int ? ctx->builder->getInt64(1)
+                          : llvm::ConstantFP::get(ctx->builder->getDoubleTy(), 1.0));
+    auto const zero(is_int ? ctx->builder->getInt64(0)
+                           : llvm::ConstantFP::get(ctx->builder->getDoubleTy(), 0.0));
+
+    switch(op)
+    {
+      case step::primitive_op::add:
+        return is_int ? ctx->builder->CreateAdd(args[0], args[1])
+                      : ctx->builder->CreateFAdd(args[0], args[1]);
+      case step::primitive_op::sub:
+        return is_int ? ctx->builder->CreateSub(args[0], args[1])
+                      : ctx->builder->CreateFSub(args[0], args[1]);
+      case step::primitive_op::mul:
+        return is_int ? ctx->builder->CreateMul(args[0], args[1])
+                      : ctx->builder->CreateFMul(args[0], args[1]);
+      case step::primitive_op::negate:
+        return is_int ? ctx->builder->CreateSub(zero, args[0])
+                      : ctx->builder->CreateFSub(zero, args[0]);
+      case step::primitive_op::inc:
+        return is_int ? ctx->builder->CreateAdd(args[0], one)
+                      : ctx->builder->CreateFAdd(args[0], one);
+      case step::primitive_op::dec:
+        return is_int ? ctx->builder->CreateSub(args[0], one)
+                      : ctx->builder->CreateFSub(args[0], one);
+      case step::primitive_op::lt:
+        return is_int ? ctx->builder->CreateICmpSLT(args[0], args[1])
+                      : ctx->builder->CreateFCmpOLT(args[0], args[1]);
+      case step::primitive_op::lte:
+        return is_int ? ctx->builder->CreateICmpSLE(args[0], args[1])
+                      : ctx->builder->CreateFCmpOLE(args[0], args[1]);
+      case step::primitive_op::gt:
+        return is_int ? ctx->builder->CreateICmpSGT(args[0], args[1])
+                      : ctx->builder->CreateFCmpOGT(args[0], args[1]);
+      case step::primitive_op::gte:
+        return is_int ? ctx->builder->CreateICmpSGE(args[0], args[1])
+                      : ctx->builder->CreateFCmpOGE(args[0], args[1]);
+      case step::primitive_op::equiv:
+        return ctx->builder->CreateFCmpOEQ(args[0], args[1]);
+      case step::primitive_op::none:
+        break;
+    }
+
+    throw std::runtime_error{ "ICE: call has no primitive op" };
+  }
+
+  llvm::Value *llvm_processor::gen_box(llvm::Value * const unboxed, primitive_type const type) const
+  {
+    switch(type)
+    {
+      case primitive_type::i64:
+        {
+          auto const fn_type(llvm::FunctionType::get(ctx->builder->getPtrTy(),
+                                                     { ctx->builder->getInt64Ty() },
+                                                     false));
+          auto const fn(ctx->module->getOrInsertFunction("jank_integer_create", fn_type));
+          return ctx->builder->CreateCall(fn, { unboxed });
+        }
+      case primitive_type::f64:
+        {
+          auto const fn_type(llvm::FunctionType::get(ctx->builder->getPtrTy(),
+                                                     { ctx->builder->getDoubleTy() },
+                                                     false));
+          auto const fn(ctx->module->getOrInsertFunction("jank_real_create", fn_type));
+          return ctx->builder->CreateCall(fn, { unboxed });
+        }
+      case primitive_type::boolean:
+        return ctx->builder->CreateSelect(unboxed,
+                                          gen_global(jank_true),
+                                          gen_global(jank_false));
+      case primitive_type::none:
+        break;
+    }
+
+    return unboxed;
+  }
+
+  llvm::Value *llvm_processor::gen_unbox(llvm::Value * const boxed, primitive_type const type) const
+  {
+    switch(type)
+    {
+      case primitive_type::i64:
+        {
+          auto const fn_type(
+            llvm::FunctionType::get(ctx->builder->getInt64Ty(), { ctx->builder->getPtrTy() }, false));
+          auto const fn(ctx->module->getOrInsertFunction("jank_unbox_integer", fn_type));
+          return ctx->builder->CreateCall(fn, { boxed });
+        }
+      case primitive_type::f64:
+        {
+          auto const fn_type(llvm::FunctionType::get(ctx->builder->getDoubleTy(),
+                                                     { ctx->builder->getPtrTy() },
+                                                     false));
+          auto const fn(ctx->module->getOrInsertFunction("jank_unbox_real", fn_type));
+          return ctx->builder->CreateCall(fn, { boxed });
+        }
+      case primitive_type::boolean:
+        {
+          auto const fn_type(
+            llvm::FunctionType::get(ctx->builder->getInt8Ty(), { ctx->builder->getPtrTy() }, false));
+          auto const fn(ctx->module->getOrInsertFunction("jank_truthy", fn_type));
+          auto const call(ctx->builder->CreateCall(fn, { boxed }));
+          return ctx->builder->CreateICmpEQ(call, ctx->builder->getInt8(1), "iftmp");
+        }
+      case primitive_type::none:
+        break;
+    }
+
+    return boxed;
+  }
+
+  /* Converts between numeric primitives the same way the runtime math fns do, which is
+   * just a C++ conversion. */
+  llvm::Value *
+  llvm_processor::gen_primitive_cast(llvm::Value * const unboxed, primitive_type const type) const
+  {
+    auto const from(llvm_primitive_type(unboxed->getType()));
+    if(from == type)
+    {
+      return unboxed;
+    }
+
+    if(from == primitive_type::i64 && type == primitive_type::f64)
+    {
+      return ctx->builder->CreateSIToFP(unboxed, ctx->builder->getDoubleTy());
+    }
+    if(from == primitive_type::f64 && type == primitive_type::i64)
+    {
+      return ctx->builder->CreateFPToSI(unboxed, ctx->builder->getInt64Ty());
+    }
+
+    throw std::runtime_error{ util::format("ICE: unable to cast primitive {} to {}",
+                                           primitive_type_str(from),
+                                           primitive_type_str(type)) };
+  }
+
   llvm::Value *llvm_processor::gen_var(obj::symbol_ref const qualified_name) const
   {
     auto const found(ctx->var_globals.find(qualified_name));
@@ -1163,6 +1646,21 @@ namespace jank::codegen
 
   llvm::Value *llvm_processor::gen_global(obj::integer_ref const i) const
   {
+    /* Small integers are already boxed, in the runtime's integer cache, so we can point
+     * right at them. That needs no global of our own and no work in the global ctor. */
+    if(runtime::is_integer_cached(i->data))
+    {
+      auto const cache_base(reinterpret_cast<uintptr_t>(jank_integer_cache.data()));
+      auto const cached(reinterpret_cast<uintptr_t>(&runtime::cached_integer(i->data)->base));
+      auto const cache_type(
+        llvm::ArrayType::get(ctx->builder->getInt8Ty(), sizeof(jank_integer_cache)));
+      auto const cache(ctx->module->getOrInsertGlobal("jank_integer_cache", cache_type));
+      return llvm::ConstantExpr::getInBoundsGetElementPtr(
+        ctx->builder->getInt8Ty(),
+        cache,
+        llvm::ConstantInt::get(ctx->builder->getInt64Ty(), cached - cache_base));
+    }
+
     auto const found(ctx->literal_globals.find(i));
     if(found != ctx->literal_globals.end())
     {
@@ -1603,7 +2101,7 @@ namespace jank::codegen
       {
         auto const field_ptr(ctx->builder->CreateStructGEP(closure_ctx_type, closure_obj, index++));
         auto const name(capture.first);
-        if(!locals.contains(name))
+        if(!locals.contains(name) && !unboxed_locals.contains(name))
         {
           deferred_inits.emplace_back(expr, name, capture.second, field_ptr);
         }
@@ -1697,6 +2195,47 @@ namespace jank::codegen
     }
   }
 
+  /* Sets the current fn for allocation sampling when the arity is entered and restores
+   * the caller's before each of its returns. This is done once the arity is complete, so
+   * that every return is known. */
+  void llvm_processor::gen_allocation_fn_scope() const
+  {
+    auto const name(get(root_fn->meta, __rt_ctx->intern_keyword("name").expect_ok()));
+    if(name->type != object_type::persistent_string)
+    {
+      return;
+    }
+
+    llvm::IRBuilder<>::InsertPointGuard const guard{ *ctx->builder };
+    auto &entry(fn->getEntryBlock());
+    ctx->builder->SetInsertPoint(&entry, entry.getFirstInsertionPt());
+
+    auto const ptr_type(ctx->builder->getPtrTy());
+    auto const enter_fn(ctx->module->getOrInsertFunction(
+      "jank_allocation_fn_enter",
+      llvm::FunctionType::get(ptr_type, { ptr_type }, false)));
+    auto const exit_fn(ctx->module->getOrInsertFunction(
+      "jank_allocation_fn_exit",
+      llvm::FunctionType::get(ctx->builder->getVoidTy(), { ptr_type }, false)));
+    auto const prev(ctx->builder->CreateCall(
+      enter_fn,
+      { gen_c_string(expect_object<obj::persistent_string>(name)->data) }));
+
+    native_vector<llvm::ReturnInst *> returns;
+    for(auto &block : *fn)
+    {
+      if(auto const ret = llvm::dyn_cast_or_null<llvm::ReturnInst>(block.getTerminator()))
+      {
+        returns.emplace_back(ret);
+      }
+    }
+    for(auto const ret : returns)
+    {
+      ctx->builder->SetInsertPoint(ret);
+      ctx->builder->CreateCall(exit_fn, { prev });
+    }
+  }
+
   llvm::GlobalVariable *llvm_processor::create_global_var(jtl::immutable_string const &name) const
   {
     return new llvm::GlobalVariable{ ctx->builder->getPtrTy(),
@@ -9,6 +9,8 @@
 #include <jank/codegen/llvm_processor.hpp>
 #include <jank/jit/processor.hpp>
 #include <jank/evaluate.hpp>
+#include <jank/evaluate/interpreter.hpp>
+#include <jank/evaluate/object_cache.hpp>
 #include <jank/profile/time.hpp>
 #include <jank/util/scope_exit.hpp>
 #include <jank/util/fmt/print.hpp>
@@ -248,6 +250,14 @@ namespace jank::evaluate
 
   object_ref eval(expression_ref const ex)
   {
+    /* Cold code is much cheaper to interpret than to compile. Fns which turn out to be hot
+     * are compiled by the interpreter later. Forms which can be cached are compiled, though,
+     * since loading them from the cache is cheaper still. */
+    if(__rt_ctx->interpret && !object_cache::caching())
+    {
+      return interpret(ex);
+    }
+
     profile::timer const timer{ "eval ast node" };
     object_ref ret{};
     visit_expr([&ret](auto const typed_ex) { ret = eval(typed_ex); }, ex);
@@ -258,6 +268,7 @@ namespace jank::evaluate
   {
     auto var(__rt_ctx->intern_var(expr->name).expect_ok());
     var->meta = expr->name->meta;
+    object_cache::note_def(var);
 
     auto const meta(var->meta.unwrap_or(jank_nil));
     auto const dynamic(get(meta, __rt_ctx->intern_keyword("dynamic").expect_ok()));
@@ -565,6 +576,12 @@ namespace jank::evaluate
                           munge(expr->unique_name)));
 
     auto const wrapped_expr(evaluate::wrap_expression(expr, "repl_fn", {}));
+    auto const cached(object_cache::eval(wrapped_expr, module));
+    if(cached.is_some())
+    {
+      return cached.unwrap();
+    }
+
     codegen::llvm_processor cg_prc{ wrapped_expr, module, codegen::compilation_target::eval };
     cg_prc.gen().expect_ok();
 
@@ -0,0 +1,957 @@
+#include <condition_variable>
+#include <mutex>
+
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
+
+#include <jank/c_api.h>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/ns.hpp>
+#include <jank/runtime/visit.hpp>
+#include <jank/runtime/core.hpp>
+#include <jank/runtime/core/meta.hpp>
+#include <jank/runtime/behavior/callable.hpp>
+#include <jank/runtime/obj/interpreted_function.hpp>
+#include <jank/runtime/obj/persistent_string.hpp>
+#include <jank/runtime/detail/allocation_stats.hpp>
+#include <jank/runtime/thread_pool.hpp>
+#include <jank/codegen/llvm_processor.hpp>
+#include <jank/jit/processor.hpp>
+#include <jank/evaluate/interpreter.hpp>
+#include <jank/evaluate/object_cache.hpp>
+#include <jank/profile/time.hpp>
+#include <jank/util/scope_exit.hpp>
+#include <jank/util/fmt.hpp>
+#include <jank/analyze/visit.hpp>
+
+namespace jank::evaluate
+{
+  using namespace jank::runtime;
+  using namespace jank::analyze;
+
+  /* JIT compilation is serialized, since compiling one fn renames the fns nested within
+   * it and we don't want two threads doing that at once. */
+  static std::mutex compile_mutex;
+
+  /* How many fns are queued for background compilation, but not yet done. */
+  static usize pending_compiles{};
+  static std::mutex pending_mutex;
+  static std::condition_variable pending_cv;
+
+  object_ref environment::find(obj::symbol_ref const sym) const
+  {
+    for(auto env(this); env; env = env->parent)
+    {
+      for(auto it(env->locals.rbegin()); it != env->locals.rend(); ++it)
+      {
+        if(it->first == sym || *it->first == *sym)
+        {
+          return it->second;
+        }
+      }
+    }
+
+    throw std::runtime_error{ util::format("Unable to find local: {}", sym->to_string()) };
+  }
+
+  object_ref environment::find_fn(analyze::expr::function const * const expr) const
+  {
+    for(auto env(this); env; env = env->parent)
+    {
+      if(env->fn_expr == expr)
+      {
+        return env->fn;
+      }
+    }
+
+    throw std::runtime_error{ "Unable to find the fn for named recursion" };
+  }
+
+  /* This follows what codegen does when it creates a fn instance. */
+  static behavior::callable::arity_flag_t arity_flags_of(expr::function const &expr)
+  {
+    expr::function_arity const *variadic_arity{};
+    expr::function_arity const *highest_fixed_arity{};
+    for(auto const &arity : expr.arities)
+    {
+      if(arity.fn_ctx->is_variadic)
+      {
+        variadic_arity = &arity;
+      }
+      else if(!highest_fixed_arity
+              || highest_fixed_arity->fn_ctx->param_count < arity.fn_ctx->param_count)
+      {
+        highest_fixed_arity = &arity;
+      }
+    }
+    auto const variadic_ambiguous(highest_fixed_arity && variadic_arity
+                                  && highest_fixed_arity->fn_ctx->param_count
+                                    == variadic_arity->fn_ctx->param_count - 1);
+    auto const highest_fixed_args(variadic_arity ? variadic_arity->fn_ctx->param_count - 1
+                                                 : highest_fixed_arity->fn_ctx->param_count);
+
+    return behavior::callable::build_arity_flags(static_cast<u8>(highest_fixed_args),
+                                                 variadic_arity != nullptr,
+                                                 variadic_ambiguous);
+  }
+
+  static function_tier *tier_of(expr::function &expr)
+  {
+    std::atomic_ref<function_tier *> const tier{ expr.tier };
+    auto existing(tier.load());
+    if(existing)
+    {
+      return existing;
+    }
+
+    auto const fresh(new(GC) function_tier{});
+    fresh->arity_flags = arity_flags_of(expr);
+    if(expr.meta.is_some())
+    {
+      fresh->meta = strip_source_from_meta(expr.meta);
+    }
+    if(tier.compare_exchange_strong(existing, fresh))
+    {
+      return fresh;
+    }
+    return existing;
+  }
+
+  /* Generates IR for the fn and JIT compiles it. The fn expression is compiled as is, so
+   * the interpreter and the compiled code share the same analysis. Since a fn may be
+   * compiled more than once, such as on its own and then again as part of a fn which
+   * encloses it, every fn within the tree gets a fresh unique name first. */
+  static void compile(expr::function &expr, function_tier &tier)
+  {
+    native_set<expr::function const *> fns;
+    native_vector<expr::function *> nested;
+    walk_expr(expression_ref{ &expr }, [&](auto const typed_expr) {
+      using T = typename decltype(typed_expr)::value_type;
+
+      if constexpr(std::same_as<T, expr::function>)
+      {
+        fns.emplace(typed_expr.data);
+        nested.emplace_back(typed_expr.data);
+      }
+    });
+
+    bool self_contained{ true };
+    walk_expr(expression_ref{ &expr }, [&](auto const typed_expr) {
+      using T = typename decltype(typed_expr)::value_type;
+
+      if constexpr(std::same_as<T, expr::recursion_reference>)
+      {
+        self_contained &= fns.contains(typed_expr->fn_ctx->fn.data);
+      }
+      else if constexpr(std::same_as<T, expr::named_recursion>)
+      {
+        self_contained &= fns.contains(typed_expr->recursion_ref.fn_ctx->fn.data);
+      }
+    });
+
+    /* Recursing into an enclosing fn means calling its generated code directly, but that
+     * fn may still be interpreted. */
+    if(!self_contained)
+    {
+      tier.state.store(function_tier_state::failed);
+      return;
+    }
+
+    profile::timer const timer{ util::format("interpreter jit compile {}", expr.name) };
+    for(auto const fn : nested)
+    {
+      fn->unique_name = __rt_ctx->unique_string(fn->name);
+    }
+
+    auto const &module(module::nest_module(tier.module, munge(expr.unique_name)));
+    codegen::llvm_processor cg_prc{ &expr, module, codegen::compilation_target::eval };
+    if(cg_prc.gen().is_err())
+    {
+      tier.state.store(function_tier_state::failed);
+      return;
+    }
+    __rt_ctx->jit_prc.load_ir_module(std::move(cg_prc.ctx->module),
+                                     std::move(cg_prc.ctx->llvm_ctx));
+
+    for(auto const &arity : expr.arities)
+    {
+      auto const param_count(arity.params.size());
+      auto const fn(__rt_ctx->jit_prc.find_symbol<void *>(
+        util::format("{}_{}", munge(expr.unique_name), param_count)));
+      if(fn.is_err())
+      {
+        tier.state.store(function_tier_state::failed);
+        return;
+      }
+      tier.arities[param_count] = fn.expect_ok();
+    }
+
+    /* Codegen builds closure contexts in this same order. */
+    for(auto const &capture : expr.captures())
+    {
+      tier.captures.emplace_back(capture.first);
+    }
+
+    tier.state.store(function_tier_state::compiled);
+  }
+
+  template <typename T>
+  static void set_arity(T &fn, usize const param_count, void * const f)
+  {
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wcast-function-type-mismatch"
+    switch(param_count)
+    {
+      case 0:
+        fn.arity_0 = reinterpret_cast<decltype(fn.arity_0)>(f);
+        break;
+      case 1:
+        fn.arity_1 = reinterpret_cast<decltype(fn.arity_1)>(f);
+        break;
+      case 2:
+        fn.arity_2 = reinterpret_cast<decltype(fn.arity_2)>(f);
+        break;
+      case 3:
+        fn.arity_3 = reinterpret_cast<decltype(fn.arity_3)>(f);
+        break;
+      case 4:
+        fn.arity_4 = reinterpret_cast<decltype(fn.arity_4)>(f);
+        break;
+      case 5:
+        fn.arity_5 = reinterpret_cast<decltype(fn.arity_5)>(f);
+        break;
+      case 6:
+        fn.arity_6 = reinterpret_cast<decltype(fn.arity_6)>(f);
+        break;
+      case 7:
+        fn.arity_7 = reinterpret_cast<decltype(fn.arity_7)>(f);
+        break;
+      case 8:
+        fn.arity_8 = reinterpret_cast<decltype(fn.arity_8)>(f);
+        break;
+      case 9:
+        fn.arity_9 = reinterpret_cast<decltype(fn.arity_9)>(f);
+        break;
+      case 10:
+        fn.arity_10 = reinterpret_cast<decltype(fn.arity_10)>(f);
+        break;
+      default:
+        break;
+    }
+#pragma clang diagnostic pop
+  }
+
+  /* Builds a compiled instance of the fn, which closes over the same values as the
+   * interpreted one. */
+  static object *instantiate(obj::interpreted_function &fn)
+  {
+    auto const &tier(*fn.tier);
+    object_ref ret;
+    if(tier.captures.empty())
+    {
+      auto const compiled(make_box<obj::jit_function>(tier.arity_flags));
+      for(usize i{}; i < tier.arities.size(); ++i)
+      {
+        set_arity(*compiled, i, tier.arities[i]);
+      }
+      compiled->meta = fn.meta;
+      ret = compiled;
+    }
+    else
+    {
+      auto const context(
+        static_cast<object **>(GC_malloc(sizeof(object *) * tier.captures.size())));
+      for(usize i{}; i < tier.captures.size(); ++i)
+      {
+        context[i] = fn.env->find(tier.captures[i]).erase();
+      }
+
+      auto const compiled(make_box<obj::jit_closure>(tier.arity_flags, context));
+      for(usize i{}; i < tier.arities.size(); ++i)
+      {
+        set_arity(*compiled, i, tier.arities[i]);
+      }
+      compiled->meta = fn.meta;
+      ret = compiled;
+    }
+
+    /* Racing threads may each build an instance, which is fine. Only one is kept. */
+    object *expected{};
+    if(fn.compiled.compare_exchange_strong(expected, ret.erase()))
+    {
+      return ret.erase();
+    }
+    return expected;
+  }
+
+  static void compile_serialized(obj::interpreted_function &fn)
+  {
+    std::lock_guard<std::mutex> const lock{ compile_mutex };
+    try
+    {
+      compile(*fn.expr, *fn.tier);
+    }
+    catch(...)
+    {
+      fn.tier->state.store(function_tier_state::failed);
+    }
+  }
+
+  static void compile_in_background(object_ref const o)
+  {
+    compile_serialized(*expect_object<obj::interpreted_function>(o));
+
+    {
+      std::lock_guard<std::mutex> const lock{ pending_mutex };
+      --pending_compiles;
+    }
+    pending_cv.notify_all();
+  }
+
+  /* A single worker is enough, since compilation is serialized anyway. It's kept apart
+   * from the default pool so that compiling never holds up futures or agents. */
+  static thread_pool &jit_thread_pool()
+  {
+    static thread_pool * const pool{ new(GC) thread_pool{ 1 } };
+    return *pool;
+  }
+
+  void await_background_jit()
+  {
+    std::unique_lock<std::mutex> lock{ pending_mutex };
+    pending_cv.wait(lock, []() { return pending_compiles == 0; });
+  }
+
+  /* Counts a call, or a loop iteration, and returns the compiled fn once it's ready. Until
+   * then, the caller keeps interpreting. */
+  static object *tier_up(obj::interpreted_function &fn)
+  {
+    if(auto const compiled = fn.compiled.load())
+    {
+      return compiled;
+    }
+
+    auto &tier(*fn.tier);
+    switch(tier.state.load())
+    {
+      case function_tier_state::compiled:
+        return instantiate(fn);
+      case function_tier_state::compiling:
+      case function_tier_state::failed:
+        return nullptr;
+      case function_tier_state::interpreted:
+        break;
+    }
+
+    auto const threshold(__rt_ctx->jit_threshold);
+    if(threshold == 0 || tier.calls.fetch_add(1) + 1 < threshold)
+    {
+      return nullptr;
+    }
+
+    /* Only the call which crosses the threshold gets to queue the fn. */
+    auto expected(function_tier_state::interpreted);
+    if(!tier.state.compare_exchange_strong(expected, function_tier_state::compiling))
+    {
+      return nullptr;
+    }
+    tier.module = expect_object<ns>(__rt_ctx->current_ns_var->deref())->to_string();
+
+    /* When compiling files, the same fn expressions are about to be compiled into the
+     * module, so renaming them from another thread isn't an option. */
+    if(__rt_ctx->background_jit && !truthy(__rt_ctx->compile_files_var->deref()))
+    {
+      {
+        std::lock_guard<std::mutex> const lock{ pending_mutex };
+        ++pending_compiles;
+      }
+      jit_thread_pool().submit(&compile_in_background, &fn.base);
+      return nullptr;
+    }
+
+    compile_serialized(fn);
+    if(tier.state.load() != function_tier_state::compiled)
+    {
+      return nullptr;
+    }
+    return instantiate(fn);
+  }
+
+  /* The args have already been packed for the arity, so this calls it directly, rather than
+   * going through dynamic_call. */
+  template <typename T, typename It>
+  static object_ref call_arity(T &fn, It const args, usize const arg_count)
+  {
+    switch(arg_count)
+    {
+      case 0:
+        return fn.call();
+      case 1:
+        return fn.call(args[0]);
+      case 2:
+        return fn.call(args[0], args[1]);
+      case 3:
+        return fn.call(args[0], args[1], args[2]);
+      case 4:
+        return fn.call(args[0], args[1], args[2], args[3]);
+      case 5:
+        return fn.call(args[0], args[1], args[2], args[3], args[4]);
+      case 6:
+        return fn.call(args[0], args[1], args[2], args[3], args[4], args[5]);
+      case 7:
+        return fn.call(args[0], args[1], args[2], args[3], args[4], args[5], args[6]);
+      case 8:
+        return fn.call(args[0], args[1], args[2], args[3], args[4], args[5], args[6], args[7]);
+      case 9:
+        return fn.call(args[0],
+                       args[1],
+                       args[2],
+                       args[3],
+                       args[4],
+                       args[5],
+                       args[6],
+                       args[7],
+                       args[8]);
+      default:
+        return fn.call(args[0],
+                       args[1],
+                       args[2],
+                       args[3],
+                       args[4],
+                       args[5],
+                       args[6],
+                       args[7],
+                       args[8],
+                       args[9]);
+    }
+  }
+
+  template <typename It>
+  static object_ref call_compiled(object * const compiled, It const args, usize const arg_count)
+  {
+    if(compiled->type == object_type::jit_function)
+    {
+      return call_arity(*expect_object<obj::jit_function>(compiled), args, arg_count);
+    }
+    return call_arity(*expect_object<obj::jit_closure>(compiled), args, arg_count);
+  }
+
+  static object_ref dynamic_call_with(object_ref const source,
+                                      native_vector<object_ref> const &args)
+  {
+    switch(args.size())
+    {
+      case 0:
+        return dynamic_call(source);
+      case 1:
+        return dynamic_call(source, args[0]);
+      case 2:
+        return dynamic_call(source, args[0], args[1]);
+      case 3:
+        return dynamic_call(source, args[0], args[1], args[2]);
+      case 4:
+        return dynamic_call(source, args[0], args[1], args[2], args[3]);
+      case 5:
+        return dynamic_call(source, args[0], args[1], args[2], args[3], args[4]);
+      case 6:
+        return dynamic_call(source, args[0], args[1], args[2], args[3], args[4], args[5]);
+      case 7:
+        return dynamic_call(source, args[0], args[1], args[2], args[3], args[4], args[5], args[6]);
+      case 8:
+        return dynamic_call(source,
+                            args[0],
+                            args[1],
+                            args[2],
+                            args[3],
+                            args[4],
+                            args[5],
+                            args[6],
+                            args[7]);
+      case 9:
+        return dynamic_call(source,
+                            args[0],
+                            args[1],
+                            args[2],
+                            args[3],
+                            args[4],
+                            args[5],
+                            args[6],
+                            args[7],
+                            args[8]);
+      case 10:
+        return dynamic_call(source,
+                            args[0],
+                            args[1],
+                            args[2],
+                            args[3],
+                            args[4],
+                            args[5],
+                            args[6],
+                            args[7],
+                            args[8],
+                            args[9]);
+      default:
+        /* The analyzer packs any args past the max params into a list. */
+        return dynamic_call(source,
+                            args[0],
+                            args[1],
+                            args[2],
+                            args[3],
+                            args[4],
+                            args[5],
+                            args[6],
+                            args[7],
+                            args[8],
+                            args[9],
+                            try_object<obj::persistent_list>(args[10]));
+    }
+  }
+
+  namespace
+  {
+    /* The state of interpreting one top-level form or one fn call. */
+    struct interpreter
+    {
+      object_ref eval(expression_ref);
+      object_ref eval(expr::def_ref);
+      object_ref eval(expr::var_deref_ref);
+      object_ref eval(expr::var_ref_ref);
+      object_ref eval(expr::call_ref);
+      object_ref eval(expr::primitive_literal_ref);
+      object_ref eval(expr::list_ref);
+      object_ref eval(expr::vector_ref);
+      object_ref eval(expr::map_ref);
+      object_ref eval(expr::set_ref);
+      object_ref eval(expr::local_reference_ref);
+      object_ref eval(expr::function_ref);
+      object_ref eval(expr::recur_ref);
+      object_ref eval(expr::recursion_reference_ref);
+      object_ref eval(expr::named_recursion_ref);
+      object_ref eval(expr::let_ref);
+      object_ref eval(expr::letfn_ref);
+      object_ref eval(expr::do_ref);
+      object_ref eval(expr::if_ref);
+      object_ref eval(expr::throw_ref);
+      object_ref eval(expr::try_ref);
+      object_ref eval(expr::case_ref);
+
+      environment *env{};
+      /* Recur is always in tail position, so it just stashes the new param values and
+       * unwinds back to the fn call, which starts the arity over. */
+      bool recurring{};
+      native_vector<object_ref> recur_args;
+    };
+
+    object_ref interpreter::eval(expression_ref const ex)
+    {
+      object_ref ret{};
+      visit_expr([this, &ret](auto const typed_ex) { ret = eval(typed_ex); }, ex);
+      return ret;
+    }
+
+    object_ref interpreter::eval(expr::def_ref const expr)
+    {
+      auto var(__rt_ctx->intern_var(expr->name).expect_ok());
+      var->meta = expr->name->meta;
+      object_cache::note_def(var);
+
+      auto const meta(var->meta.unwrap_or(jank_nil));
+      auto const dynamic(get(meta, __rt_ctx->intern_keyword("dynamic").expect_ok()));
+      var->set_dynamic(truthy(dynamic));
+
+      if(expr->value.is_none())
+      {
+        return var;
+      }
+
+      auto const evaluated_value(eval(expr->value.unwrap()));
+      var->bind_root(evaluated_value);
+
+      return var;
+    }
+
+    object_ref interpreter::eval(expr::var_deref_ref const expr)
+    {
+      return expr->var->deref();
+    }
+
+    object_ref interpreter::eval(expr::var_ref_ref const expr)
+    {
+      return expr->var;
+    }
+
+    object_ref interpreter::eval(expr::call_ref const expr)
+    {
+      auto source(eval(expr->source_expr));
+      if(source->type == object_type::var)
+      {
+        source = deref(source);
+      }
+
+      native_vector<object_ref> arg_vals;
+      arg_vals.reserve(expr->arg_exprs.size());
+      for(auto const &arg_expr : expr->arg_exprs)
+      {
+        arg_vals.emplace_back(eval(arg_expr));
+      }
+
+      try
+      {
+        return dynamic_call_with(source, arg_vals);
+      }
+      catch(error_ref const e)
+      {
+        /* We keep the original form from the call expression so we can point
+         * back to it if an exception is thrown during eval. */
+        e->add_usage(object_source(expr->form));
+        throw e;
+      }
+    }
+
+    object_ref interpreter::eval(expr::primitive_literal_ref const expr)
+    {
+      if(expr->data->type == object_type::keyword)
+      {
+        auto const d(expect_object<obj::keyword>(expr->data));
+        return __rt_ctx->intern_keyword(d->sym->ns, d->sym->name).expect_ok();
+      }
+      return expr->data;
+    }
+
+    object_ref interpreter::eval(expr::list_ref const expr)
+    {
+      native_vector<object_ref> ret;
+      ret.reserve(expr->data_exprs.size());
+      for(auto const &e : expr->data_exprs)
+      {
+        ret.emplace_back(eval(e));
+      }
+
+      runtime::detail::native_persistent_list const npl{ ret.rbegin(), ret.rend() };
+      if(expr->meta.is_some())
+      {
+        return make_box<obj::persistent_list>(expr->meta.unwrap(), std::move(npl));
+      }
+      return make_box<obj::persistent_list>(std::move(npl));
+    }
+
+    object_ref interpreter::eval(expr::vector_ref const expr)
+    {
+      runtime::detail::native_transient_vector ret;
+      for(auto const &e : expr->data_exprs)
+      {
+        ret.push_back(eval(e));
+      }
+      if(expr->meta.is_some())
+      {
+        return make_box<obj::persistent_vector>(expr->meta.unwrap(), ret.persistent());
+      }
+      return make_box<obj::persistent_vector>(ret.persistent());
+    }
+
+    object_ref interpreter::eval(expr::map_ref const expr)
+    {
+      auto const size(expr->data_exprs.size());
+      if(size <= obj::persistent_array_map::max_size)
+      {
+        auto const array_box(make_array_box<object_ref>(size * 2llu));
+        usize i{};
+        for(auto const &e : expr->data_exprs)
+        {
+          array_box.data[i++] = eval(e.first);
+          array_box.data[i++] = eval(e.second);
+        }
+
+        if(expr->meta.is_some())
+        {
+          return make_box<obj::persistent_array_map>(expr->meta.unwrap(),
+                                                     runtime::detail::in_place_unique{},
+                                                     array_box,
+                                                     size * 2);
+        }
+        return make_box<obj::persistent_array_map>(runtime::detail::in_place_unique{},
+                                                   array_box,
+                                                   size * 2);
+      }
+
+      runtime::detail::native_transient_hash_map trans;
+      for(auto const &e : expr->data_exprs)
+      {
+        trans.insert({ eval(e.first), eval(e.second) });
+      }
+
+      if(expr->meta.is_some())
+      {
+        return make_box<obj::persistent_hash_map>(expr->meta.unwrap(), trans.persistent());
+      }
+      return make_box<obj::persistent_hash_map>(trans.persistent());
+    }
+
+    object_ref interpreter::eval(expr::set_ref const expr)
+    {
+      runtime::detail::native_transient_hash_set ret;
+      for(auto const &e : expr->data_exprs)
+      {
+        ret.insert(eval(e));
+      }
+      if(expr->meta.is_some())
+      {
+        return make_box<obj::persistent_hash_set>(expr->meta.unwrap(),
+                                                  std::move(ret).persistent());
+      }
+      return make_box<obj::persistent_hash_set>(std::move(ret).persistent());
+    }
+
+    object_ref interpreter::eval(expr::local_reference_ref const expr)
+    {
+      if(!env)
+      {
+        throw std::runtime_error{ util::format("Unable to find local: {}",
+                                               expr->name->to_string()) };
+      }
+      return env->find(expr->name);
+    }
+
+    object_ref interpreter::eval(expr::function_ref const expr)
+    {
+      auto const tier(tier_of(*expr));
+      auto const ret(make_box<obj::interpreted_function>(expr.data, tier, env, tier->arity_flags));
+      ret->meta = tier->meta;
+      return ret;
+    }
+
+    object_ref interpreter::eval(expr::recur_ref const expr)
+    {
+      native_vector<object_ref> args;
+      args.reserve(expr->arg_exprs.size());
+      for(auto const &arg_expr : expr->arg_exprs)
+      {
+        args.emplace_back(eval(arg_expr));
+      }
+      recur_args = std::move(args);
+      recurring = true;
+      return jank_nil;
+    }
+
+    object_ref interpreter::eval(expr::recursion_reference_ref const expr)
+    {
+      return env->find_fn(expr->fn_ctx->fn.data);
+    }
+
+    object_ref interpreter::eval(expr::named_recursion_ref const expr)
+    {
+      auto const fn(env->find_fn(expr->recursion_ref.fn_ctx->fn.data));
+
+      native_vector<object_ref> arg_vals;
+      arg_vals.reserve(expr->arg_exprs.size());
+      for(auto const &arg_expr : expr->arg_exprs)
+      {
+        arg_vals.emplace_back(eval(arg_expr));
+      }
+      return dynamic_call_with(fn, arg_vals);
+    }
+
+    object_ref interpreter::eval(expr::let_ref const expr)
+    {
+      auto const prev(env);
+
+      /* Each binding gets a frame of its own, on top of the ones before it. Fns close over
+       * the frame they're created in, so they must never change. Otherwise, a fn would see
+       * a later binding which shadows one it closed over. */
+      for(auto const &pair : expr->pairs)
+      {
+        auto const value(eval(pair.second));
+        auto const frame(new(GC) environment{});
+        frame->parent = env;
+        frame->locals.emplace_back(pair.first, value);
+        env = frame;
+      }
+
+      auto const ret(eval(expr->body));
+      env = prev;
+      return ret;
+    }
+
+    object_ref interpreter::eval(expr::letfn_ref const expr)
+    {
+      auto const prev(env);
+      auto const frame(new(GC) environment{});
+      frame->parent = prev;
+      frame->locals.reserve(expr->pairs.size());
+      env = frame;
+
+      /* Every fn can see all of the others, so they're all bound before any are created. */
+      for(auto const &pair : expr->pairs)
+      {
+        frame->locals.emplace_back(pair.first, jank_nil);
+      }
+      for(usize i{}; i < expr->pairs.size(); ++i)
+      {
+        frame->locals[i].second = eval(expr->pairs[i].second);
+      }
+
+      auto const ret(eval(expr->body));
+      env = prev;
+      return ret;
+    }
+
+    object_ref interpreter::eval(expr::do_ref const expr)
+    {
+      object_ref ret{ jank_nil };
+      for(auto const &form : expr->values)
+      {
+        ret = eval(form);
+      }
+      return ret;
+    }
+
+    object_ref interpreter::eval(expr::if_ref const expr)
+    {
+      if(truthy(eval(expr->condition)))
+      {
+        return eval(expr->then);
+      }
+      else if(expr->else_.is_some())
+      {
+        return eval(expr->else_.unwrap());
+      }
+      return jank_nil;
+    }
+
+    object_ref interpreter::eval(expr::throw_ref const expr)
+    {
+      throw eval(expr->value);
+    }
+
+    object_ref interpreter::eval(expr::try_ref const expr)
+    {
+      /* Whatever was bound within the body is gone by the time we catch or finally. */
+      auto const prev(env);
+      /* Compiled fns which the body throws through won't restore the current fn. */
+      detail::allocation_fn_scope const fn_scope{ detail::current_allocation_fn };
+      util::scope_exit const finally{ [&]() {
+        if(expr->finally_body)
+        {
+          env = prev;
+          eval(expr->finally_body.unwrap());
+        }
+      } };
+
+      if(!expr->catch_body)
+      {
+        return eval(expr->body);
+      }
+      try
+      {
+        return eval(expr->body);
+      }
+      catch(object_ref const e)
+      {
+        auto const &catch_body(expr->catch_body.unwrap());
+        auto const frame(new(GC) environment{});
+        frame->parent = prev;
+        frame->locals.emplace_back(catch_body.sym, e);
+        env = frame;
+
+        auto const ret(eval(catch_body.body));
+        env = prev;
+        return ret;
+      }
+    }
+
+    object_ref interpreter::eval(expr::case_ref const expr)
+    {
+      auto const value(eval(expr->value_expr));
+      auto const key(jank_shift_mask_case_integer(value.erase(), expr->shift, expr->mask));
+      for(usize i{}; i < expr->keys.size(); ++i)
+      {
+        if(expr->keys[i] == key)
+        {
+          return eval(expr->exprs[i]);
+        }
+      }
+      return eval(expr->default_expr);
+    }
+  }
+
+  object_ref interpret(expression_ref const expr)
+  {
+    profile::timer const timer{ "interpret ast node" };
+    interpreter state;
+    return state.eval(expr);
+  }
+
+  /* Looking up the name isn't free, so it's only done while allocations are sampled. */
+  static char const *allocation_fn_name(obj::interpreted_function const &fn)
+  {
+    if(detail::allocation_sample_interval.load(std::memory_order_relaxed) == 0)
+    {
+      return nullptr;
+    }
+
+    auto const name(get(fn.expr->meta, __rt_ctx->intern_keyword("name").expect_ok()));
+    if(name->type != object_type::persistent_string)
+    {
+      return nullptr;
+    }
+    return expect_object<obj::persistent_string>(name)->data.c_str();
+  }
+
+  object_ref
+  interpret_call(obj::interpreted_function &fn, std::initializer_list<object_ref> const args)
+  {
+    detail::allocation_fn_scope const fn_scope{ allocation_fn_name(fn) };
+    if(auto const compiled = tier_up(fn))
+    {
+      return call_compiled(compiled, args.begin(), args.size());
+    }
+
+    expr::function_arity const *arity{};
+    for(auto const &a : fn.expr->arities)
+    {
+      if(a.params.size() == args.size())
+      {
+        arity = &a;
+        break;
+      }
+    }
+    if(!arity)
+    {
+      throw std::runtime_error{ util::format("invalid call to {} with {} args provided",
+                                             fn.to_string(),
+                                             args.size()) };
+    }
+
+    interpreter state;
+    native_vector<object_ref> params{ args };
+    while(true)
+    {
+      auto const frame(new(GC) environment{});
+      frame->parent = fn.env;
+      frame->fn_expr = fn.expr;
+      frame->fn = &fn.base;
+      frame->locals.reserve(params.size());
+      for(usize i{}; i < params.size(); ++i)
+      {
+        frame->locals.emplace_back(arity->params[i], params[i]);
+      }
+      state.env = frame;
+
+      auto const ret(state.eval(arity->body));
+      if(!state.recurring)
+      {
+        return ret;
+      }
+
+      state.recurring = false;
+      params = std::move(state.recur_args);
+      state.recur_args.clear();
+
+      /* A loop which spins for a while is as hot as a fn which is called a lot. Recur
+       * starts the arity over, which is just what calling the compiled fn does. */
+      if(auto const compiled = tier_up(fn))
+      {
+        return call_compiled(compiled, params.begin(), params.size());
+      }
+    }
+  }
+}
@@ -0,0 +1,206 @@
+#include <algorithm>
+#include <filesystem>
+#include <mutex>
+
+#include <unistd.h>
+
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/ns.hpp>
+#include <jank/runtime/core.hpp>
+#include <jank/runtime/core/munge.hpp>
+#include <jank/runtime/core/seq.hpp>
+#include <jank/runtime/rtti.hpp>
+#include <jank/codegen/llvm_processor.hpp>
+#include <jank/jit/processor.hpp>
+#include <jank/evaluate/object_cache.hpp>
+#include <jank/analyze/visit.hpp>
+#include <jank/profile/time.hpp>
+#include <jank/util/sha256.hpp>
+#include <jank/util/string_builder.hpp>
+#include <jank/util/fmt.hpp>
+
+namespace jank::evaluate::object_cache
+{
+  using namespace jank::runtime;
+  using namespace jank::analyze;
+
+  using entry_fn = object *(*)();
+
+  static thread_local form_scope *current_form{};
+
+  /* Every object is only loaded once per process, since loading it again would define its
+   * symbols again. Evaluating the same form again just calls the loaded fn again. */
+  static std::mutex loaded_mutex;
+  static native_unordered_map<jtl::immutable_string, entry_fn> loaded;
+
+  static void add_var(var_ref const var, native_vector<var_ref> &vars)
+  {
+    if(std::ranges::none_of(vars, [&](var_ref const v) { return v.data == var.data; }))
+    {
+      vars.emplace_back(var);
+    }
+  }
+
+  static void collect_vars(object_ref const form, native_vector<var_ref> &vars)
+  {
+    if(form->type == object_type::symbol)
+    {
+      auto const var(__rt_ctx->find_var(expect_object<obj::symbol>(form)));
+      if(var.is_some())
+      {
+        add_var(var, vars);
+      }
+    }
+    else if(is_collection(form))
+    {
+      for(auto it(fresh_seq(form)); it.is_some(); it = next_in_place(it))
+      {
+        collect_vars(first(it), vars);
+      }
+    }
+  }
+
+  static jtl::immutable_string
+  form_key(object_ref const form, native_persistent_string_view const &source, form_scope &scope)
+  {
+    profile::timer const timer{ "jit cache key" };
+    auto &vars(scope.deps);
+    collect_vars(form, vars);
+
+    /* A var's own form_key was built from its deps as they were when it was defined, so
+     * we follow them again here to pick up anything which has been redefined since. The
+     * vector grows as we go and already seen vars aren't added again, so cycles end. */
+    for(usize i{}; i < vars.size(); ++i)
+    {
+      for(auto const &dep : vars[i]->form_deps)
+      {
+        add_var(dep, vars);
+      }
+    }
+
+    util::string_builder sb;
+    sb(__rt_ctx->binary_cache_dir)('\n');
+    sb(expect_object<ns>(__rt_ctx->current_ns_var->deref())->name->name)('\n');
+    sb(source)('\n');
+    for(auto const &var : vars)
+    {
+      sb(var->n->name->name)('/')(var->name->name)('=')(var->form_key)('\n');
+    }
+    return util::sha256(sb.release());
+  }
+
+  form_scope::form_scope()
+    : prev{ current_form }
+  {
+    current_form = this;
+  }
+
+  form_scope::form_scope(object_ref const form, native_persistent_string_view const &source)
+    : prev{ current_form }
+  {
+    if(__rt_ctx->jit_cache)
+    {
+      key = form_key(form, source, *this);
+    }
+    current_form = this;
+  }
+
+  form_scope::~form_scope()
+  {
+    current_form = prev;
+  }
+
+  bool caching()
+  {
+    return current_form && !current_form->key.empty();
+  }
+
+  void note_def(var_ref const var)
+  {
+    if(current_form)
+    {
+      var->form_key = current_form->key;
+      var->form_deps = current_form->deps;
+    }
+  }
+
+  jtl::option<object_ref>
+  eval(expr::function_ref const wrapped, jtl::immutable_string const &module)
+  {
+    if(!caching())
+    {
+      return none;
+    }
+
+    auto const key(util::format("{}_{}", current_form->key, current_form->compiles++));
+    auto const name(util::format("jank_cached_{}", key));
+    entry_fn fn{};
+    {
+      std::lock_guard<std::mutex> const lock{ loaded_mutex };
+      auto const found(loaded.find(key));
+      if(found != loaded.end())
+      {
+        fn = found->second;
+      }
+    }
+    if(fn)
+    {
+      return fn();
+    }
+
+    profile::timer const timer{ util::format("jit cache {}", key) };
+    std::filesystem::path const path{
+      util::format("{}/forms/{}.o", __rt_ctx->binary_cache_dir, key)
+    };
+    if(!std::filesystem::exists(path))
+    {
+      /* The symbols need to be the same in every process which loads this object, so
+       * they're named after the key, in the order the fns are nested. */
+      usize fn_count{};
+      walk_expr(wrapped, [&](auto const typed_expr) {
+        using T = typename decltype(typed_expr)::value_type;
+
+        if constexpr(std::same_as<T, expr::function>)
+        {
+          typed_expr->unique_name = util::format("{}_{}", name, fn_count++);
+        }
+      });
+
+      codegen::llvm_processor cg_prc{ wrapped, module, codegen::compilation_target::eval };
+      cg_prc.ctx->ctor_name = util::format("{}_init", name);
+      cg_prc.gen().expect_ok();
+
+      /* Processes may share the cache, so the object only shows up once it's complete. */
+      std::filesystem::path tmp_path{ path };
+      tmp_path += util::format(".{}.tmp", getpid()).c_str();
+      auto const res(__rt_ctx->write_object(tmp_path, cg_prc.ctx->module));
+      if(res.is_err())
+      {
+        return none;
+      }
+      std::filesystem::rename(tmp_path, path);
+    }
+
+    {
+      std::lock_guard<std::mutex> const lock{ loaded_mutex };
+      auto const found(loaded.find(key));
+      if(found != loaded.end())
+      {
+        fn = found->second;
+      }
+      else
+      {
+        auto &jit_prc(__rt_ctx->jit_prc);
+        jit_prc.load_object(path.native());
+
+        /* Objects don't run their global ctors when they're loaded, so we do it ourselves. */
+        jit_prc.find_symbol<void (*)()>(util::format("{}_init", name)).expect_ok()();
+        fn = jit_prc.find_symbol<entry_fn>(util::format("{}_0_0", name)).expect_ok();
+        loaded.emplace(key, fn);
+      }
+    }
+
+    /* The fn may evaluate more forms, so it's called without the lock. */
+    return fn();
+  }
+}
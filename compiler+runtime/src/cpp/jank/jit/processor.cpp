@@ -153,6 +153,7 @@ namespace jank::jit
 
   void processor::eval_string(jtl::immutable_string const &s) const
   {
+    std::lock_guard<std::recursive_mutex> const lock{ mutex };
     profile::timer const timer{ "jit eval_string" };
     //util::println("// eval_string:\n{}\n", s);
     auto err(interpreter->ParseAndExecute({ s.data(), s.size() }));
@@ -161,6 +162,7 @@ namespace jank::jit
 
   void processor::load_object(native_persistent_string_view const &path) const
   {
+    std::lock_guard<std::recursive_mutex> const lock{ mutex };
     auto &ee{ interpreter->getExecutionEngine().get() };
     auto file{ llvm::MemoryBuffer::getFile(path) };
     if(!file)
@@ -177,6 +179,7 @@ namespace jank::jit
   void processor::load_ir_module(std::unique_ptr<llvm::Module> m,
                                  std::unique_ptr<llvm::LLVMContext> llvm_ctx) const
   {
+    std::lock_guard<std::recursive_mutex> const lock{ mutex };
     profile::timer const timer{ util::format("jit ir module {}",
                                              static_cast<std::string_view>(m->getName())) };
     //m->print(llvm::outs(), nullptr);
@@ -218,6 +221,7 @@ namespace jank::jit
 
   jtl::string_result<void> processor::remove_symbol(jtl::immutable_string const &name) const
   {
+    std::lock_guard<std::recursive_mutex> const lock{ mutex };
     auto &ee{ interpreter->getExecutionEngine().get() };
     llvm::orc::SymbolNameSet to_remove{};
     to_remove.insert(ee.mangleAndIntern(name.c_str()));
@@ -282,6 +286,7 @@ namespace jank::jit
 
   void processor::load_dynamic_library(jtl::immutable_string const &path) const
   {
+    std::lock_guard<std::recursive_mutex> const lock{ mutex };
     llvm::cantFail(interpreter->LoadDynamicLibrary(path.data()));
   }
 }
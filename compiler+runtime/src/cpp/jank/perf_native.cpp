@@ -23,6 +23,10 @@ jank_object_ref jank_load_jank_perf_native()
           make_box(obj::symbol{ __rt_ctx->current_ns()->to_string(), name }.to_string())))));
   });
   intern_fn("benchmark", &perf::benchmark);
+  intern_fn("gc-stats", &perf::gc_stats);
+  intern_fn("sample-allocations!", &perf::sample_allocations);
+  intern_fn("allocation-sites", &perf::allocation_sites);
+  intern_fn("clear-allocation-sites!", &perf::clear_allocation_sites);
 
   return jank_nil.erase();
 }
@@ -1,7 +1,9 @@
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
 
 #include <jank/read/lex.hpp>
+#include <jank/read/scan.hpp>
 #include <jank/error/lex.hpp>
 #include <jank/runtime/object.hpp>
 #include <jank/runtime/context.hpp>
@@ -338,10 +340,29 @@ namespace jank::read::lex
 
   movable_position &movable_position::operator+=(usize const count)
   {
-    for(usize i{}; i < count; ++i)
+    /* Short moves, like peeking ahead, aren't worth the setup of a scan. */
+    static constexpr usize scan_threshold{ 16 };
+    if(count < scan_threshold)
     {
-      ++(*this);
+      for(usize i{}; i < count; ++i)
+      {
+        ++(*this);
+      }
+      return *this;
+    }
+
+    jank_debug_assert(offset + count <= proc->file.size());
+    auto const found(scan::find_newlines(proc->file.data() + offset, count));
+    if(found.count == 0)
+    {
+      col += count;
     }
+    else
+    {
+      line += found.count;
+      col = count - found.last;
+    }
+    offset += count;
     return *this;
   }
 
@@ -358,10 +379,7 @@ namespace jank::read::lex
   movable_position movable_position::operator+(usize const count) const
   {
     movable_position ret{ *this };
-    for(usize i{}; i < count; ++i)
-    {
-      ++ret;
-    }
+    ret += count;
     return ret;
   }
 
@@ -419,6 +437,13 @@ namespace jank::read::lex
   static jtl::result<codepoint, error_ref>
   convert_to_codepoint(native_persistent_string_view const sv, movable_position const &pos)
   {
+    /* ASCII is the same in every locale we support, so there's nothing to decode. The null
+     * char is left to mbrtowc, which gives it a length of zero. */
+    if(auto const c(static_cast<unsigned char>(sv[0])); c != 0 && c < 0x80)
+    {
+      return ok(codepoint{ c, 1 });
+    }
+
     std::mbstate_t state{};
     wchar_t wc{};
     auto const len{ std::mbrtowc(&wc, sv.data(), sv.size(), &state) };
@@ -515,20 +540,18 @@ namespace jank::read::lex
   {
     /* Skip whitespace. */
     bool found_space{};
-    while(true)
+    if(pos.offset < file.size())
     {
-      if(pos.offset >= file.size())
+      auto const skipped(scan::whitespace(file.data() + pos.offset, file.size() - pos.offset));
+      if(skipped != 0)
       {
-        return ok(token{ pos, token_kind::eof });
+        found_space = true;
+        pos += skipped;
       }
-
-      if(auto const c(file[pos.offset]); std::isspace(c) == 0 && c != ',')
-      {
-        break;
-      }
-
-      found_space = true;
-      ++pos;
+    }
+    if(pos.offset >= file.size())
+    {
+      return ok(token{ pos, token_kind::eof });
     }
 
     /* Whether or not we've found the r in radix-specific integers such as 2r01010. */
@@ -597,41 +620,16 @@ namespace jank::read::lex
       case ';':
         {
           usize leading_semis{ 1 };
-          bool hit_non_semi{};
-          while(true)
-          {
-            auto const oc(peek());
-            if(oc.is_err())
-            {
-              break;
-            }
-            auto const c(oc.expect_ok().character);
-            if(c == '\n')
-            {
-              break;
-            }
-            else if(c == ';' && !hit_non_semi)
-            {
-              ++leading_semis;
-            }
-            else
-            {
-              hit_non_semi = true;
-            }
-
-            ++pos;
-          }
-          if(pos == token_start)
+          while(token_start.offset + leading_semis < file.size()
+                && file[token_start.offset + leading_semis] == ';')
           {
-            return ok(token{ token_start, ++pos, token_kind::comment, ""sv });
-          }
-          else
-          {
-            ++pos;
-            native_persistent_string_view const comment{ file.data() + token_start + leading_semis,
-                                                         pos - token_start - leading_semis };
-            return ok(token{ token_start, pos, token_kind::comment, comment });
+            ++leading_semis;
           }
+
+          pos += comment_end(token_start.offset + leading_semis) - pos.offset;
+          native_persistent_string_view const comment{ file.data() + token_start + leading_semis,
+                                                       pos - token_start - leading_semis };
+          return ok(token{ token_start, pos, token_kind::comment, comment });
         }
         /* Numbers. */
       case '-':
@@ -1063,6 +1061,7 @@ namespace jank::read::lex
           {
             return err(std::move(e.unwrap()));
           }
+          skip_symbol_chars();
           while(true)
           {
             auto const oc(peek());
@@ -1077,6 +1076,7 @@ namespace jank::read::lex
               break;
             }
             pos += size;
+            skip_symbol_chars();
           }
           require_space = true;
           native_persistent_string_view const name{ file.data() + token_start,
@@ -1125,6 +1125,7 @@ namespace jank::read::lex
             ++pos;
           }
 
+          skip_symbol_chars();
           while(true)
           {
             auto const oc(peek());
@@ -1139,6 +1140,7 @@ namespace jank::read::lex
               break;
             }
             pos += codepoint.len;
+            skip_symbol_chars();
           }
           require_space = true;
           native_persistent_string_view const name{ file.data() + token_start + 1,
@@ -1169,6 +1171,12 @@ namespace jank::read::lex
           bool escaped{}, contains_escape{};
           while(true)
           {
+            /* Everything up to the next quote, or escape, can be skipped in bulk. */
+            if(!escaped && pos.offset + 1 < file.size())
+            {
+              pos += scan::string(file.data() + pos.offset + 1, file.size() - pos.offset - 1);
+            }
+
             auto const oc(peek());
             if(oc.is_err())
             {
@@ -1273,23 +1281,7 @@ namespace jank::read::lex
               }
             case '!':
               {
-                while(true)
-                {
-                  auto const oc(peek());
-                  if(oc.is_err())
-                  {
-                    break;
-                  }
-                  auto const c(oc.expect_ok().character);
-                  if(c == '\n')
-                  {
-                    break;
-                  }
-
-                  ++pos;
-                }
-
-                ++pos;
+                pos += comment_end(pos.offset + 1) - pos.offset;
                 if(pos == token_start + 2llu)
                 {
                   return ok(token{ token_start, pos, token_kind::comment, ""sv });
@@ -1402,4 +1394,34 @@ namespace jank::read::lex
     auto const oc{ convert_to_codepoint(file.substr(peek_pos), peek_pos) };
     return oc;
   }
+
+  usize processor::comment_end(usize offset) const
+  {
+    /* ASCII is skipped in bulk. Anything else is decoded, so invalid UTF-8 still ends the
+     * comment. */
+    while(offset < file.size())
+    {
+      offset += scan::comment(file.data() + offset, file.size() - offset);
+      if(offset >= file.size() || file[offset] == '\n')
+      {
+        break;
+      }
+
+      auto const oc(convert_to_codepoint(file.substr(offset), pos));
+      if(oc.is_err())
+      {
+        break;
+      }
+      offset += std::max<usize>(oc.expect_ok().len, 1);
+    }
+    return offset;
+  }
+
+  void processor::skip_symbol_chars()
+  {
+    if(pos.offset + 1 < file.size())
+    {
+      pos += scan::symbol(file.data() + pos.offset + 1, file.size() - pos.offset - 1);
+    }
+  }
 }
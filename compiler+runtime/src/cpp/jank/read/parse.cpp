@@ -13,9 +13,9 @@
 #include <jank/runtime/behavior/set_like.hpp>
 #include <jank/runtime/sequence_range.hpp>
 #include <jank/util/scope_exit.hpp>
+#include <jank/util/arena.hpp>
 #include <jank/util/fmt.hpp>
 
-/* TODO: Make common symbol boxes once and reuse those. */
 namespace jank::read::parse
 {
   using namespace jank::runtime;
@@ -140,6 +140,8 @@ namespace jank::read::parse
                               make_box<obj::symbol>("*splicing-allowed?*"),
                               jank_false)
                               ->set_dynamic(true) }
+    , splicing_allowed_bindings{ obj::persistent_hash_map::create_unique(
+        std::make_pair(splicing_allowed_var, jank_true)) }
   {
   }
 
@@ -281,13 +283,11 @@ namespace jank::read::parse
     auto const prev_expected_closer(expected_closer);
     expected_closer = some(lex::token_kind::close_paren);
 
-    __rt_ctx
-      ->push_thread_bindings(
-        obj::persistent_hash_map::create_unique(std::make_pair(splicing_allowed_var, jank_true)))
-      .expect_ok();
+    __rt_ctx->push_thread_bindings(splicing_allowed_bindings).expect_ok();
     util::scope_exit const finally{ [] { __rt_ctx->pop_thread_bindings().expect_ok(); } };
+    util::arena::scope const scratch{ arena };
 
-    runtime::detail::native_transient_vector ret;
+    util::arena_vector<runtime::object_ref> ret{ arena };
     for(auto it(begin()); it != end(); ++it)
     {
       if(it.latest.unwrap().is_err())
@@ -319,10 +319,7 @@ namespace jank::read::parse
     auto const prev_expected_closer(expected_closer);
     expected_closer = some(lex::token_kind::close_square_bracket);
 
-    __rt_ctx
-      ->push_thread_bindings(
-        obj::persistent_hash_map::create_unique(std::make_pair(splicing_allowed_var, jank_true)))
-      .expect_ok();
+    __rt_ctx->push_thread_bindings(splicing_allowed_bindings).expect_ok();
     util::scope_exit const finally{ [] { __rt_ctx->pop_thread_bindings().expect_ok(); } };
 
     runtime::detail::native_transient_vector ret;
@@ -354,12 +351,10 @@ namespace jank::read::parse
     auto const prev_expected_closer(expected_closer);
     expected_closer = some(lex::token_kind::close_curly_bracket);
 
-    __rt_ctx
-      ->push_thread_bindings(
-        obj::persistent_hash_map::create_unique(std::make_pair(splicing_allowed_var, jank_true)))
-      .expect_ok();
+    __rt_ctx->push_thread_bindings(splicing_allowed_bindings).expect_ok();
     util::scope_exit const finally{ [] { __rt_ctx->pop_thread_bindings().expect_ok(); } };
-    native_vector<processor::object_result> const items(begin(), end());
+    util::arena::scope const scratch{ arena };
+    util::arena_vector<processor::object_result> const items(begin(), end(), arena);
 
     if(expected_closer.is_some())
     {
@@ -368,7 +363,10 @@ namespace jank::read::parse
 
     expected_closer = prev_expected_closer;
 
-    native_unordered_map<runtime::object_ref, object_source_info> parsed_keys{};
+    util::arena_unordered_map<runtime::object_ref, object_source_info> parsed_keys{
+      items.size() / 2,
+      arena
+    };
 
     auto const build_map([&](auto &map) -> jtl::result<void, error_ref> {
       using T = std::remove_reference_t<decltype(map)>;
@@ -514,7 +512,7 @@ namespace jank::read::parse
       return error::parse_invalid_character(start_token);
     }
 
-    return object_source_info{ make_box<obj::character>(character.unwrap()),
+    return object_source_info{ make_box(character.unwrap()),
                                start_token,
                                start_token };
   }
@@ -542,6 +540,15 @@ namespace jank::read::parse
                                      start_token,
                                      latest_token };
         }
+        /* Type hints, such as ^long, are shorthand for {:tag long}. */
+        if constexpr(std::same_as<T, obj::symbol> || std::same_as<T, obj::persistent_string>)
+        {
+          return object_source_info{ obj::persistent_array_map::create_unique(
+                                       __rt_ctx->intern_keyword("tag").expect_ok(),
+                                       typed_val),
+                                     start_token,
+                                     latest_token };
+        }
         if constexpr(behavior::map_like<T>)
         {
           return object_source_info{ typed_val, start_token, latest_token };
@@ -636,13 +643,11 @@ namespace jank::read::parse
     auto const prev_expected_closer(expected_closer);
     expected_closer = some(lex::token_kind::close_curly_bracket);
 
-    __rt_ctx
-      ->push_thread_bindings(
-        obj::persistent_hash_map::create_unique(std::make_pair(splicing_allowed_var, jank_true)))
-      .expect_ok();
+    __rt_ctx->push_thread_bindings(splicing_allowed_bindings).expect_ok();
     util::scope_exit const finally{ [] { __rt_ctx->pop_thread_bindings().expect_ok(); } };
+    util::arena::scope const scratch{ arena };
 
-    native_unordered_map<runtime::object_ref, object_source_info> parsed_items{};
+    util::arena_unordered_map<runtime::object_ref, object_source_info> parsed_items{ 0, arena };
     runtime::detail::native_transient_hash_set ret;
     for(auto it(begin()); it != end(); ++it)
     {
@@ -1371,11 +1376,15 @@ namespace jank::read::parse
         name = name + "#";
       }
     }
-    return object_source_info{
-      make_box<obj::symbol>(source_to_meta(start_token.start, latest_token.end), ns, name),
-      start_token,
-      start_token
-    };
+    auto const meta(source_to_meta(start_token.start, latest_token.end));
+    if(__rt_ctx->intern_symbols)
+    {
+      /* Copying the canonical symbol keeps its hash and lets equality skip the strings. */
+      auto const sym(make_box<obj::symbol>(*__rt_ctx->intern_symbol(ns, name)));
+      sym->meta = meta;
+      return object_source_info{ sym, start_token, start_token };
+    }
+    return object_source_info{ make_box<obj::symbol>(meta, ns, name), start_token, start_token };
   }
 
   processor::object_result processor::parse_keyword()
@@ -1419,7 +1428,7 @@ namespace jank::read::parse
   {
     auto const token(token_current->expect_ok());
     ++token_current;
-    return object_source_info{ make_box<obj::integer>(std::get<i64>(token.data)), token, token };
+    return object_source_info{ make_box(std::get<i64>(token.data)), token, token };
   }
 
   processor::object_result processor::parse_big_integer()
@@ -0,0 +1,375 @@
+#include <atomic>
+#include <bit>
+
+#if defined(__x86_64__)
+  #include <immintrin.h>
+#endif
+
+#include <jank/read/scan.hpp>
+
+namespace jank::read::lex::scan
+{
+  /* Each class is defined once, for a single byte, and then again for each vector width.
+   * The vector versions give a mask with a set bit for each byte which is within the run. */
+
+  /* Whether char is signed depends on the platform, so we don't rely on it. */
+  static bool is_ascii(char const c)
+  {
+    return static_cast<unsigned char>(c) < 0x80;
+  }
+
+  static bool is_whitespace(char const c)
+  {
+    return c == ' ' || c == ',' || (c >= '\t' && c <= '\r');
+  }
+
+  static bool is_comment(char const c)
+  {
+    return is_ascii(c) && c != '\n';
+  }
+
+  static bool is_special(char const c)
+  {
+    return c == '(' || c == ')' || c == '{' || c == '}' || c == '[' || c == ']' || c == '"'
+      || c == '^' || c == '\\' || c == '`' || c == '~' || c == ',' || c == ';';
+  }
+
+  /* Alphanumerics and a handful of punctuation. This must be exactly the ASCII part of
+   * is_symbol_char in the lexer. */
+  static bool is_symbol(char const c)
+  {
+    return (c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z')
+      || c == '_' || c == '-' || c == '/' || c == '?' || c == '!' || c == '+' || c == '*'
+      || c == '=' || c == '.' || c == '&' || c == '<' || c == '>' || c == '#' || c == '%';
+  }
+
+  static bool is_string(char const c)
+  {
+    return is_ascii(c) && c != 0 && c != '"' && c != '\\';
+  }
+
+  template <bool (*Pred)(char)>
+  static usize scalar_run(char const * const data, usize const size)
+  {
+    usize i{};
+    while(i < size && Pred(data[i]))
+    {
+      ++i;
+    }
+    return i;
+  }
+
+  static newlines scalar_newlines(char const * const data, usize const size)
+  {
+    newlines ret;
+    for(usize i{}; i < size; ++i)
+    {
+      if(data[i] == '\n')
+      {
+        ++ret.count;
+        ret.last = i;
+      }
+    }
+    return ret;
+  }
+
+#if defined(__x86_64__)
+  /* SSE2 is part of x86_64, so these need no dispatch. */
+  static __m128i sse2_set(char const c)
+  {
+    return _mm_set1_epi8(c);
+  }
+
+  static __m128i sse2_eq(__m128i const x, char const c)
+  {
+    return _mm_cmpeq_epi8(x, sse2_set(c));
+  }
+
+  static u32 sse2_whitespace(__m128i const x)
+  {
+    /* \t through \r are contiguous, so one unsigned range check covers them. */
+    auto const offset(_mm_sub_epi8(x, sse2_set('\t')));
+    auto const control(_mm_cmpeq_epi8(_mm_min_epu8(offset, sse2_set('\r' - '\t')), offset));
+    auto const match(_mm_or_si128(_mm_or_si128(sse2_eq(x, ' '), sse2_eq(x, ',')), control));
+    return static_cast<u32>(_mm_movemask_epi8(match));
+  }
+
+  static u32 sse2_comment(__m128i const x)
+  {
+    /* Bytes are signed, so anything past ASCII is negative. */
+    auto const ascii(_mm_cmpgt_epi8(x, sse2_set(-1)));
+    return static_cast<u32>(_mm_movemask_epi8(_mm_andnot_si128(sse2_eq(x, '\n'), ascii)));
+  }
+
+  /* Whether each byte is within [lo, hi], as an unsigned range check. */
+  static __m128i sse2_in_range(__m128i const x, char const lo, char const hi)
+  {
+    auto const offset(_mm_sub_epi8(x, sse2_set(lo)));
+    return _mm_cmpeq_epi8(_mm_min_epu8(offset, sse2_set(static_cast<char>(hi - lo))), offset);
+  }
+
+  static u32 sse2_symbol(__m128i const x)
+  {
+    auto match(_mm_or_si128(sse2_in_range(x, '0', '9'), sse2_in_range(x, 'A', 'Z')));
+    match = _mm_or_si128(match, sse2_in_range(x, 'a', 'z'));
+    match = _mm_or_si128(match, _mm_or_si128(sse2_eq(x, '_'), sse2_eq(x, '-')));
+    match = _mm_or_si128(match, _mm_or_si128(sse2_eq(x, '/'), sse2_eq(x, '?')));
+    match = _mm_or_si128(match, _mm_or_si128(sse2_eq(x, '!'), sse2_eq(x, '+')));
+    match = _mm_or_si128(match, _mm_or_si128(sse2_eq(x, '*'), sse2_eq(x, '=')));
+    match = _mm_or_si128(match, _mm_or_si128(sse2_eq(x, '.'), sse2_eq(x, '&')));
+    match = _mm_or_si128(match, _mm_or_si128(sse2_eq(x, '<'), sse2_eq(x, '>')));
+    match = _mm_or_si128(match, _mm_or_si128(sse2_eq(x, '#'), sse2_eq(x, '%')));
+    return static_cast<u32>(_mm_movemask_epi8(match));
+  }
+
+  static u32 sse2_string(__m128i const x)
+  {
+    auto const ascii(_mm_cmpgt_epi8(x, _mm_setzero_si128()));
+    auto const stop(_mm_or_si128(sse2_eq(x, '"'), sse2_eq(x, '\\')));
+    return static_cast<u32>(_mm_movemask_epi8(_mm_andnot_si128(stop, ascii)));
+  }
+
+  template <u32 (*Mask)(__m128i), bool (*Pred)(char)>
+  static usize sse2_run(char const * const data, usize const size)
+  {
+    static constexpr u32 all{ 0xFFFF };
+    usize i{};
+    for(; i + 16 <= size; i += 16)
+    {
+      auto const mask(Mask(_mm_loadu_si128(reinterpret_cast<__m128i const *>(data + i))));
+      if(mask != all)
+      {
+        return i + static_cast<usize>(std::countr_one(mask));
+      }
+    }
+    return i + scalar_run<Pred>(data + i, size - i);
+  }
+
+  static newlines sse2_newlines(char const * const data, usize const size)
+  {
+    newlines ret;
+    usize i{};
+    for(; i + 16 <= size; i += 16)
+    {
+      auto const x(_mm_loadu_si128(reinterpret_cast<__m128i const *>(data + i)));
+      auto const mask(static_cast<u32>(_mm_movemask_epi8(sse2_eq(x, '\n'))));
+      if(mask != 0)
+      {
+        ret.count += static_cast<usize>(std::popcount(mask));
+        ret.last = i + 31 - static_cast<usize>(std::countl_zero(mask));
+      }
+    }
+    auto const tail(scalar_newlines(data + i, size - i));
+    if(tail.count != 0)
+    {
+      ret.count += tail.count;
+      ret.last = i + tail.last;
+    }
+    return ret;
+  }
+
+  /* AVX2 isn't always there, so these are compiled for it separately and are only called
+   * once we know the CPU supports it. */
+  #define JANK_AVX2 __attribute__((target("avx2")))
+
+  JANK_AVX2 static __m256i avx2_set(char const c)
+  {
+    return _mm256_set1_epi8(c);
+  }
+
+  JANK_AVX2 static __m256i avx2_eq(__m256i const x, char const c)
+  {
+    return _mm256_cmpeq_epi8(x, avx2_set(c));
+  }
+
+  JANK_AVX2 static u32 avx2_whitespace(__m256i const x)
+  {
+    auto const offset(_mm256_sub_epi8(x, avx2_set('\t')));
+    auto const control(
+      _mm256_cmpeq_epi8(_mm256_min_epu8(offset, avx2_set('\r' - '\t')), offset));
+    auto const match(
+      _mm256_or_si256(_mm256_or_si256(avx2_eq(x, ' '), avx2_eq(x, ',')), control));
+    return static_cast<u32>(_mm256_movemask_epi8(match));
+  }
+
+  JANK_AVX2 static u32 avx2_comment(__m256i const x)
+  {
+    auto const ascii(_mm256_cmpgt_epi8(x, avx2_set(-1)));
+    return static_cast<u32>(_mm256_movemask_epi8(_mm256_andnot_si256(avx2_eq(x, '\n'), ascii)));
+  }
+
+  JANK_AVX2 static __m256i avx2_in_range(__m256i const x, char const lo, char const hi)
+  {
+    auto const offset(_mm256_sub_epi8(x, avx2_set(lo)));
+    return _mm256_cmpeq_epi8(_mm256_min_epu8(offset, avx2_set(static_cast<char>(hi - lo))),
+                             offset);
+  }
+
+  JANK_AVX2 static u32 avx2_symbol(__m256i const x)
+  {
+    auto match(_mm256_or_si256(avx2_in_range(x, '0', '9'), avx2_in_range(x, 'A', 'Z')));
+    match = _mm256_or_si256(match, avx2_in_range(x, 'a', 'z'));
+    match = _mm256_or_si256(match, _mm256_or_si256(avx2_eq(x, '_'), avx2_eq(x, '-')));
+    match = _mm256_or_si256(match, _mm256_or_si256(avx2_eq(x, '/'), avx2_eq(x, '?')));
+    match = _mm256_or_si256(match, _mm256_or_si256(avx2_eq(x, '!'), avx2_eq(x, '+')));
+    match = _mm256_or_si256(match, _mm256_or_si256(avx2_eq(x, '*'), avx2_eq(x, '=')));
+    match = _mm256_or_si256(match, _mm256_or_si256(avx2_eq(x, '.'), avx2_eq(x, '&')));
+    match = _mm256_or_si256(match, _mm256_or_si256(avx2_eq(x, '<'), avx2_eq(x, '>')));
+    match = _mm256_or_si256(match, _mm256_or_si256(avx2_eq(x, '#'), avx2_eq(x, '%')));
+    return static_cast<u32>(_mm256_movemask_epi8(match));
+  }
+
+  JANK_AVX2 static u32 avx2_string(__m256i const x)
+  {
+    auto const ascii(_mm256_cmpgt_epi8(x, _mm256_setzero_si256()));
+    auto const stop(_mm256_or_si256(avx2_eq(x, '"'), avx2_eq(x, '\\')));
+    return static_cast<u32>(_mm256_movemask_epi8(_mm256_andnot_si256(stop, ascii)));
+  }
+
+  template <u32 (*Mask)(__m256i), u32 (*Mask128)(__m128i), bool (*Pred)(char)>
+  JANK_AVX2 static usize avx2_run(char const * const data, usize const size)
+  {
+    static constexpr u32 all{ 0xFFFFFFFF };
+    usize i{};
+    for(; i + 32 <= size; i += 32)
+    {
+      auto const mask(Mask(_mm256_loadu_si256(reinterpret_cast<__m256i const *>(data + i))));
+      if(mask != all)
+      {
+        return i + static_cast<usize>(std::countr_one(mask));
+      }
+    }
+    return i + sse2_run<Mask128, Pred>(data + i, size - i);
+  }
+
+  JANK_AVX2 static newlines avx2_newlines(char const * const data, usize const size)
+  {
+    newlines ret;
+    usize i{};
+    for(; i + 32 <= size; i += 32)
+    {
+      auto const x(_mm256_loadu_si256(reinterpret_cast<__m256i const *>(data + i)));
+      auto const mask(static_cast<u32>(_mm256_movemask_epi8(avx2_eq(x, '\n'))));
+      if(mask != 0)
+      {
+        ret.count += static_cast<usize>(std::popcount(mask));
+        ret.last = i + 31 - static_cast<usize>(std::countl_zero(mask));
+      }
+    }
+    auto const tail(sse2_newlines(data + i, size - i));
+    if(tail.count != 0)
+    {
+      ret.count += tail.count;
+      ret.last = i + tail.last;
+    }
+    return ret;
+  }
+
+  #undef JANK_AVX2
+#endif
+
+  struct scanners
+  {
+    isa which{};
+    usize (*whitespace)(char const *, usize){};
+    usize (*comment)(char const *, usize){};
+    usize (*symbol)(char const *, usize){};
+    usize (*string)(char const *, usize){};
+    newlines (*find_newlines)(char const *, usize){};
+  };
+
+  static constexpr scanners scalar_scanners{ isa::scalar,
+                                             &scalar_run<is_whitespace>,
+                                             &scalar_run<is_comment>,
+                                             &scalar_run<is_symbol>,
+                                             &scalar_run<is_string>,
+                                             &scalar_newlines };
+
+#if defined(__x86_64__)
+  static constexpr scanners sse2_scanners{ isa::sse2,
+                                           &sse2_run<sse2_whitespace, is_whitespace>,
+                                           &sse2_run<sse2_comment, is_comment>,
+                                           &sse2_run<sse2_symbol, is_symbol>,
+                                           &sse2_run<sse2_string, is_string>,
+                                           &sse2_newlines };
+
+  static constexpr scanners avx2_scanners{
+    isa::avx2,
+    &avx2_run<avx2_whitespace, sse2_whitespace, is_whitespace>,
+    &avx2_run<avx2_comment, sse2_comment, is_comment>,
+    &avx2_run<avx2_symbol, sse2_symbol, is_symbol>,
+    &avx2_run<avx2_string, sse2_string, is_string>,
+    &avx2_newlines
+  };
+#endif
+
+  static scanners const *scanners_for(isa const i)
+  {
+    switch(i)
+    {
+#if defined(__x86_64__)
+      case isa::avx2:
+        return &avx2_scanners;
+      case isa::sse2:
+        return &sse2_scanners;
+#else
+      case isa::avx2:
+      case isa::sse2:
+#endif
+      case isa::scalar:
+        return &scalar_scanners;
+    }
+    return &scalar_scanners;
+  }
+
+  isa best_isa()
+  {
+#if defined(__x86_64__)
+    static isa const best{ __builtin_cpu_supports("avx2") ? isa::avx2 : isa::sse2 };
+    return best;
+#else
+    return isa::scalar;
+#endif
+  }
+
+  static std::atomic<scanners const *> &active()
+  {
+    static std::atomic<scanners const *> ret{ scanners_for(best_isa()) };
+    return ret;
+  }
+
+  void use_isa(isa const i)
+  {
+    active().store(scanners_for(i), std::memory_order_relaxed);
+  }
+
+  isa current_isa()
+  {
+    return active().load(std::memory_order_relaxed)->which;
+  }
+
+  usize whitespace(char const * const data, usize const size)
+  {
+    return active().load(std::memory_order_relaxed)->whitespace(data, size);
+  }
+
+  usize comment(char const * const data, usize const size)
+  {
+    return active().load(std::memory_order_relaxed)->comment(data, size);
+  }
+
+  usize symbol(char const * const data, usize const size)
+  {
+    return active().load(std::memory_order_relaxed)->symbol(data, size);
+  }
+
+  usize string(char const * const data, usize const size)
+  {
+    return active().load(std::memory_order_relaxed)->string(data, size);
+  }
+
+  newlines find_newlines(char const * const data, usize const size)
+  {
+    return active().load(std::memory_order_relaxed)->find_newlines(data, size);
+  }
+}
@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <jank/read/stream.hpp>
+#include <jank/error/parse.hpp>
+#include <jank/util/fmt.hpp>
+
+namespace jank::read
+{
+  /* The lexer only looks a codepoint or so past where it stops. When it stops this close to
+   * the end of the buffer, what it saw may just be the start of input we haven't read yet. */
+  static constexpr usize max_lookahead{ 8 };
+
+  static bool is_delimited(lex::token_kind const kind)
+  {
+    switch(kind)
+    {
+      case lex::token_kind::close_paren:
+      case lex::token_kind::close_square_bracket:
+      case lex::token_kind::close_curly_bracket:
+      case lex::token_kind::string:
+      case lex::token_kind::escaped_string:
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  stream::stream(int const fd, bool const owns_fd, usize const chunk_size)
+    : fd{ fd }
+    , owns_fd{ owns_fd }
+    , chunk_size{ std::max<usize>(chunk_size, 1) }
+  {
+  }
+
+  stream::~stream()
+  {
+    close();
+  }
+
+  jtl::string_result<stream *> stream::open(jtl::immutable_string const &path)
+  {
+    auto const fd(::open(path.c_str(), O_RDONLY | O_CLOEXEC));
+    if(fd < 0)
+    {
+      return err(util::format("Unable to open {}: {}", path, std::strerror(errno)));
+    }
+    return ok(new(GC) stream{ fd, true });
+  }
+
+  void stream::close()
+  {
+    parser.reset();
+    lexer.reset();
+    if(owns_fd && fd >= 0)
+    {
+      ::close(fd);
+    }
+    fd = -1;
+    eof = true;
+  }
+
+  jtl::string_result<void> stream::refill()
+  {
+    /* Reading at least as much as we already have keeps rereading a big form linear. That
+     * only holds if we get all of it, though, and pipes and sockets hand over whatever they
+     * have at the moment, so we keep reading until we have it all or the input ends. */
+    auto const size(buffer.size());
+    auto const wanted(std::max(chunk_size, size));
+    buffer.resize(size + wanted);
+    usize total{};
+    while(total < wanted)
+    {
+      auto const read(::read(fd, buffer.data() + size + total, wanted - total));
+      if(read < 0)
+      {
+        if(errno == EINTR)
+        {
+          continue;
+        }
+        buffer.resize(size + total);
+        return err(util::format("Unable to read from fd {}: {}", fd, std::strerror(errno)));
+      }
+      if(read == 0)
+      {
+        eof = true;
+        break;
+      }
+      total += static_cast<usize>(read);
+    }
+
+    buffer.resize(size + total);
+    return ok();
+  }
+
+  void stream::restart()
+  {
+    parser.reset();
+    lexer.reset();
+    buffer.erase(0, form_start);
+    form_start = 0;
+    lexer.emplace(native_persistent_string_view{ buffer });
+    parser.emplace(lexer->begin(), lexer->end());
+  }
+
+  parse::processor::object_result stream::next()
+  {
+    if(failure.is_some())
+    {
+      return failure.unwrap();
+    }
+    if(!parser.has_value())
+    {
+      if(fd < 0)
+      {
+        return ok(none);
+      }
+      restart();
+    }
+
+    while(true)
+    {
+      auto res(parser->next());
+      auto const near_end(lexer->pos.offset + max_lookahead >= buffer.size());
+      auto const done(res.is_ok() && res.expect_ok().is_some()
+                      && is_delimited(parser->latest_token.kind));
+      if(eof || !near_end || done)
+      {
+        if(res.is_err())
+        {
+          failure = res.expect_err();
+        }
+        else if(res.expect_ok().is_some())
+        {
+          form_start = parser->latest_token.end.offset;
+        }
+        return res;
+      }
+
+      if(res.is_ok() && res.expect_ok().is_none())
+      {
+        /* All that's left is whitespace and comments. Any comment before the last newline is
+         * finished, so it can all go. */
+        auto const newline(buffer.rfind('\n'));
+        if(newline != native_transient_string::npos && newline >= form_start)
+        {
+          form_start = newline + 1;
+        }
+      }
+
+      auto const refilled(refill());
+      if(refilled.is_err())
+      {
+        failure = error::internal_parse_failure(refilled.expect_err());
+        return failure.unwrap();
+      }
+      restart();
+    }
+  }
+}
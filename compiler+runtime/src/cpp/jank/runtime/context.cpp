@@ -17,18 +17,27 @@
 #include <jank/analyze/processor.hpp>
 #include <jank/analyze/expr/primitive_literal.hpp>
 #include <jank/evaluate.hpp>
+#include <jank/evaluate/object_cache.hpp>
 #include <jank/jit/processor.hpp>
 #include <jank/util/process_location.hpp>
 #include <jank/util/clang_format.hpp>
 #include <jank/util/dir.hpp>
 #include <jank/util/fmt/print.hpp>
 #include <jank/codegen/llvm_processor.hpp>
+#include <jank/aot/driver.hpp>
 #include <jank/profile/time.hpp>
 
 namespace jank::runtime
 {
   /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
-  thread_local decltype(context::thread_binding_frames) context::thread_binding_frames{};
+  thread_local decltype(context::thread_bindings_by_context)
+    context::thread_bindings_by_context{};
+  /* There's almost always just the one context, so each thread remembers its bindings for the
+   * last context it looked up, rather than going through the map for every deref. */
+  /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+  static thread_local context const *last_bindings_context{};
+  /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+  static thread_local thread_bindings *last_bindings{};
 
   /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
   context *__rt_ctx{};
@@ -40,6 +49,11 @@ namespace jank::runtime
 
   context::context(util::cli::options const &opts)
     : jit_prc{ opts }
+    , interpret{ opts.interpret }
+    , jit_threshold{ static_cast<u32>(opts.jit_threshold) }
+    , background_jit{ opts.background_jit }
+    , intern_symbols{ opts.intern_symbols }
+    , jit_cache{ opts.jit_cache }
     , binary_cache_dir{ util::binary_cache_dir(opts.optimization_level,
                                                opts.include_dirs,
                                                opts.define_macros) }
@@ -72,6 +86,11 @@ namespace jank::runtime
     assert_var->bind_root(jank_true);
     assert_var->dynamic.store(true);
 
+    auto const agent_sym(make_box<obj::symbol>("*agent*"));
+    agent_var = core->intern_var(agent_sym);
+    agent_var->bind_root(jank_nil);
+    agent_var->dynamic.store(true);
+
     /* These are not actually interned. They're extra private. */
     current_module_var
       = make_box<runtime::var>(core, make_box<obj::symbol>("*current-module*"))->set_dynamic(true);
@@ -94,7 +113,12 @@ namespace jank::runtime
 
   context::~context()
   {
-    thread_binding_frames.erase(this);
+    if(last_bindings_context == this)
+    {
+      last_bindings_context = nullptr;
+      last_bindings = nullptr;
+    }
+    thread_bindings_by_context.erase(this);
   }
 
   obj::symbol_ref context::qualify_symbol(obj::symbol_ref const &sym) const
@@ -170,8 +194,12 @@ namespace jank::runtime
     native_vector<analyze::expression_ref> exprs{};
     for(auto const &form : p_prc)
     {
-      auto const expr(
-        an_prc.analyze(form.expect_ok().unwrap().ptr, analyze::expression_position::statement));
+      auto const &info(form.expect_ok().unwrap());
+      evaluate::object_cache::form_scope const scope{
+        info.ptr,
+        code.substr(info.start.start.offset, info.end.end.offset - info.start.start.offset)
+      };
+      auto const expr(an_prc.analyze(info.ptr, analyze::expression_position::statement));
       ret = evaluate::eval(expr.expect_ok());
       exprs.emplace_back(expr.expect_ok());
     }
@@ -192,7 +220,14 @@ namespace jank::runtime
       fn->unique_name = fn->name;
       codegen::llvm_processor cg_prc{ wrapped_exprs, module, codegen::compilation_target::module };
       cg_prc.gen().expect_ok();
-      write_module(cg_prc.ctx->module_name, cg_prc.ctx->module).expect_ok();
+      if(compile_driver)
+      {
+        compile_driver->emit(std::move(cg_prc.ctx));
+      }
+      else
+      {
+        write_module(cg_prc.ctx->module_name, cg_prc.ctx->module).expect_ok();
+      }
     }
 
     return ret;
@@ -201,6 +236,9 @@ namespace jank::runtime
   void context::eval_cpp_string(native_persistent_string_view const &code) const
   {
     profile::timer const timer{ "rt eval_cpp_string" };
+    /* C++ is declared and run in order, so this stays on the calling thread. We still
+     * need to keep background JIT compilation out of the interpreter meanwhile. */
+    std::lock_guard<std::recursive_mutex> const lock{ jit_prc.mutex };
 
     /* TODO: Handle all the errors here to avoid exceptions. Also, return a message that
      * is valuable to the user. */
@@ -308,7 +346,7 @@ namespace jank::runtime
   jtl::result<void, jtl::immutable_string>
   context::compile_module(native_persistent_string_view const &module)
   {
-    module_dependencies.clear();
+    module_dependencies.wlock()->clear();
 
     binding_scope const preserve{ *this,
                                   obj::persistent_hash_map::create_unique(
@@ -319,6 +357,7 @@ namespace jank::runtime
 
   object_ref context::eval(object_ref const o)
   {
+    evaluate::object_cache::form_scope const scope;
     auto const expr(an_prc.analyze(o, analyze::expression_position::value));
     return evaluate::eval(expr.expect_ok());
   }
@@ -330,6 +369,12 @@ namespace jank::runtime
     std::filesystem::path const module_path{
       util::format("{}/{}.o", binary_cache_dir, module::module_to_path(module_name))
     };
+    return write_object(module_path, module);
+  }
+
+  jtl::string_result<void> context::write_object(std::filesystem::path const &module_path,
+                                                 std::unique_ptr<llvm::Module> const &module) const
+  {
     std::filesystem::create_directories(module_path.parent_path());
 
     /* TODO: Is there a better place for this block of code? */
@@ -509,7 +554,11 @@ namespace jank::runtime
         resolved_ns = current_ns->name->name;
       }
     }
-    return intern_keyword(resolved_ns.empty() ? name : util::format("{}/{}", resolved_ns, name));
+    if(resolved_ns.empty())
+    {
+      return intern_keyword(name);
+    }
+    return keywords.intern(resolved_ns, name);
   }
 
   jtl::result<obj::keyword_ref, jtl::immutable_string>
@@ -517,16 +566,30 @@ namespace jank::runtime
   {
     profile::timer const timer{ "rt intern_keyword" };
 
-    auto locked_keywords(keywords.wlock());
-    auto const found(locked_keywords->find(s));
-    if(found != locked_keywords->end())
+    /* This splits the same way symbols do. */
+    auto const found(s.find('/'));
+    if(found != jtl::immutable_string::npos && s.size() > 1)
     {
-      return found->second;
+      return keywords.intern(s.substr(0, found), s.substr(found + 1));
     }
+    return keywords.intern("", s);
+  }
 
-    auto const res(
-      locked_keywords->emplace(s, make_box<obj::keyword>(detail::must_be_interned{}, s)));
-    return res.first->second;
+  obj::symbol_ref
+  context::intern_symbol(jtl::immutable_string const &ns, jtl::immutable_string const &name)
+  {
+    return symbols.intern(ns, name);
+  }
+
+  obj::symbol_ref context::intern_symbol(jtl::immutable_string const &s)
+  {
+    /* This splits the same way symbols do. */
+    auto const found(s.find('/'));
+    if(found != jtl::immutable_string::npos && s.size() > 1)
+    {
+      return symbols.intern(s.substr(0, found), s.substr(found + 1));
+    }
+    return symbols.intern("", s);
   }
 
   object_ref context::macroexpand1(object_ref const o)
@@ -606,6 +669,13 @@ namespace jank::runtime
     rt_ctx.push_thread_bindings(bindings).expect_ok();
   }
 
+  context::binding_scope::binding_scope(context &rt_ctx,
+                                        thread_binding_frame const * const frame)
+    : rt_ctx{ rt_ctx }
+  {
+    rt_ctx.push_thread_bindings(frame).expect_ok();
+  }
+
   context::binding_scope::~binding_scope()
   {
     try
@@ -618,21 +688,27 @@ namespace jank::runtime
     }
   }
 
-  jtl::string_result<void> context::push_thread_bindings()
+  thread_bindings &context::current_thread_bindings() const
   {
-    auto bindings(obj::persistent_hash_map::empty());
-    auto &tbfs(thread_binding_frames[this]);
-    if(!tbfs.empty())
+    if(last_bindings_context != this)
     {
-      bindings = tbfs.front().bindings;
+      /* References to map values are stable, so this can be kept. */
+      last_bindings = &thread_bindings_by_context[this];
+      last_bindings_context = this;
     }
+    return *last_bindings;
+  }
+
+  jtl::string_result<void> context::push_thread_bindings()
+  {
+    auto const &tbs(current_thread_bindings());
     /* Nothing to preserve, if there are no current bindings. */
-    else
+    if(!tbs.frame)
     {
       return ok();
     }
 
-    return push_thread_bindings(bindings);
+    return push_thread_bindings(tbs.frame->bindings());
   }
 
   jtl::string_result<void> context::push_thread_bindings(object_ref const bindings)
@@ -646,80 +722,129 @@ namespace jank::runtime
     return push_thread_bindings(expect_object<obj::persistent_hash_map>(bindings));
   }
 
-  jtl::string_result<void>
-  context::push_thread_bindings(obj::persistent_hash_map_ref const bindings)
+  static void shadow_slot(thread_bindings &tbs, u32 const slot, var_thread_binding_ref const value)
+  {
+    if(tbs.slots.size() <= slot)
+    {
+      tbs.slots.resize(slot + 1);
+    }
+    tbs.shadowed.emplace_back(slot, tbs.slots[slot]);
+    tbs.slots[slot] = value;
+  }
+
+  static void restore_slots(thread_bindings &tbs, usize const from)
   {
-    thread_binding_frame frame{ obj::persistent_hash_map::empty() };
-    auto &tbfs(thread_binding_frames[this]);
-    if(!tbfs.empty())
+    while(tbs.shadowed.size() > from)
     {
-      frame.bindings = tbfs.front().bindings;
+      auto const &shadowed(tbs.shadowed.back());
+      tbs.slots[shadowed.first] = shadowed.second;
+      tbs.shadowed.pop_back();
     }
+  }
+
+  /* Outer frames go first, so inner bindings win. */
+  static void install_frame(thread_bindings &tbs, thread_binding_frame const * const frame)
+  {
+    if(!frame)
+    {
+      return;
+    }
+
+    install_frame(tbs, frame->parent);
+    for(auto const &b : frame->pushed)
+    {
+      shadow_slot(tbs, b.slot, b.value);
+    }
+  }
+
+  jtl::string_result<void>
+  context::push_thread_bindings(obj::persistent_hash_map_ref const bindings)
+  {
+    auto &tbs(current_thread_bindings());
+    auto const shadowed_from(tbs.shadowed.size());
+    auto const frame(new(GC) thread_binding_frame{ tbs.frame });
+    frame->pushed.reserve(bindings->count());
 
     auto const thread_id(std::this_thread::get_id());
 
     for(auto it(bindings->fresh_seq()); it.is_some(); it = it->next_in_place())
     {
       auto const entry(it->first());
-      auto const var(expect_object<var>(entry->data[0]));
+      auto const var(expect_object<runtime::var>(entry->data[0]));
       if(!var->dynamic.load())
       {
+        restore_slots(tbs, shadowed_from);
         return err(util::format("Can't dynamically bind non-dynamic var: {}", var->to_string()));
       }
 
-      /* XXX: Once this is set to true, here, it's never unset. */
-      var->thread_bound.store(true);
-
       /* The binding may already be a thread binding if we're just pushing the previous
        * bindings again to give a scratch pad for some upcoming code. */
-      if(entry->data[1]->type == object_type::var_thread_binding)
+      auto value(entry->data[1]);
+      if(value->type == object_type::var_thread_binding)
       {
-        frame.bindings = frame.bindings->assoc(
-          var,
-          make_box<var_thread_binding>(expect_object<var_thread_binding>(entry->data[1])->value,
-                                       thread_id));
+        value = expect_object<var_thread_binding>(value)->value.load(std::memory_order_acquire);
       }
-      else
+      auto const binding(make_box<var_thread_binding>(value, thread_id));
+      auto const slot(var->get_binding_slot());
+      frame->pushed.push_back({ var, slot, binding });
+      shadow_slot(tbs, slot, binding);
+    }
+
+    tbs.pushes.emplace_back(tbs.frame, shadowed_from);
+    tbs.frame = frame;
+    return ok();
+  }
+
+  jtl::string_result<void> context::push_thread_bindings(thread_binding_frame const * const frame)
+  {
+    auto &tbs(current_thread_bindings());
+    auto const shadowed_from(tbs.shadowed.size());
+
+    /* Whatever this thread has bound is hidden, first, so the captured bindings replace it,
+     * rather than being merged with it. */
+    for(auto f(tbs.frame); f; f = f->parent)
+    {
+      for(auto const &b : f->pushed)
       {
-        frame.bindings
-          = frame.bindings->assoc(var, make_box<var_thread_binding>(entry->data[1], thread_id));
+        shadow_slot(tbs, b.slot, {});
       }
     }
 
-    tbfs.push_front(std::move(frame));
+    install_frame(tbs, frame);
+
+    tbs.pushes.emplace_back(tbs.frame, shadowed_from);
+    tbs.frame = frame;
     return ok();
   }
 
   jtl::string_result<void> context::pop_thread_bindings()
   {
-    auto &tbfs(thread_binding_frames[this]);
-    if(tbfs.empty())
+    auto &tbs(current_thread_bindings());
+    if(tbs.pushes.empty())
     {
       return err("Mismatched thread binding pop");
     }
 
-    tbfs.pop_front();
+    auto const push(tbs.pushes.back());
+    restore_slots(tbs, push.second);
+    tbs.frame = push.first;
+    tbs.pushes.pop_back();
 
     return ok();
   }
 
   obj::persistent_hash_map_ref context::get_thread_bindings() const
   {
-    auto const &tbfs(thread_binding_frames[this]);
-    if(tbfs.empty())
+    auto const &tbs(current_thread_bindings());
+    if(!tbs.frame)
     {
       return obj::persistent_hash_map::empty();
     }
-    return tbfs.front().bindings;
+    return tbs.frame->bindings();
   }
 
-  jtl::option<thread_binding_frame> context::current_thread_binding_frame()
+  thread_binding_frame const *context::capture_thread_bindings() const
   {
-    auto &tbfs(thread_binding_frames[this]);
-    if(tbfs.empty())
-    {
-      return none;
-    }
-    return tbfs.front();
+    return current_thread_bindings().frame;
   }
 }
@@ -2,6 +2,8 @@
 #include <jank/runtime/visit.hpp>
 #include <jank/runtime/behavior/nameable.hpp>
 #include <jank/runtime/behavior/derefable.hpp>
+#include <jank/runtime/behavior/ref_like.hpp>
+#include <jank/runtime/obj/agent.hpp>
 #include <jank/runtime/context.hpp>
 #include <jank/runtime/sequence_range.hpp>
 #include <jank/util/fmt.hpp>
@@ -417,6 +419,43 @@ namespace jank::runtime
       o);
   }
 
+  object_ref deref(object_ref const o, object_ref const timeout_ms, object_ref const timeout_val)
+  {
+    return visit_object(
+      [=](auto const typed_o) -> object_ref {
+        using T = typename decltype(typed_o)::value_type;
+
+        if constexpr(behavior::blocking_derefable<T>)
+        {
+          return typed_o->deref(to_int(timeout_ms), timeout_val);
+        }
+        else
+        {
+          throw std::runtime_error{ util::format("not blocking derefable: {}",
+                                                 typed_o->to_string()) };
+        }
+      },
+      o);
+  }
+
+  bool is_realized(object_ref const o)
+  {
+    return visit_object(
+      [=](auto const typed_o) -> bool {
+        using T = typename decltype(typed_o)::value_type;
+
+        if constexpr(behavior::pending<T>)
+        {
+          return typed_o->is_realized();
+        }
+        else
+        {
+          throw std::runtime_error{ util::format("not pending: {}", typed_o->to_string()) };
+        }
+      },
+      o);
+  }
+
   object_ref volatile_(object_ref const o)
   {
     return make_box<obj::volatile_>(o);
@@ -459,6 +498,30 @@ namespace jank::runtime
     return __rt_ctx->get_thread_bindings();
   }
 
+  object_ref capture_thread_bindings()
+  {
+    /* Nil when nothing is bound, which installs no bindings. */
+    auto const frame(__rt_ctx->capture_thread_bindings());
+    if(!frame)
+    {
+      return jank_nil;
+    }
+    return thread_binding_frame_ref{ frame };
+  }
+
+  object_ref
+  call_with_thread_bindings(object_ref const bindings, object_ref const f, object_ref const args)
+  {
+    thread_binding_frame const *frame{};
+    if(bindings.is_some())
+    {
+      frame = static_cast<thread_binding_frame const *>(
+        try_object<thread_binding_frame>(bindings).data);
+    }
+    context::binding_scope const scope{ *__rt_ctx, frame };
+    return apply_to(f, args);
+  }
+
   object_ref force(object_ref const o)
   {
     if(o->type == object_type::delay)
@@ -468,6 +531,197 @@ namespace jank::runtime
     return o;
   }
 
+  object_ref future_call(object_ref const fn)
+  {
+    return obj::future::create(fn);
+  }
+
+  bool is_future(object_ref const o)
+  {
+    return o->type == object_type::future;
+  }
+
+  bool is_future_done(object_ref const o)
+  {
+    return try_object<obj::future>(o)->is_realized();
+  }
+
+  bool future_cancel(object_ref const o)
+  {
+    return try_object<obj::future>(o)->cancel();
+  }
+
+  bool is_future_cancelled(object_ref const o)
+  {
+    return try_object<obj::future>(o)->is_cancelled();
+  }
+
+  object_ref agent(object_ref const state)
+  {
+    return make_box<obj::agent>(state);
+  }
+
+  object_ref agent_send(object_ref const a, object_ref const fn, object_ref const args)
+  {
+    return try_object<obj::agent>(a)->dispatch(fn, args, obj::agent_executor::send);
+  }
+
+  object_ref agent_send_off(object_ref const a, object_ref const fn, object_ref const args)
+  {
+    return try_object<obj::agent>(a)->dispatch(fn, args, obj::agent_executor::send_off);
+  }
+
+  object_ref agent_await(object_ref const agents)
+  {
+    obj::agent::await(agents);
+    return jank_nil;
+  }
+
+  bool agent_await_for(object_ref const timeout_ms, object_ref const agents)
+  {
+    return obj::agent::await_for(to_int(timeout_ms), agents);
+  }
+
+  i64 release_pending_sends()
+  {
+    return static_cast<i64>(obj::agent::release_pending_sends());
+  }
+
+  object_ref agent_error(object_ref const a)
+  {
+    return try_object<obj::agent>(a)->get_error();
+  }
+
+  object_ref
+  restart_agent(object_ref const a, object_ref const new_state, object_ref const clear_actions)
+  {
+    return try_object<obj::agent>(a)->restart(new_state, truthy(clear_actions));
+  }
+
+  object_ref set_error_handler(object_ref const a, object_ref const fn)
+  {
+    try_object<obj::agent>(a)->set_error_handler(fn);
+    return jank_nil;
+  }
+
+  object_ref error_handler(object_ref const a)
+  {
+    return try_object<obj::agent>(a)->get_error_handler();
+  }
+
+  object_ref set_error_mode(object_ref const a, object_ref const mode)
+  {
+    auto const typed_a(try_object<obj::agent>(a));
+    auto const &name(try_object<obj::keyword>(mode)->sym->name);
+    if(name == "continue")
+    {
+      typed_a->set_error_mode(obj::agent_error_mode::continue_);
+    }
+    else if(name == "fail")
+    {
+      typed_a->set_error_mode(obj::agent_error_mode::fail);
+    }
+    else
+    {
+      throw std::runtime_error{ util::format("invalid agent error mode: {}",
+                                             runtime::to_code_string(mode)) };
+    }
+    return jank_nil;
+  }
+
+  object_ref error_mode(object_ref const a)
+  {
+    switch(try_object<obj::agent>(a)->get_error_mode())
+    {
+      case obj::agent_error_mode::continue_:
+        return __rt_ctx->intern_keyword("continue").expect_ok();
+      case obj::agent_error_mode::fail:
+        return __rt_ctx->intern_keyword("fail").expect_ok();
+    }
+    return jank_nil;
+  }
+
+  object_ref shutdown_agents()
+  {
+    obj::shutdown_agents();
+    return jank_nil;
+  }
+
+  object_ref set_validator(object_ref const ref, object_ref const fn)
+  {
+    return visit_object(
+      [=](auto const typed_ref) -> object_ref {
+        using T = typename decltype(typed_ref)::value_type;
+
+        if constexpr(behavior::ref_like<T>)
+        {
+          typed_ref->set_validator(fn);
+          return jank_nil;
+        }
+        else
+        {
+          throw std::runtime_error{ util::format("not a reference: {}", typed_ref->to_string()) };
+        }
+      },
+      ref);
+  }
+
+  object_ref get_validator(object_ref const ref)
+  {
+    return visit_object(
+      [=](auto const typed_ref) -> object_ref {
+        using T = typename decltype(typed_ref)::value_type;
+
+        if constexpr(behavior::ref_like<T>)
+        {
+          return typed_ref->get_validator();
+        }
+        else
+        {
+          throw std::runtime_error{ util::format("not a reference: {}", typed_ref->to_string()) };
+        }
+      },
+      ref);
+  }
+
+  object_ref add_watch(object_ref const ref, object_ref const key, object_ref const fn)
+  {
+    return visit_object(
+      [=](auto const typed_ref) -> object_ref {
+        using T = typename decltype(typed_ref)::value_type;
+
+        if constexpr(behavior::ref_like<T>)
+        {
+          typed_ref->add_watch(key, fn);
+          return typed_ref;
+        }
+        else
+        {
+          throw std::runtime_error{ util::format("not a reference: {}", typed_ref->to_string()) };
+        }
+      },
+      ref);
+  }
+
+  object_ref remove_watch(object_ref const ref, object_ref const key)
+  {
+    return visit_object(
+      [=](auto const typed_ref) -> object_ref {
+        using T = typename decltype(typed_ref)::value_type;
+
+        if constexpr(behavior::ref_like<T>)
+        {
+          typed_ref->remove_watch(key);
+          return typed_ref;
+        }
+        else
+        {
+          throw std::runtime_error{ util::format("not a reference: {}", typed_ref->to_string()) };
+        }
+      },
+      ref);
+  }
+
   object_ref tagged_literal(object_ref const tag, object_ref const form)
   {
     return make_box<obj::tagged_literal>(tag, form);
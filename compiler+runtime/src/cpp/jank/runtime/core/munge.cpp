@@ -316,29 +316,30 @@ namespace jank::runtime
       return o.substr(0, o.size() - 2);
     }
 
-    native_transient_string ret{ o };
-
-    for(auto const &pair : demunge_chars)
+    /* Every munged sequence starts with an underscore, so everything else is copied as is
+     * and each underscore is replaced by the longest sequence which starts there. This is
+     * a single pass, so it's linear in the length of the string. */
+    native_persistent_string_view const s{ o };
+    native_transient_string ret;
+    ret.reserve(s.size());
+    for(usize i{}; i < s.size();)
     {
-      usize pos{};
-      auto const pattern_length{ pair.first.length() };
-      native_transient_string tmp;
-      tmp.reserve(ret.size());
+      if(s[i] != '_')
+      {
+        ret += s[i++];
+        continue;
+      }
 
-      while(true)
+      /* The last entry is just an underscore, so something always matches. */
+      for(auto const &pair : demunge_chars)
       {
-        auto const found{ ret.find(pair.first, pos) };
-        if(found == native_transient_string::npos)
+        if(s.substr(i).starts_with(pair.first))
         {
-          tmp.append(ret, pos, ret.size() - pos);
+          ret += pair.second;
+          i += pair.first.size();
           break;
         }
-        tmp.append(ret, pos, found - pos);
-        tmp += pair.second;
-        pos = found + pattern_length;
       }
-
-      ret = tmp;
     }
 
     return ret;
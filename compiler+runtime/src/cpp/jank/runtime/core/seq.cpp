@@ -1,6 +1,10 @@
 #include <algorithm>
+#include <exception>
+#include <functional>
 #include <random>
 
+#include <immer/algorithm.hpp>
+
 #include <jank/runtime/visit.hpp>
 #include <jank/runtime/behavior/associatively_readable.hpp>
 #include <jank/runtime/behavior/associatively_writable.hpp>
@@ -13,6 +17,7 @@
 #include <jank/runtime/behavior/collection_like.hpp>
 #include <jank/runtime/behavior/transientable.hpp>
 #include <jank/runtime/behavior/indexable.hpp>
+#include <jank/runtime/behavior/map_like.hpp>
 #include <jank/runtime/behavior/stackable.hpp>
 #include <jank/runtime/behavior/chunkable.hpp>
 #include <jank/runtime/behavior/metadatable.hpp>
@@ -1062,23 +1067,267 @@ namespace jank::runtime
 
   object_ref reduce(object_ref const f, object_ref const init, object_ref const s)
   {
-    return visit_seqable(
-      [](auto const typed_coll, object_ref const f, object_ref const init) -> object_ref {
-        object_ref res{ init };
-        for(auto const e : make_sequence_range(typed_coll))
-        {
-          res = dynamic_call(f, res, e);
-          if(res->type == object_type::reduced)
+    object_ref res{ init };
+    bool done{};
+    auto const step([&](object_ref const e) {
+      res = dynamic_call(f, res, e);
+      if(res->type == object_type::reduced)
+      {
+        res = expect_object<obj::reduced>(res)->val;
+        done = true;
+      }
+    });
+    /* immer's chunk traversal can't be stopped early, but skipping what's left is just a
+     * check per leaf. */
+    auto const step_chunk([&](auto const first, auto const last) {
+      for(auto it(first); it != last && !done; ++it)
+      {
+        step(*it);
+      }
+    });
+
+    /* The collections we know the layout of are walked directly, so no seq is allocated
+     * per element. A chunked seq can end with any other seq, so we keep going until we
+     * hit one which isn't chunked. */
+    object_ref coll{ s };
+    while(!done)
+    {
+      switch(coll->type)
+      {
+        case object_type::persistent_vector:
+          immer::for_each_chunk(expect_object<obj::persistent_vector>(coll)->data, step_chunk);
+          return res;
+        case object_type::persistent_vector_sequence:
+          {
+            auto const typed_coll(expect_object<obj::persistent_vector_sequence>(coll));
+            auto const &data(typed_coll->vec->data);
+            immer::for_each_chunk(data.begin() + static_cast<i64>(typed_coll->index),
+                                  data.end(),
+                                  step_chunk);
+            return res;
+          }
+        case object_type::persistent_hash_set:
+          immer::for_each_chunk(expect_object<obj::persistent_hash_set>(coll)->data, step_chunk);
+          return res;
+        case object_type::persistent_hash_map:
+          immer::for_each_chunk(
+            expect_object<obj::persistent_hash_map>(coll)->data,
+            [&](auto const first, auto const last) {
+              for(auto it(first); it != last && !done; ++it)
+              {
+                step(make_box<obj::persistent_vector>(std::in_place, it->first, it->second));
+              }
+            });
+          return res;
+        case object_type::integer_range:
+          {
+            auto const typed_coll(expect_object<obj::integer_range>(coll));
+            auto const count(typed_coll->count());
+            auto const by(typed_coll->step->data);
+            auto i(typed_coll->start->data);
+            for(usize n{}; n < count && !done; ++n, i += by)
+            {
+              step(make_box(i));
+            }
+            return res;
+          }
+        case object_type::range:
+          {
+            auto const typed_coll(expect_object<obj::range>(coll));
+            auto const chunk(typed_coll->chunked_first());
+            step_chunk(chunk->buffer.begin() + static_cast<i64>(chunk->offset),
+                       chunk->buffer.end());
+            coll = typed_coll->chunked_next();
+            break;
+          }
+        case object_type::chunked_cons:
           {
-            res = expect_object<obj::reduced>(res)->val;
+            auto const typed_coll(expect_object<obj::chunked_cons>(coll));
+            auto const chunk(expect_object<obj::array_chunk>(typed_coll->chunked_first()));
+            step_chunk(chunk->buffer.begin() + static_cast<i64>(chunk->offset),
+                       chunk->buffer.end());
+            coll = typed_coll->chunked_next();
             break;
           }
+        default:
+          return visit_seqable(
+            [&](auto const typed_coll) -> object_ref {
+              for(auto const e : make_sequence_range(typed_coll))
+              {
+                step(e);
+                if(done)
+                {
+                  break;
+                }
+              }
+              return res;
+            },
+            coll);
+      }
+    }
+    return res;
+  }
+
+  /* A contiguous run of elements within one of immer's leaf nodes. */
+  template <typename T>
+  using fold_chunk = std::pair<T const *, T const *>;
+
+  /* Groups the chunks into pieces of at least piece_size elements and reduces each piece
+   * as a future on the default thread pool. Each piece starts with (combinef) and the
+   * pieces are then combined, in order, with (combinef l r). Derefing a future which
+   * nobody has started runs it on this thread, so a fold within a fold can't starve
+   * the pool. */
+  template <typename T, typename Step>
+  static object_ref fold_chunks(usize const piece_size,
+                                object_ref const combinef,
+                                native_vector<fold_chunk<T>> const &chunks,
+                                Step const &step)
+  {
+    auto const reduce_piece([&](usize const from, usize const to) -> object_ref {
+      object_ref res{ dynamic_call(combinef) };
+      for(auto i(from); i < to; ++i)
+      {
+        for(auto it(chunks[i].first); it != chunks[i].second; ++it)
+        {
+          res = step(res, *it);
+          if(res->type == object_type::reduced)
+          {
+            return expect_object<obj::reduced>(res)->val;
+          }
+        }
+      }
+      return res;
+    });
+
+    /* There's at most one piece per chunk, so storing a piece once it's queued can't fail. */
+    native_vector<object_ref> pieces;
+    pieces.reserve(chunks.size());
+    try
+    {
+      usize from{}, size{};
+      for(usize i{}; i < chunks.size(); ++i)
+      {
+        size += static_cast<usize>(chunks[i].second - chunks[i].first);
+        if(size >= piece_size || i + 1 == chunks.size())
+        {
+          auto const to(i + 1);
+          pieces.push_back(obj::future::create(make_box<obj::native_function_wrapper>(
+            std::function<object_ref()>{ [&reduce_piece, from, to]() -> object_ref {
+              return reduce_piece(from, to);
+            } })));
+          from = to;
+          size = 0;
+        }
+      }
+    }
+    catch(...)
+    {
+      /* The pieces which were already queued reference this frame, so they need to finish
+       * before the error can leave it. Their own errors are dropped in favor of this one. */
+      for(auto const piece : pieces)
+      {
+        try
+        {
+          deref(piece);
+        }
+        catch(...)
+        {
+        }
+      }
+      throw;
+    }
+
+    if(pieces.size() < 2)
+    {
+      return pieces.empty() ? dynamic_call(combinef) : deref(pieces[0]);
+    }
+
+    /* The pieces reference this frame, so every one of them needs to be finished before
+     * we can leave, even if one has failed. */
+    object_ref ret;
+    std::exception_ptr error;
+    for(usize i{}; i < pieces.size(); ++i)
+    {
+      try
+      {
+        auto const piece(deref(pieces[i]));
+        if(!error)
+        {
+          ret = (i == 0) ? piece : dynamic_call(combinef, ret, piece);
+        }
+      }
+      catch(...)
+      {
+        if(!error)
+        {
+          error = std::current_exception();
+        }
+      }
+    }
+    if(error)
+    {
+      std::rethrow_exception(error);
+    }
+    return ret;
+  }
+
+  object_ref
+  fold(object_ref const n, object_ref const combinef, object_ref const reducef, object_ref const coll)
+  {
+    auto const piece_size(static_cast<usize>(std::max<i64>(1, to_int(n))));
+    auto const step_kv([=](object_ref const acc, std::pair<object_ref, object_ref> const &e) {
+      return dynamic_call(reducef, acc, e.first, e.second);
+    });
+    auto const step([=](object_ref const acc, object_ref const e) {
+      return dynamic_call(reducef, acc, e);
+    });
+
+    return visit_object(
+      [&](auto const typed_coll) -> object_ref {
+        using T = typename decltype(typed_coll)::value_type;
+
+        if constexpr(std::same_as<T, obj::persistent_vector>
+                     || std::same_as<T, obj::persistent_hash_set>)
+        {
+          native_vector<fold_chunk<object_ref>> chunks;
+          immer::for_each_chunk(typed_coll->data,
+                                [&](object_ref const * const first, object_ref const * const last) {
+                                  chunks.emplace_back(first, last);
+                                });
+          return fold_chunks(piece_size, combinef, chunks, step);
+        }
+        else if constexpr(std::same_as<T, obj::persistent_hash_map>)
+        {
+          using entry = std::pair<object_ref, object_ref>;
+          native_vector<fold_chunk<entry>> chunks;
+          immer::for_each_chunk(typed_coll->data,
+                                [&](entry const * const first, entry const * const last) {
+                                  chunks.emplace_back(first, last);
+                                });
+          return fold_chunks(piece_size, combinef, chunks, step_kv);
+        }
+        else if constexpr(behavior::map_like<T> && behavior::seqable<T>)
+        {
+          /* Other maps are small or ordered, so they're just reduced, like reduce-kv. */
+          object_ref res{ dynamic_call(combinef) };
+          for(auto it(typed_coll->fresh_seq()); it.is_some(); it = it->next_in_place())
+          {
+            object_ref const entry{ it->first() };
+            auto const e(expect_object<obj::persistent_vector>(entry));
+            res = dynamic_call(reducef, res, e->data[0], e->data[1]);
+            if(res->type == object_type::reduced)
+            {
+              return expect_object<obj::reduced>(res)->val;
+            }
+          }
+          return res;
+        }
+        else
+        {
+          return reduce(reducef, dynamic_call(combinef), typed_coll);
         }
-        return res;
       },
-      s,
-      f,
-      init);
+      coll);
   }
 
   object_ref reduced(object_ref const o)
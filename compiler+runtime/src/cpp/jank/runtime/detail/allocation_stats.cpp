@@ -0,0 +1,225 @@
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <gc/gc.h>
+#include <cpptrace/cpptrace.hpp>
+
+#include <jank/runtime/detail/allocation_stats.hpp>
+
+namespace jank::runtime::detail
+{
+  /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+  constinit thread_local allocation_stats *thread_allocation_stats{};
+  /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+  std::atomic<u64> allocation_sample_interval{};
+  /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+  constinit thread_local char const *current_allocation_fn{};
+
+  /* Every thread's counts, as well as the counts of threads which have exited. The exited
+   * block is also where threads count once their own block is gone, while they're exiting. */
+  static std::mutex registry_mutex;
+  static std::vector<allocation_stats *> registry;
+  static allocation_stats exited_thread_stats;
+
+  static void add_into(allocation_totals &totals, allocation_stats const &stats)
+  {
+    totals.boxes += stats.boxes.load(std::memory_order_relaxed);
+    totals.cached_boxes += stats.cached_boxes.load(std::memory_order_relaxed);
+    for(usize i{}; i < stats.boxes_by_type.size(); ++i)
+    {
+      totals.boxes_by_type[i] += stats.boxes_by_type[i].load(std::memory_order_relaxed);
+    }
+  }
+
+  struct thread_allocation_stats_owner
+  {
+    thread_allocation_stats_owner()
+    {
+      std::lock_guard<std::mutex> const lock{ registry_mutex };
+      registry.push_back(&stats);
+      thread_allocation_stats = &stats;
+    }
+
+    ~thread_allocation_stats_owner()
+    {
+      std::lock_guard<std::mutex> const lock{ registry_mutex };
+      exited_thread_stats.boxes.fetch_add(stats.boxes.load(std::memory_order_relaxed),
+                                          std::memory_order_relaxed);
+      exited_thread_stats.cached_boxes.fetch_add(stats.cached_boxes.load(std::memory_order_relaxed),
+                                                 std::memory_order_relaxed);
+      for(usize i{}; i < stats.boxes_by_type.size(); ++i)
+      {
+        exited_thread_stats.boxes_by_type[i].fetch_add(
+          stats.boxes_by_type[i].load(std::memory_order_relaxed),
+          std::memory_order_relaxed);
+      }
+      std::erase(registry, &stats);
+      /* Anything this thread boxes from here on, while it exits, is counted as exited. */
+      thread_allocation_stats = &exited_thread_stats;
+    }
+
+    allocation_stats stats;
+  };
+
+  allocation_stats &register_thread_allocation_stats()
+  {
+    static thread_local thread_allocation_stats_owner owner;
+    return owner.stats;
+  }
+
+  allocation_totals box_allocation_totals()
+  {
+    allocation_totals ret;
+    std::lock_guard<std::mutex> const lock{ registry_mutex };
+    add_into(ret, exited_thread_stats);
+    for(auto const stats : registry)
+    {
+      add_into(ret, *stats);
+    }
+    return ret;
+  }
+
+  /* Only the collecting thread touches the start time, with the GC's lock held. */
+  static std::chrono::steady_clock::time_point collection_start;
+  static std::atomic<u64> collections;
+  static std::atomic<u64> total_pause_ns;
+  static std::atomic<u64> max_pause_ns;
+
+  static void GC_CALLBACK on_collection_event(GC_EventType const event)
+  {
+    switch(event)
+    {
+      case GC_EVENT_START:
+        collection_start = std::chrono::steady_clock::now();
+        break;
+      case GC_EVENT_END:
+        {
+          auto const pause(static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                              std::chrono::steady_clock::now() - collection_start)
+                                              .count()));
+          collections.fetch_add(1, std::memory_order_relaxed);
+          total_pause_ns.fetch_add(pause, std::memory_order_relaxed);
+          if(pause > max_pause_ns.load(std::memory_order_relaxed))
+          {
+            max_pause_ns.store(pause, std::memory_order_relaxed);
+          }
+        }
+        break;
+      default:
+        break;
+    }
+  }
+
+  void track_collections()
+  {
+    GC_set_on_collection_event(&on_collection_event);
+  }
+
+  collection_stats current_collection_stats()
+  {
+    return { collections.load(std::memory_order_relaxed),
+             total_pause_ns.load(std::memory_order_relaxed),
+             max_pause_ns.load(std::memory_order_relaxed) };
+  }
+
+  /* Samples are kept raw, since resolving them is far slower than making a box. Past this
+   * many, new samples are dropped until they're cleared. */
+  static constexpr usize max_samples{ 16 * 1024 };
+  static constexpr usize max_sample_depth{ 24 };
+  struct allocation_sample
+  {
+    cpptrace::raw_trace trace;
+    /* Copied, since the fn's name may not outlive it. */
+    std::string fn;
+  };
+
+  static std::mutex samples_mutex;
+  static std::vector<allocation_sample> samples;
+  static constinit thread_local u64 sample_countdown{};
+
+  void sample_box_allocation(object_type)
+  {
+    if(sample_countdown > 1)
+    {
+      --sample_countdown;
+      return;
+    }
+    sample_countdown = allocation_sample_interval.load(std::memory_order_relaxed);
+
+    allocation_sample sample{ cpptrace::generate_raw_trace(1, max_sample_depth),
+                              current_allocation_fn ? current_allocation_fn : "" };
+    std::lock_guard<std::mutex> const lock{ samples_mutex };
+    if(samples.size() < max_samples)
+    {
+      samples.emplace_back(std::move(sample));
+    }
+  }
+
+  /* Frames in here are about making the box, not about what wanted it. */
+  static bool is_allocation_frame(cpptrace::stacktrace_frame const &frame)
+  {
+    return frame.symbol.find("jank::runtime::detail::") != std::string::npos
+      || frame.symbol.find("make_box") != std::string::npos;
+  }
+
+  static jtl::immutable_string describe_site(cpptrace::stacktrace_frame const &frame)
+  {
+    /* JIT frames which aren't within a known fn. */
+    if(frame.symbol.empty())
+    {
+      return "<jank jit frame>";
+    }
+
+    /* Like with stack traces, the parameters only get in the way. */
+    std::string symbol{ frame.symbol.substr(0, frame.symbol.find('(')) };
+    if(frame.line.has_value())
+    {
+      symbol += " " + frame.filename + ":" + std::to_string(frame.line.value());
+    }
+    return symbol;
+  }
+
+  native_vector<allocation_site> sampled_allocation_sites()
+  {
+    std::vector<allocation_sample> taken;
+    {
+      std::lock_guard<std::mutex> const lock{ samples_mutex };
+      taken = samples;
+    }
+
+    native_unordered_map<jtl::immutable_string, u64> counts;
+    for(auto const &sample : taken)
+    {
+      /* Whatever native code the fn called into to box, it's the fn which asked for it. */
+      if(!sample.fn.empty())
+      {
+        ++counts[sample.fn];
+        continue;
+      }
+
+      auto const resolved(sample.trace.resolve());
+      auto const site(std::ranges::find_if_not(resolved.frames, &is_allocation_frame));
+      if(site != resolved.frames.end())
+      {
+        ++counts[describe_site(*site)];
+      }
+    }
+
+    native_vector<allocation_site> ret;
+    for(auto const &count : counts)
+    {
+      ret.push_back({ count.first, count.second });
+    }
+    std::ranges::sort(ret, [](auto const &l, auto const &r) { return l.samples > r.samples; });
+    return ret;
+  }
+
+  void clear_allocation_samples()
+  {
+    std::lock_guard<std::mutex> const lock{ samples_mutex };
+    samples.clear();
+  }
+}
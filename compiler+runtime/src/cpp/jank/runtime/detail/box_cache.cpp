@@ -0,0 +1,111 @@
+#include <new>
+
+#include <gc/gc_mark.h>
+
+#include <jank/runtime/detail/box_cache.hpp>
+
+namespace jank::runtime::detail
+{
+  /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+  constinit thread_local box_cache *thread_box_cache{};
+  /* Once the thread's cache is gone, during thread exit, anything else we box goes straight to
+   * the GC, rather than setting up a cache which would never be freed. */
+  /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+  static constinit thread_local bool thread_box_cache_released{};
+
+  struct box_cache_owner
+  {
+    box_cache_owner()
+    {
+      auto const mem(GC_MALLOC_UNCOLLECTABLE(sizeof(box_cache)));
+      if(!mem)
+      {
+        throw std::bad_alloc{};
+      }
+      thread_box_cache = new(mem) box_cache{};
+    }
+
+    ~box_cache_owner()
+    {
+      /* Whatever is left on the lists becomes garbage. */
+      GC_FREE(thread_box_cache);
+      thread_box_cache = nullptr;
+      thread_box_cache_released = true;
+    }
+  };
+
+  /* Sets up the thread's cache, unless the thread is exiting and the cache is already gone. */
+  static bool acquire_box_cache()
+  {
+    if(thread_box_cache_released)
+    {
+      return false;
+    }
+    static thread_local box_cache_owner const owner;
+    return true;
+  }
+
+  void *refill_box_cache(usize const size_class)
+  {
+    auto const size((size_class + 1) * box_cache::granule_size);
+    if(!acquire_box_cache())
+    {
+      auto const ret(GC_MALLOC(size));
+      if(!ret)
+      {
+        throw std::bad_alloc{};
+      }
+      return ret;
+    }
+
+    /* The GC decides how many boxes are in a batch, which is usually about a page's worth. */
+    auto const batch(GC_malloc_many(size));
+    if(!batch)
+    {
+      throw std::bad_alloc{};
+    }
+    thread_box_cache->free_lists[size_class] = GC_NEXT(batch);
+    GC_NEXT(batch) = nullptr;
+    return batch;
+  }
+
+  void *refill_pointer_free_box_cache(usize const size_class)
+  {
+    auto const size((size_class + 1) * box_cache::granule_size);
+    if(!acquire_box_cache())
+    {
+      auto const ret(GC_MALLOC_ATOMIC(size));
+      if(!ret)
+      {
+        throw std::bad_alloc{};
+      }
+      return ret;
+    }
+
+    /* The batch is linked through its boxes, which the GC doesn't scan, so a collection
+     * before they're all on the stack would take back everything past the first. */
+    void *batch{};
+    GC_disable();
+    GC_generic_malloc_many(size, GC_I_PTRFREE, &batch);
+    if(!batch)
+    {
+      GC_enable();
+      throw std::bad_alloc{};
+    }
+
+    auto &boxes(thread_box_cache->pointer_free_boxes[size_class]);
+    auto &count(thread_box_cache->pointer_free_counts[size_class]);
+    auto next(GC_NEXT(batch));
+    GC_NEXT(batch) = nullptr;
+    while(next && count < box_cache::pointer_free_capacity)
+    {
+      auto const box(next);
+      next = GC_NEXT(box);
+      GC_NEXT(box) = nullptr;
+      boxes[count++] = box;
+    }
+    /* Anything which doesn't fit is unreachable, so the GC takes it back. */
+    GC_enable();
+    return batch;
+  }
+}
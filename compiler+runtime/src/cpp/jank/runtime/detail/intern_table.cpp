@@ -0,0 +1,113 @@
+#include <jank/runtime/detail/intern_table.hpp>
+#include <jank/runtime/obj/keyword.hpp>
+#include <jank/runtime/obj/symbol.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/hash.hpp>
+
+namespace jank::runtime::detail
+{
+  static constexpr usize initial_capacity{ 1024 };
+
+  template <typename T>
+  static typename intern_table<T>::table *make_table(usize const capacity)
+  {
+    using table = typename intern_table<T>::table;
+    using slot = typename intern_table<T>::slot;
+    return new(GC) table{ capacity, new(GC) slot[capacity]{} };
+  }
+
+  template <typename T>
+  static T *find(typename intern_table<T>::table const &t,
+                 uhash const hash,
+                 jtl::immutable_string const &ns,
+                 jtl::immutable_string const &name)
+  {
+    auto const mask(t.capacity - 1);
+    for(auto i(hash & mask);; i = (i + 1) & mask)
+    {
+      auto const &s(t.slots[i]);
+      auto const value(s.value.load(std::memory_order_acquire));
+      if(!value)
+      {
+        return nullptr;
+      }
+      if(s.hash == hash && value->get_name() == name && value->get_namespace() == ns)
+      {
+        return value;
+      }
+    }
+  }
+
+  template <typename T>
+  static void insert(typename intern_table<T>::table &t, uhash const hash, T * const value)
+  {
+    auto const mask(t.capacity - 1);
+    for(auto i(hash & mask);; i = (i + 1) & mask)
+    {
+      auto &s(t.slots[i]);
+      if(!s.value.load(std::memory_order_relaxed))
+      {
+        s.hash = hash;
+        s.value.store(value, std::memory_order_release);
+        return;
+      }
+    }
+  }
+
+  template <typename T>
+  intern_table<T>::intern_table()
+    : current{ make_table<T>(initial_capacity) }
+  {
+  }
+
+  template <typename T>
+  oref<T>
+  intern_table<T>::intern(jtl::immutable_string const &ns, jtl::immutable_string const &name)
+  {
+    auto const hash(hash::combine(ns.to_hash(), name.to_hash()));
+    if(auto const found = find<T>(*current.load(std::memory_order_acquire), hash, ns, name))
+    {
+      return found;
+    }
+
+    std::lock_guard<std::mutex> const lock{ mutex };
+    auto t(current.load(std::memory_order_relaxed));
+    /* Someone may have interned it while we were waiting. */
+    if(auto const found = find<T>(*t, hash, ns, name))
+    {
+      return found;
+    }
+
+    /* We keep the load under half, so probe sequences stay short. */
+    if((count + 1) * 2 > t->capacity)
+    {
+      auto const grown(make_table<T>(t->capacity * 2));
+      for(usize i{}; i < t->capacity; ++i)
+      {
+        auto const &s(t->slots[i]);
+        auto const value(s.value.load(std::memory_order_relaxed));
+        if(value)
+        {
+          insert<T>(*grown, s.hash, value);
+        }
+      }
+      current.store(grown, std::memory_order_release);
+      t = grown;
+    }
+
+    auto const value(make_box<T>(must_be_interned{}, ns, name));
+    insert<T>(*t, hash, value.data);
+    ++count;
+    return value;
+  }
+
+  template <typename T>
+  usize intern_table<T>::size() const
+  {
+    std::lock_guard<std::mutex> const lock{ mutex };
+    return count;
+  }
+
+  template struct intern_table<obj::keyword>;
+  template struct intern_table<obj::symbol>;
+}
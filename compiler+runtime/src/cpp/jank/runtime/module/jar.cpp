@@ -0,0 +1,427 @@
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+
+#include <libzippp.h>
+
+#include <jank/runtime/module/jar.hpp>
+#include <jank/util/sha256.hpp>
+#include <jank/util/string_builder.hpp>
+#include <jank/util/fmt.hpp>
+#include <jank/profile/time.hpp>
+
+namespace jank::runtime::module
+{
+  /* See the zip spec (APPNOTE.TXT) for the layout of each of these records. Everything in a
+   * zip is little endian. */
+  static constexpr u32 local_header_signature{ 0x04034b50 };
+  static constexpr usize local_header_size{ 30 };
+  static constexpr u32 central_header_signature{ 0x02014b50 };
+  static constexpr usize central_header_size{ 46 };
+  static constexpr u32 end_of_directory_signature{ 0x06054b50 };
+  static constexpr usize end_of_directory_size{ 22 };
+  static constexpr u32 zip64_locator_signature{ 0x07064b50 };
+  static constexpr usize zip64_locator_size{ 20 };
+  static constexpr u32 zip64_end_of_directory_signature{ 0x06064b50 };
+  static constexpr usize zip64_end_of_directory_size{ 56 };
+  static constexpr u16 zip64_extra_id{ 0x0001 };
+  static constexpr usize max_comment_size{ 0xFFFF };
+
+  static constexpr char const *index_version{ "jank-jar-index 1" };
+
+  static u16 read_u16(char const * const p)
+  {
+    auto const b(reinterpret_cast<unsigned char const *>(p));
+    return static_cast<u16>(b[0] | (b[1] << 8));
+  }
+
+  static u32 read_u32(char const * const p)
+  {
+    return static_cast<u32>(read_u16(p)) | (static_cast<u32>(read_u16(p + 2)) << 16);
+  }
+
+  static u64 read_u64(char const * const p)
+  {
+    return static_cast<u64>(read_u32(p)) | (static_cast<u64>(read_u32(p + 4)) << 32);
+  }
+
+  jar::jar(jtl::immutable_string const &path)
+    : path{ path }
+  {
+  }
+
+  jar::~jar()
+  {
+    unmap();
+  }
+
+  void jar::unmap()
+  {
+    if(head != nullptr)
+    /* NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast): I want const everywhere else. */
+    {
+      munmap(reinterpret_cast<void *>(const_cast<char *>(head)), len);
+      head = nullptr;
+    }
+    if(fd >= 0)
+    {
+      ::close(fd);
+      fd = -1;
+    }
+  }
+
+  jtl::immutable_string
+  jar::index_file(jtl::immutable_string const &path, jtl::immutable_string const &index_dir)
+  {
+    return util::format("{}/jar-index/{}",
+                        index_dir,
+                        util::sha256(std::filesystem::absolute(path.c_str()).native()));
+  }
+
+  jtl::string_result<jar *>
+  jar::open(jtl::immutable_string const &path, jtl::immutable_string const &index_dir)
+  {
+    static std::mutex jars_mutex;
+    static native_unordered_map<jtl::immutable_string, jar *> jars;
+
+    std::lock_guard<std::mutex> const lock{ jars_mutex };
+    auto const found(jars.find(path));
+    if(found != jars.end())
+    {
+      return ok(found->second);
+    }
+
+    profile::timer const timer{ util::format("open jar {}", path) };
+    std::error_code ec;
+    auto const size(std::filesystem::file_size(path.c_str(), ec));
+    if(ec)
+    {
+      return err(util::format("Failed to open jar on module path: {}", path));
+    }
+
+    auto const ret(new(GC) jar{ path });
+    ret->len = size;
+    ret->modified_at = std::filesystem::last_write_time(path.c_str(), ec)
+                         .time_since_epoch()
+                         .count();
+
+    /* NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) */
+    ret->fd = ::open(path.c_str(), O_RDONLY);
+    if(ret->fd < 0)
+    {
+      return err(util::format("Failed to open jar on module path: {}", path));
+    }
+    auto const head(mmap(nullptr, size, PROT_READ, MAP_PRIVATE, ret->fd, 0));
+
+    /* MAP_FAILED is a macro which does a C-style cast. */
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wold-style-cast"
+    /* NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast,performance-no-int-to-ptr) */
+    if(head == MAP_FAILED)
+#pragma clang diagnostic pop
+    {
+      ret->unmap();
+      return err(util::format("Failed to map jar on module path: {}", path));
+    }
+    ret->head = reinterpret_cast<char const *>(head);
+
+    /* Jars are GC allocated without cleanup, so one which isn't kept needs to give up its
+     * file and mapping now, since nothing will later. */
+    if(index_dir.empty())
+    {
+      auto const res(ret->index_central_directory());
+      if(res.is_err())
+      {
+        ret->unmap();
+        return err(res.expect_err());
+      }
+    }
+    else
+    {
+      auto const index(index_file(path, index_dir));
+      if(!ret->read_index(index))
+      {
+        auto const res(ret->index_central_directory());
+        if(res.is_err())
+        {
+          ret->unmap();
+          return err(res.expect_err());
+        }
+        ret->write_index(index);
+      }
+    }
+
+    jars.emplace(path, ret);
+    return ok(ret);
+  }
+
+  jtl::string_result<void> jar::index_central_directory()
+  {
+    if(len < end_of_directory_size)
+    {
+      return err(util::format("Invalid jar on module path: {}", path));
+    }
+
+    /* The end of directory record is last, but it may be followed by a comment. */
+    auto const lowest(len > end_of_directory_size + max_comment_size
+                        ? len - end_of_directory_size - max_comment_size
+                        : 0);
+    jtl::option<usize> end;
+    for(auto i(len - end_of_directory_size);; --i)
+    {
+      if(read_u32(head + i) == end_of_directory_signature)
+      {
+        end = i;
+        break;
+      }
+      if(i == lowest)
+      {
+        break;
+      }
+    }
+    if(end.is_none())
+    {
+      return err(util::format("Invalid jar on module path: {}", path));
+    }
+
+    auto const eod(head + end.unwrap());
+    u64 count{ read_u16(eod + 10) };
+    u64 directory_size{ read_u32(eod + 12) };
+    u64 directory_offset{ read_u32(eod + 16) };
+
+    /* Zip64 archives have the real values in another record, which a locator right before
+     * the end of directory record points to. */
+    auto const locator(end.unwrap() - zip64_locator_size);
+    if(end.unwrap() >= zip64_locator_size
+       && read_u32(head + locator) == zip64_locator_signature)
+    {
+      auto const zip64_end(read_u64(head + locator + 8));
+      if(zip64_end + zip64_end_of_directory_size > len
+         || read_u32(head + zip64_end) != zip64_end_of_directory_signature)
+      {
+        return err(util::format("Invalid zip64 jar on module path: {}", path));
+      }
+      count = read_u64(head + zip64_end + 32);
+      directory_size = read_u64(head + zip64_end + 40);
+      directory_offset = read_u64(head + zip64_end + 48);
+    }
+
+    if(directory_offset + directory_size > len)
+    {
+      return err(util::format("Invalid jar on module path: {}", path));
+    }
+
+    entries.reserve(count);
+    auto offset(directory_offset);
+    for(u64 i{}; i < count; ++i)
+    {
+      if(offset + central_header_size > len
+         || read_u32(head + offset) != central_header_signature)
+      {
+        return err(util::format("Invalid jar on module path: {}", path));
+      }
+
+      auto const header(head + offset);
+      auto const name_size(read_u16(header + 28));
+      auto const extra_size(read_u16(header + 30));
+      auto const comment_size(read_u16(header + 32));
+      if(offset + central_header_size + name_size + extra_size > len)
+      {
+        return err(util::format("Invalid jar on module path: {}", path));
+      }
+
+      entry e{ read_u32(header + 42), read_u32(header + 20), read_u32(header + 24) };
+      e.method = read_u16(header + 10);
+
+      /* Any field which doesn't fit is saturated and the real value is in the zip64 extra
+       * field, in this order, with only the saturated fields present. */
+      static constexpr u32 saturated{ 0xFFFFFFFF };
+      if(e.size == saturated || e.compressed_size == saturated || e.header_offset == saturated)
+      {
+        auto extra(header + central_header_size + name_size);
+        auto const extra_end(extra + extra_size);
+        while(extra + 4 <= extra_end)
+        {
+          auto const id(read_u16(extra));
+          auto const field_size(read_u16(extra + 2));
+          if(id == zip64_extra_id)
+          {
+            auto field(extra + 4);
+            for(auto *value : { &e.size, &e.compressed_size, &e.header_offset })
+            {
+              if(*value == saturated && field + 8 <= extra_end)
+              {
+                *value = read_u64(field);
+                field += 8;
+              }
+            }
+            break;
+          }
+          extra += 4 + field_size;
+        }
+      }
+
+      jtl::immutable_string const name{ header + central_header_size, name_size };
+      if(!name.ends_with('/'))
+      {
+        entries.insert_or_assign(name, e);
+      }
+
+      offset += central_header_size + name_size + extra_size + comment_size;
+    }
+
+    return ok();
+  }
+
+  /* The index is a header line, which must match the JAR's current size and modification
+   * time, followed by a line per entry. */
+  bool jar::read_index(jtl::immutable_string const &index_path)
+  {
+    auto const file(loader::read_file(index_path));
+    if(file.is_err())
+    {
+      return false;
+    }
+
+    auto const expected_header(util::format("{} {} {}\n", index_version, len, modified_at));
+    auto data(file.expect_ok().view());
+    if(!data.starts_with(static_cast<native_persistent_string_view>(expected_header)))
+    {
+      return false;
+    }
+    data.remove_prefix(expected_header.size());
+
+    native_unordered_map<jtl::immutable_string, entry> read_entries;
+    while(!data.empty())
+    {
+      entry e;
+      auto it(data.data());
+      auto const end(data.data() + data.size());
+      for(auto *value : { &e.header_offset, &e.compressed_size, &e.size })
+      {
+        auto const res(std::from_chars(it, end, *value));
+        if(res.ec != std::errc{} || res.ptr == end || *res.ptr != ' ')
+        {
+          return false;
+        }
+        it = res.ptr + 1;
+      }
+      auto const res(std::from_chars(it, end, e.method));
+      if(res.ec != std::errc{} || res.ptr == end || *res.ptr != ' ')
+      {
+        return false;
+      }
+      it = res.ptr + 1;
+
+      auto const newline(std::find(it, end, '\n'));
+      if(newline == end)
+      {
+        return false;
+      }
+      read_entries.insert_or_assign(jtl::immutable_string{ it, static_cast<usize>(newline - it) },
+                                    e);
+      data.remove_prefix(static_cast<usize>(newline + 1 - data.data()));
+    }
+
+    entries = std::move(read_entries);
+    return true;
+  }
+
+  void jar::write_index(jtl::immutable_string const &index_path) const
+  {
+    util::string_builder sb;
+    util::format_to(sb, "{} {} {}\n", index_version, len, modified_at);
+    for(auto const &it : entries)
+    {
+      util::format_to(sb,
+                      "{} {} {} {} {}\n",
+                      it.second.header_offset,
+                      it.second.compressed_size,
+                      it.second.size,
+                      it.second.method,
+                      it.first);
+    }
+
+    /* Processes may share the index dir, so the index only shows up once it's complete. If
+     * it can't be written, we'll just index the JAR again next time. */
+    std::filesystem::path const p{ index_path.c_str() };
+    std::error_code ec;
+    std::filesystem::create_directories(p.parent_path(), ec);
+    std::filesystem::path tmp_path{ p };
+    tmp_path += util::format(".{}.tmp", getpid()).c_str();
+    {
+      std::ofstream out{ tmp_path };
+      out << sb.view();
+      if(!out)
+      {
+        return;
+      }
+    }
+    std::filesystem::rename(tmp_path, p, ec);
+  }
+
+  bool jar::contains(jtl::immutable_string const &name) const
+  {
+    return entries.contains(name);
+  }
+
+  jtl::string_result<file_view> jar::read(jtl::immutable_string const &name)
+  {
+    auto const found(entries.find(name));
+    if(found == entries.end())
+    {
+      return err(util::format("No entry {} within jar {}", name, path));
+    }
+
+    auto const &e(found->second);
+    if(e.method == 0)
+    {
+      if(e.header_offset + local_header_size > len
+         || read_u32(head + e.header_offset) != local_header_signature)
+      {
+        return err(util::format("Invalid entry {} within jar {}", name, path));
+      }
+
+      auto const local_header(head + e.header_offset);
+      auto const data(e.header_offset + local_header_size + read_u16(local_header + 26)
+                      + read_u16(local_header + 28));
+      if(data + e.size > len)
+      {
+        return err(util::format("Invalid entry {} within jar {}", name, path));
+      }
+      return ok(file_view{ head + data, e.size });
+    }
+
+    std::lock_guard<std::mutex> const lock{ mutex };
+    auto const cached(inflated.find(name));
+    if(cached != inflated.end())
+    {
+      return ok(file_view{ cached->second.data(), cached->second.size() });
+    }
+
+    /* libzippp handles every compression method, so we leave that to it. We only ever
+     * open the archive once, though. */
+    if(!archive)
+    {
+      archive = std::make_unique<libzippp::ZipArchive>(std::string{ path });
+      if(!archive->open(libzippp::ZipArchive::ReadOnly))
+      {
+        archive.reset();
+        return err(util::format("Failed to open jar on module path: {}", path));
+      }
+    }
+
+    auto const &zip_entry(archive->getEntry(std::string{ name }));
+    if(zip_entry.isNull())
+    {
+      return err(util::format("No entry {} within jar {}", name, path));
+    }
+    auto const &text(inflated.emplace(name, zip_entry.readAsText()).first->second);
+    return ok(file_view{ text.data(), text.size() });
+  }
+}
@@ -2,14 +2,16 @@
 #include <fcntl.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <charconv>
 #include <filesystem>
-#include <regex>
-
-#include <libzippp.h>
+#include <fstream>
 
 #include <jank/util/process_location.hpp>
 #include <jank/util/fmt/print.hpp>
 #include <jank/util/path.hpp>
+#include <jank/util/sha256.hpp>
+#include <jank/util/string_builder.hpp>
 #include <jank/runtime/core.hpp>
 #include <jank/runtime/core/munge.hpp>
 #include <jank/runtime/core/truthy.hpp>
@@ -22,6 +24,7 @@
 #include <jank/runtime/obj/persistent_sorted_set.hpp>
 #include <jank/runtime/obj/persistent_hash_map.hpp>
 #include <jank/runtime/module/loader.hpp>
+#include <jank/runtime/module/jar.hpp>
 #include <jank/runtime/rtti.hpp>
 #include <jank/profile/time.hpp>
 
@@ -30,15 +33,13 @@ namespace jank::runtime::module
   /* This turns `foo_bar/spam/meow.cljc` into `foo-bar.spam.meow`. */
   jtl::immutable_string path_to_module(std::filesystem::path const &path)
   {
-    static std::regex const slash{ "/" };
-
     auto const &s(runtime::demunge(path.native()));
     std::string ret{ s, 0, s.size() - path.extension().native().size() };
 
     /* There's a special case of the / function which shouldn't be treated as a path. */
     if(ret.find("$/") == std::string::npos)
     {
-      ret = std::regex_replace(ret, slash, ".");
+      std::ranges::replace(ret, '/', '.');
     }
 
     return ret;
@@ -80,20 +81,14 @@ namespace jank::runtime::module
     return module.find('$') != module.rfind('$');
   }
 
-  /* TODO: We can patch libzippp to not copy strings around so much. */
-  template <typename F>
-  static void visit_jar_entry(file_entry const &entry, F const &fn)
+  static jtl::string_result<file_view> read_jar_entry(file_entry const &entry)
   {
-    auto const &path(entry.archive_path.unwrap());
-    libzippp::ZipArchive zf{ std::string{ path } };
-    auto const success(zf.open(libzippp::ZipArchive::ReadOnly));
-    if(!success)
+    auto const j(jar::open(entry.archive_path.unwrap()));
+    if(j.is_err())
     {
-      throw std::runtime_error{ util::format("Failed to open jar on module path: {}", path) };
+      return err(j.expect_err());
     }
-
-    auto const &zip_entry(zf.getEntry(std::string{ entry.path }));
-    fn(zip_entry);
+    return j.expect_ok()->read(entry.path);
   }
 
   static void register_entry(native_unordered_map<jtl::immutable_string, loader::entry> &entries,
@@ -172,43 +167,247 @@ namespace jank::runtime::module
     register_entry(entries, module_path, entry);
   }
 
+  /* A directory on the module path is indexed by the listing of each directory within it,
+   * relative to the root, along with that directory's mtime. A directory's mtime changes
+   * whenever anything is added to it, removed from it, or renamed within it, so a listing
+   * is still valid for as long as its mtime matches. The index is persisted, so startup
+   * only needs to stat each directory and only lists the ones which changed. */
+  struct directory_listing
+  {
+    std::filesystem::file_time_type::rep modified_at{};
+    /* Only the files which could be modules are kept. */
+    native_vector<jtl::immutable_string> files;
+    native_vector<jtl::immutable_string> directories;
+  };
+
+  using directory_index = native_unordered_map<jtl::immutable_string, directory_listing>;
+
+  static constexpr char const *directory_index_version{ "jank-module-index 1" };
+
+  static bool is_module_file(std::filesystem::path const &path)
+  {
+    auto const &ext(path.extension().native());
+    return ext == ".jank" || ext == ".cljc" || ext == ".cpp" || ext == ".o";
+  }
+
+  /* Each directory is a `d <mtime> <path>` line, followed by an `f <name>` line for each
+   * of its files and an `s <name>` line for each of its subdirectories. Anything which
+   * doesn't parse just means the whole directory gets listed again. */
+  static directory_index read_directory_index(jtl::immutable_string const &index_path)
+  {
+    auto const file(loader::read_file(index_path));
+    if(file.is_err())
+    {
+      return {};
+    }
+
+    auto data(file.expect_ok().view());
+    native_persistent_string_view const header{ directory_index_version };
+    if(!data.starts_with(header) || data.size() == header.size() || data[header.size()] != '\n')
+    {
+      return {};
+    }
+    data.remove_prefix(header.size() + 1);
+
+    directory_index index;
+    directory_listing *current{};
+    while(!data.empty())
+    {
+      auto const newline(data.find('\n'));
+      if(newline == native_persistent_string_view::npos)
+      {
+        return {};
+      }
+      auto const line(data.substr(0, newline));
+      data.remove_prefix(newline + 1);
+      if(line.size() < 2 || line[1] != ' ')
+      {
+        return {};
+      }
+
+      auto const rest(line.substr(2));
+      switch(line[0])
+      {
+        case 'd':
+          {
+            auto const space(rest.find(' '));
+            if(space == native_persistent_string_view::npos)
+            {
+              return {};
+            }
+            std::filesystem::file_time_type::rep modified_at{};
+            auto const res(std::from_chars(rest.data(), rest.data() + space, modified_at));
+            if(res.ec != std::errc{})
+            {
+              return {};
+            }
+            current = &index[rest.substr(space + 1)];
+            current->modified_at = modified_at;
+          }
+          break;
+        case 'f':
+          if(!current)
+          {
+            return {};
+          }
+          current->files.emplace_back(rest);
+          break;
+        case 's':
+          if(!current)
+          {
+            return {};
+          }
+          current->directories.emplace_back(rest);
+          break;
+        default:
+          return {};
+      }
+    }
+
+    return index;
+  }
+
   static void
-  register_directory(native_unordered_map<jtl::immutable_string, loader::entry> &entries,
-                     std::filesystem::path const &path)
+  write_directory_index(jtl::immutable_string const &index_path, directory_index const &index)
   {
-    for(auto const &f : std::filesystem::recursive_directory_iterator{ path })
+    util::string_builder sb;
+    sb(directory_index_version)('\n');
+    for(auto const &it : index)
     {
-      if(std::filesystem::is_regular_file(f))
+      util::format_to(sb, "d {} {}\n", it.second.modified_at, it.first);
+      for(auto const &f : it.second.files)
       {
-        register_relative_entry(entries, path, file_entry{ none, f.path().native() });
+        sb("f ")(f)('\n');
+      }
+      for(auto const &d : it.second.directories)
+      {
+        sb("s ")(d)('\n');
+      }
+    }
+
+    /* Processes may share the index dir, so the index only shows up once it's complete. If
+     * it can't be written, we'll just list everything again next time. */
+    std::filesystem::path const p{ index_path.c_str() };
+    std::error_code ec;
+    std::filesystem::create_directories(p.parent_path(), ec);
+    std::filesystem::path tmp_path{ p };
+    tmp_path += util::format(".{}.tmp", getpid()).c_str();
+    {
+      std::ofstream out{ tmp_path };
+      out << sb.view();
+      if(!out)
+      {
+        return;
       }
     }
+    std::filesystem::rename(tmp_path, p, ec);
   }
 
-  static void register_jar(native_unordered_map<jtl::immutable_string, loader::entry> &entries,
-                           jtl::immutable_string const &path)
+  /* Stats the directory and lists it again if its mtime changed, then does the same for
+   * each of its subdirectories. Like recursive_directory_iterator, symlinks to directories
+   * aren't followed. */
+  static void scan_directory(std::filesystem::path const &root,
+                             jtl::immutable_string const &relative,
+                             directory_index const &previous,
+                             directory_index &index,
+                             bool &changed)
   {
-    libzippp::ZipArchive zf{ std::string{ path } };
-    auto success(zf.open(libzippp::ZipArchive::ReadOnly));
-    if(!success)
+    auto const dir(relative.empty() ? root : root / relative.c_str());
+    std::error_code ec;
+    auto const modified_at(std::filesystem::last_write_time(dir, ec).time_since_epoch().count());
+    if(ec)
     {
-      //util::println(stderr, "Failed to open jar on module path: {}\n", path);
       return;
     }
 
-    auto const &zip_entries(zf.getEntries());
-    for(auto const &entry : zip_entries)
+    directory_listing listing;
+    listing.modified_at = modified_at;
+    auto const found(previous.find(relative));
+    if(found != previous.end() && found->second.modified_at == modified_at)
+    {
+      listing.files = found->second.files;
+      listing.directories = found->second.directories;
+    }
+    else
     {
-      auto const &name(entry.getName());
-      if(!entry.isDirectory())
+      for(auto const &f : std::filesystem::directory_iterator{ dir, ec })
       {
-        register_entry(entries, name, { path, name });
+        auto const &name(f.path().filename().native());
+        if(f.is_directory(ec) && !f.is_symlink(ec))
+        {
+          listing.directories.emplace_back(name);
+        }
+        else if(f.is_regular_file(ec) && is_module_file(f.path()))
+        {
+          listing.files.emplace_back(name);
+        }
+      }
+
+      /* Sorting keeps listings comparable, since the order of a listing isn't stable. An
+       * mtime change which didn't change the listing doesn't warrant a new index. */
+      std::sort(listing.files.begin(), listing.files.end());
+      std::sort(listing.directories.begin(), listing.directories.end());
+      changed = changed || found == previous.end() || found->second.files != listing.files
+        || found->second.directories != listing.directories;
+    }
+
+    for(auto const &d : listing.directories)
+    {
+      scan_directory(root,
+                     relative.empty() ? d : util::format("{}/{}", relative, d),
+                     previous,
+                     index,
+                     changed);
+    }
+    index.insert_or_assign(relative, std::move(listing));
+  }
+
+  static void
+  register_directory(native_unordered_map<jtl::immutable_string, loader::entry> &entries,
+                     std::filesystem::path const &path,
+                     jtl::immutable_string const &index_dir)
+  {
+    profile::timer const timer{ util::format("register directory {}", path.native()) };
+    auto const index_path(loader::directory_index_file(path, index_dir));
+    auto const previous(read_directory_index(index_path));
+    directory_index index;
+    bool changed{};
+    scan_directory(path, "", previous, index, changed);
+    if(changed || index.size() != previous.size())
+    {
+      write_directory_index(index_path, index);
+    }
+
+    for(auto const &it : index)
+    {
+      auto const dir(it.first.empty() ? path : path / it.first.c_str());
+      for(auto const &f : it.second.files)
+      {
+        register_relative_entry(entries, path, file_entry{ none, (dir / f.c_str()).native() });
       }
     }
   }
 
+  static void register_jar(native_unordered_map<jtl::immutable_string, loader::entry> &entries,
+                           jtl::immutable_string const &path,
+                           jtl::immutable_string const &index_dir)
+  {
+    auto const j(jar::open(path, index_dir));
+    if(j.is_err())
+    {
+      //util::println(stderr, "{}\n", j.expect_err());
+      return;
+    }
+
+    for(auto const &it : j.expect_ok()->entries)
+    {
+      register_entry(entries, native_transient_string{ it.first }, { path, it.first });
+    }
+  }
+
   static void register_path(native_unordered_map<jtl::immutable_string, loader::entry> &entries,
-                            native_persistent_string_view const &path)
+                            native_persistent_string_view const &path,
+                            jtl::immutable_string const &index_dir)
   {
     /* It's entirely possible to have empty entries in the module path, mainly due to lazy string
      * concatenation. We just ignore them. This means something like "::::" is valid. */
@@ -220,11 +419,11 @@ namespace jank::runtime::module
     std::filesystem::path const p{ std::filesystem::canonical(path).lexically_normal() };
     if(std::filesystem::is_directory(p))
     {
-      register_directory(entries, p);
+      register_directory(entries, p, index_dir);
     }
     else if(p.extension().native() == ".jar")
     {
-      register_jar(entries, path);
+      register_jar(entries, path, index_dir);
     }
     /* If it's not a JAR or a directory, we just add it as a direct file entry. I don't think the
      * JVM supports this, but I like that it allows us to put specific files in the path. */
@@ -235,6 +434,12 @@ namespace jank::runtime::module
     }
   }
 
+  jtl::immutable_string loader::directory_index_file(std::filesystem::path const &path,
+                                                     jtl::immutable_string const &index_dir)
+  {
+    return util::format("{}/module-index/{}", index_dir, util::sha256(path.native()));
+  }
+
   loader::loader(context &rt_ctx, jtl::immutable_string const &ps)
     : rt_ctx{ rt_ctx }
   {
@@ -253,19 +458,19 @@ namespace jank::runtime::module
     /* Looks like it's either an empty path list or there's only entry. */
     if(i == jtl::immutable_string::npos)
     {
-      register_path(entries, paths);
+      register_path(entries, paths, rt_ctx.binary_cache_dir);
     }
     else
     {
       while(i != jtl::immutable_string::npos)
       {
-        register_path(entries, paths.substr(start, i - start));
+        register_path(entries, paths.substr(start, i - start), rt_ctx.binary_cache_dir);
 
         start = i + 1;
         i = paths.find(module_separator, start);
       }
 
-      register_path(entries, paths.substr(start, i - start));
+      register_path(entries, paths.substr(start, i - start), rt_ctx.binary_cache_dir);
     }
   }
 
@@ -292,7 +497,8 @@ namespace jank::runtime::module
       bool source_exists{};
       if(is_archive)
       {
-        visit_jar_entry(*this, [&](auto const &zip_entry) { source_exists = zip_entry.isFile(); });
+        auto const j(jar::open(archive_path.unwrap()));
+        source_exists = j.is_ok() && j.expect_ok()->contains(path);
       }
 
       return source_exists || std::filesystem::exists(native_transient_string{ path });
@@ -312,16 +518,25 @@ namespace jank::runtime::module
     : fd{ mf.fd }
     , head{ mf.head }
     , len{ mf.len }
+    , owns_head{ mf.owns_head }
     , buff{ std::move(mf.buff) }
   {
     mf.fd = -1;
     mf.head = nullptr;
+    mf.owns_head = false;
   }
 
   file_view::file_view(int const f, char const * const h, usize const s)
     : fd{ f }
     , head{ h }
     , len{ s }
+    , owns_head{ true }
+  {
+  }
+
+  file_view::file_view(char const * const h, usize const s)
+    : head{ h }
+    , len{ s }
   {
   }
 
@@ -332,7 +547,7 @@ namespace jank::runtime::module
 
   file_view::~file_view()
   {
-    if(head != nullptr)
+    if(owns_head && head != nullptr)
     /* NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast): I want const everywhere else. */
     {
       munmap(reinterpret_cast<void *>(const_cast<char *>(head)), len);
@@ -373,15 +588,7 @@ namespace jank::runtime::module
       return err(found_module.expect_err());
     }
 
-    libzippp::ZipArchive zf{ std::string{ jar_path } };
-    auto const success{ zf.open(libzippp::ZipArchive::ReadOnly) };
-    if(!success)
-    {
-      return err(util::format("Failed to open jar on module path: {}", path));
-    }
-
-    auto const &zip_entry{ zf.getEntry(std::string{ file_path }) };
-    return ok(file_view{ zip_entry.readAsText() });
+    return read_jar_entry({ jar_path, file_path });
   }
 
   static jtl::string_result<file_view> map_file(jtl::immutable_string const &path)
@@ -425,9 +632,8 @@ namespace jank::runtime::module
   jtl::string_result<loader::find_result>
   loader::find(jtl::immutable_string const &module, origin const ori)
   {
-    static std::regex const underscore{ "_" };
     native_transient_string patched_module{ module };
-    patched_module = std::regex_replace(patched_module, underscore, "-");
+    std::ranges::replace(patched_module, '_', '-');
     auto const &entry(entries.find(patched_module));
     if(entry == entries.end())
     {
@@ -702,9 +908,15 @@ namespace jank::runtime::module
   {
     if(entry.archive_path.is_some())
     {
-      visit_jar_entry(entry, [&](auto const &zip_entry) {
-        rt_ctx.eval_cpp_string(zip_entry.readAsText());
-      });
+      auto const file(read_jar_entry(entry));
+      if(file.is_err())
+      {
+        return err(util::format("Unable to read {} from jar {} due to error: {}",
+                                entry.path,
+                                entry.archive_path.unwrap(),
+                                file.expect_err()));
+      }
+      rt_ctx.eval_cpp_string(file.expect_ok().view());
     }
     else
     {
@@ -731,15 +943,22 @@ namespace jank::runtime::module
   {
     if(entry.archive_path.is_some())
     {
-      visit_jar_entry(entry, [&](auto const &zip_entry) {
-        /* TODO: Helper to get a jar file path like this. */
-        auto const path{ util::format("{}:{}", entry.archive_path.unwrap(), entry.path) };
-        context::binding_scope const preserve{ rt_ctx,
-                                               runtime::obj::persistent_hash_map::create_unique(
-                                                 std::make_pair(rt_ctx.current_file_var,
-                                                                make_box(path))) };
-        rt_ctx.eval_string(zip_entry.readAsText());
-      });
+      auto const file(read_jar_entry(entry));
+      if(file.is_err())
+      {
+        return err(util::format("Unable to read {} from jar {} due to error: {}",
+                                entry.path,
+                                entry.archive_path.unwrap(),
+                                file.expect_err()));
+      }
+
+      /* TODO: Helper to get a jar file path like this. */
+      auto const path{ util::format("{}:{}", entry.archive_path.unwrap(), entry.path) };
+      context::binding_scope const preserve{ rt_ctx,
+                                             runtime::obj::persistent_hash_map::create_unique(
+                                               std::make_pair(rt_ctx.current_file_var,
+                                                              make_box(path))) };
+      rt_ctx.eval_string(file.expect_ok().view());
     }
     else
     {
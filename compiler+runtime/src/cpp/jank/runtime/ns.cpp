@@ -17,7 +17,7 @@ namespace jank::runtime
 
   var_ref ns::intern_var(native_persistent_string_view const &name)
   {
-    return intern_var(make_box<obj::symbol>(name));
+    return intern_var(rt_ctx.intern_symbol(name));
   }
 
   var_ref ns::intern_var(obj::symbol_ref const &sym)
@@ -25,7 +25,7 @@ namespace jank::runtime
     obj::symbol_ref unqualified_sym{ sym };
     if(!unqualified_sym->ns.empty())
     {
-      unqualified_sym = make_box<obj::symbol>("", sym->name);
+      unqualified_sym = rt_ctx.intern_symbol("", sym->name);
     }
 
     /* TODO: Read lock, then upgrade as needed? Benchmark. */
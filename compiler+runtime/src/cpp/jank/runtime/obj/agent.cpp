@@ -0,0 +1,480 @@
+#include <chrono>
+
+#include <jank/runtime/obj/agent.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/runtime/obj/cons.hpp>
+#include <jank/runtime/obj/persistent_string.hpp>
+#include <jank/runtime/behavior/callable.hpp>
+#include <jank/runtime/core.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/seq.hpp>
+#include <jank/runtime/core/to_string.hpp>
+#include <jank/runtime/core/truthy.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/thread_pool.hpp>
+#include <jank/runtime/rtti.hpp>
+#include <jank/util/fmt.hpp>
+#include <jank/util/scope_exit.hpp>
+#include <jank/error.hpp>
+
+namespace jank::runtime::obj
+{
+  struct held_send
+  {
+    agent *target{};
+    agent_action *action{};
+  };
+
+  /* The sends made by the action which is running on this thread, if any. These are held
+   * until the action has finished successfully. The vector lives on the stack of the
+   * running action, so the GC can see it. */
+  static thread_local native_vector<held_send> *held_sends{};
+
+  static void execute_agent(object_ref const o)
+  {
+    expect_object<agent>(o)->execute();
+  }
+
+  agent_latch::agent_latch(usize const count)
+    : count{ count }
+  {
+  }
+
+  void agent_latch::count_down()
+  {
+    {
+      std::lock_guard<std::mutex> const lock{ mutex };
+      --count;
+    }
+    cv.notify_all();
+  }
+
+  void agent_latch::wait()
+  {
+    std::unique_lock<std::mutex> lock{ mutex };
+    cv.wait(lock, [this]() { return count == 0; });
+  }
+
+  bool agent_latch::wait_for(i64 const timeout_ms)
+  {
+    std::unique_lock<std::mutex> lock{ mutex };
+    return cv.wait_for(lock, std::chrono::milliseconds{ timeout_ms }, [this]() {
+      return count == 0;
+    });
+  }
+
+  agent::agent(object_ref const state)
+    : state{ state.data }
+    , validator{ jank_nil.erase() }
+    , watches{ persistent_hash_map::empty().erase() }
+    , error{ jank_nil.erase() }
+    , error_handler{ jank_nil.erase() }
+  {
+  }
+
+  bool agent::equal(object const &o) const
+  {
+    return &o == &base;
+  }
+
+  jtl::immutable_string agent::to_string() const
+  {
+    util::string_builder buff;
+    to_string(buff);
+    return buff.release();
+  }
+
+  void agent::to_string(util::string_builder &buff) const
+  {
+    util::format_to(buff, "{}@{}", object_type_str(base.type), &base);
+  }
+
+  jtl::immutable_string agent::to_code_string() const
+  {
+    return to_string();
+  }
+
+  uhash agent::to_hash() const
+  {
+    return static_cast<uhash>(reinterpret_cast<uintptr_t>(this));
+  }
+
+  object_ref agent::deref() const
+  {
+    return state.load();
+  }
+
+  void agent::validate(object_ref const fn, object_ref const new_state) const
+  {
+    if(fn.is_some() && !truthy(dynamic_call(fn, new_state)))
+    {
+      throw std::runtime_error{ "Invalid reference state" };
+    }
+  }
+
+  void agent::set_validator(object_ref const fn)
+  {
+    validate(fn, state.load());
+    validator.store(fn.data);
+  }
+
+  object_ref agent::get_validator() const
+  {
+    return validator.load();
+  }
+
+  void agent::add_watch(object_ref const key, object_ref const fn)
+  {
+    while(true)
+    {
+      auto w(watches.load());
+      auto const next(expect_object<persistent_hash_map>(w)->assoc(key, fn));
+      if(watches.compare_exchange_weak(w, next.erase()))
+      {
+        return;
+      }
+    }
+  }
+
+  void agent::remove_watch(object_ref const key)
+  {
+    while(true)
+    {
+      auto w(watches.load());
+      auto const next(expect_object<persistent_hash_map>(w)->dissoc(key));
+      if(watches.compare_exchange_weak(w, next.erase()))
+      {
+        return;
+      }
+    }
+  }
+
+  void agent::notify_watches(object_ref const old_state, object_ref const new_state)
+  {
+    auto const w(expect_object<persistent_hash_map>(watches.load()));
+    for(auto it(w->fresh_seq()); it.is_some(); it = it->next_in_place())
+    {
+      auto const entry(it->first());
+      dynamic_call(entry->data[1], entry->data[0], this, old_state, new_state);
+    }
+  }
+
+  agent_ref
+  agent::dispatch(object_ref const fn, object_ref const args, agent_executor const executor)
+  {
+    object_ref const e{ error.load() };
+    if(e.is_some())
+    {
+      throw std::runtime_error{ util::format("Agent is failed, needs restart: {}",
+                                             runtime::to_code_string(e)) };
+    }
+
+    auto const action(new(GC) agent_action{});
+    action->fn = fn;
+    action->args = args;
+    action->executor = executor;
+    action->bindings = __rt_ctx->capture_thread_bindings();
+
+    if(held_sends)
+    {
+      held_sends->push_back({ this, action });
+    }
+    else
+    {
+      enqueue(action);
+    }
+    return this;
+  }
+
+  void agent::enqueue(agent_action * const action)
+  {
+    auto head(incoming.load());
+    do
+    {
+      action->next = head;
+    } while(!incoming.compare_exchange_weak(head, action));
+
+    /* Whoever takes the pending count up from zero owns the agent until it's drained. */
+    if(pending.fetch_add(1) == 0)
+    {
+      schedule();
+    }
+  }
+
+  /* Moves everything which has been sent into the ready queue. The incoming stack is
+   * newest first, so it's reversed along the way. */
+  static void take_incoming(agent &a)
+  {
+    auto head(a.incoming.exchange(nullptr));
+    agent_action *reversed{};
+    while(head)
+    {
+      auto const next(head->next);
+      head->next = reversed;
+      reversed = head;
+      head = next;
+    }
+    for(; reversed; reversed = reversed->next)
+    {
+      a.ready.push_back(reversed);
+    }
+  }
+
+  void agent::schedule()
+  {
+    take_incoming(*this);
+    jank_debug_assert(!ready.empty());
+
+    if(ready.front()->executor == agent_executor::send_off)
+    {
+      default_cached_thread_pool().submit(&execute_agent, this);
+    }
+    else
+    {
+      default_thread_pool().submit(&execute_agent, this);
+    }
+  }
+
+  /* Actions can throw anything which jank code or the runtime throws. Whatever it was, it
+   * needs to be an object, since that's what error handlers and agent-error see. */
+  static object_ref current_error()
+  {
+    try
+    {
+      throw;
+    }
+    catch(std::exception const &e)
+    {
+      return make_box(e.what());
+    }
+    catch(object_ref const e)
+    {
+      return e;
+    }
+    catch(object * const e)
+    {
+      return e;
+    }
+    catch(jtl::immutable_string const &e)
+    {
+      return make_box<persistent_string>(e);
+    }
+    catch(error_ref const e)
+    {
+      return make_box<persistent_string>(e->message);
+    }
+    catch(...)
+    {
+      return make_box("Unknown exception thrown from agent action");
+    }
+  }
+
+  void agent::execute()
+  {
+    take_incoming(*this);
+    auto const action(ready.front());
+    ready.pop_front();
+
+    /* However we leave, the action is done and the next one gets scheduled, unless the
+     * agent has failed. A failed agent stays owned by us until it's restarted. */
+    bool failed{};
+    util::scope_exit const done{ [&]() {
+      if(!failed && pending.fetch_sub(1) > 1)
+      {
+        schedule();
+      }
+    } };
+
+    if(action->latch)
+    {
+      action->latch->count_down();
+      return;
+    }
+
+    native_vector<held_send> sends;
+    object_ref err;
+    {
+      auto const prev_sends(held_sends);
+      held_sends = &sends;
+      util::scope_exit const restore_sends{ [=]() { held_sends = prev_sends; } };
+
+      try
+      {
+        context::binding_scope const conveyed{ *__rt_ctx, action->bindings };
+        context::binding_scope const scope{ *__rt_ctx,
+                                            persistent_hash_map::create_unique(
+                                              std::make_pair(__rt_ctx->agent_var, agent_ref{ this })) };
+
+        object_ref const old_state{ state.load() };
+        auto const new_state(apply_to(action->fn, make_box<cons>(old_state, action->args)));
+        validate(validator.load(), new_state);
+        state.store(new_state.data);
+        notify_watches(old_state, new_state);
+      }
+      catch(...)
+      {
+        err = current_error();
+      }
+    }
+
+    if(err.is_nil())
+    {
+      for(auto const &send : sends)
+      {
+        send.target->enqueue(send.action);
+      }
+      return;
+    }
+
+    /* Sends from a failed action are dropped. */
+    object_ref const handler{ error_handler.load() };
+    if(handler.is_some())
+    {
+      try
+      {
+        dynamic_call(handler, this, err);
+      }
+      catch(...)
+      {
+        /* The handler's own errors are ignored, like in Clojure. */
+      }
+    }
+
+    if(error_mode.load() == agent_error_mode::fail)
+    {
+      /* We keep ownership of the agent, by not counting this action as done. That holds
+       * every queued action until restart, which takes ownership from us. */
+      error.store(err.data);
+      failed = true;
+    }
+  }
+
+  object_ref agent::restart(object_ref const new_state, bool const clear_actions)
+  {
+    object_ref const e{ error.load() };
+    if(e.is_nil())
+    {
+      throw std::runtime_error{ "Agent does not need a restart" };
+    }
+
+    validate(validator.load(), new_state);
+
+    auto expected(e.data);
+    if(!error.compare_exchange_strong(expected, jank_nil.erase()))
+    {
+      throw std::runtime_error{ "Agent does not need a restart" };
+    }
+    state.store(new_state.data);
+
+    /* Whoever failed the agent left it owned, so we own it now. */
+    if(clear_actions)
+    {
+      take_incoming(*this);
+      usize cleared{};
+      for(auto const action : ready)
+      {
+        /* Nobody should be stuck in await because of this. */
+        if(action->latch)
+        {
+          action->latch->count_down();
+        }
+        ++cleared;
+      }
+      ready.clear();
+      pending.fetch_sub(cleared);
+    }
+
+    if(pending.fetch_sub(1) > 1)
+    {
+      schedule();
+    }
+
+    return new_state;
+  }
+
+  object_ref agent::get_error() const
+  {
+    return error.load();
+  }
+
+  usize agent::queue_count() const
+  {
+    return pending.load();
+  }
+
+  void agent::set_error_handler(object_ref const fn)
+  {
+    error_handler.store(fn.data);
+  }
+
+  object_ref agent::get_error_handler() const
+  {
+    return error_handler.load();
+  }
+
+  void agent::set_error_mode(agent_error_mode const mode)
+  {
+    error_mode.store(mode);
+  }
+
+  agent_error_mode agent::get_error_mode() const
+  {
+    return error_mode.load();
+  }
+
+  static agent_latch *send_latch(object_ref const agents)
+  {
+    if(held_sends)
+    {
+      throw std::runtime_error{ "Can't await in agent action" };
+    }
+
+    auto const latch(new(GC) agent_latch{ sequence_length(agents) });
+    for(auto it(fresh_seq(agents)); it.is_some(); it = next_in_place(it))
+    {
+      auto const a(try_object<agent>(first(it)));
+      object_ref const e{ a->error.load() };
+      if(e.is_some())
+      {
+        throw std::runtime_error{ util::format("Agent is failed, needs restart: {}",
+                                               runtime::to_code_string(e)) };
+      }
+      auto const action(new(GC) agent_action{});
+      action->latch = latch;
+      a->enqueue(action);
+    }
+    return latch;
+  }
+
+  void agent::await(object_ref const agents)
+  {
+    send_latch(agents)->wait();
+  }
+
+  bool agent::await_for(i64 const timeout_ms, object_ref const agents)
+  {
+    return send_latch(agents)->wait_for(timeout_ms);
+  }
+
+  usize agent::release_pending_sends()
+  {
+    if(!held_sends)
+    {
+      return 0;
+    }
+
+    auto const sends(std::move(*held_sends));
+    held_sends->clear();
+    for(auto const &send : sends)
+    {
+      send.target->enqueue(send.action);
+    }
+    return sends.size();
+  }
+
+  void shutdown_agents()
+  {
+    default_thread_pool().shutdown();
+    default_cached_thread_pool().shutdown();
+  }
+}
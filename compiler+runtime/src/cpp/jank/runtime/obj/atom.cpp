@@ -1,5 +1,8 @@
 #include <jank/runtime/obj/atom.hpp>
 #include <jank/runtime/obj/persistent_vector.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/runtime/core/truthy.hpp>
+#include <jank/runtime/rtti.hpp>
 #include <jank/runtime/behavior/callable.hpp>
 #include <jank/runtime/core.hpp>
 #include <jank/util/fmt.hpp>
@@ -8,6 +11,8 @@ namespace jank::runtime::obj
 {
   atom::atom(object_ref const o)
     : val{ o.data }
+    , validator{ jank_nil.erase() }
+    , watches{ persistent_hash_map::empty().erase() }
   {
   }
 
@@ -43,25 +48,82 @@ namespace jank::runtime::obj
     return val.load();
   }
 
-  object_ref atom::reset(object_ref const o)
+  void atom::validate(object_ref const new_state) const
   {
-    jank_debug_assert(o.is_some());
-    val = o.data;
-    return o;
+    object_ref const fn{ validator.load() };
+    if(fn.is_some() && !truthy(dynamic_call(fn, new_state)))
+    {
+      throw std::runtime_error{ "Invalid reference state" };
+    }
   }
 
-  persistent_vector_ref atom::reset_vals(object_ref const o)
+  void atom::set_validator(object_ref const fn)
+  {
+    if(fn.is_some() && !truthy(dynamic_call(fn, val.load())))
+    {
+      throw std::runtime_error{ "Invalid reference state" };
+    }
+    validator.store(fn.data);
+  }
+
+  object_ref atom::get_validator() const
+  {
+    return validator.load();
+  }
+
+  void atom::add_watch(object_ref const key, object_ref const fn)
   {
     while(true)
     {
-      auto v(val.load());
-      if(val.compare_exchange_weak(v, o.data))
+      auto w(watches.load());
+      auto const next(expect_object<persistent_hash_map>(w)->assoc(key, fn));
+      if(watches.compare_exchange_weak(w, next.erase()))
+      {
+        return;
+      }
+    }
+  }
+
+  void atom::remove_watch(object_ref const key)
+  {
+    while(true)
+    {
+      auto w(watches.load());
+      auto const next(expect_object<persistent_hash_map>(w)->dissoc(key));
+      if(watches.compare_exchange_weak(w, next.erase()))
       {
-        return make_box<persistent_vector>(std::in_place, v, o);
+        return;
       }
     }
   }
 
+  void atom::notify_watches(object_ref const old_state, object_ref const new_state)
+  {
+    auto const w(expect_object<persistent_hash_map>(watches.load()));
+    for(auto it(w->fresh_seq()); it.is_some(); it = it->next_in_place())
+    {
+      auto const entry(it->first());
+      dynamic_call(entry->data[1], entry->data[0], this, old_state, new_state);
+    }
+  }
+
+  object_ref atom::reset(object_ref const o)
+  {
+    jank_debug_assert(o.is_some());
+    validate(o);
+    auto const old(val.exchange(o.data));
+    notify_watches(old, o);
+    return o;
+  }
+
+  persistent_vector_ref atom::reset_vals(object_ref const o)
+  {
+    validate(o);
+    auto const old(val.exchange(o.data));
+    notify_watches(old, o);
+    return make_box<persistent_vector>(std::in_place, old, o);
+  }
+
   /* NOLINTNEXTLINE(cppcoreguidelines-noexcept-swap) */
   object_ref atom::swap(object_ref const fn)
   {
@@ -69,8 +131,10 @@ namespace jank::runtime::obj
     {
       auto v(val.load());
       auto const next(dynamic_call(fn, v));
+      validate(next);
       if(val.compare_exchange_weak(v, next.data))
       {
+        notify_watches(v, next);
         return next;
       }
     }
@@ -83,8 +147,10 @@ namespace jank::runtime::obj
     {
       auto v(val.load());
       auto const next(dynamic_call(fn, v, a1));
+      validate(next);
       if(val.compare_exchange_weak(v, next.data))
       {
+        notify_watches(v, next);
         return next;
       }
     }
@@ -97,8 +163,10 @@ namespace jank::runtime::obj
     {
       auto v(val.load());
       auto const next(dynamic_call(fn, v, a1, a2));
+      validate(next);
       if(val.compare_exchange_weak(v, next.data))
       {
+        notify_watches(v, next);
         return next;
       }
     }
@@ -112,8 +180,10 @@ namespace jank::runtime::obj
     {
       auto v(val.load());
       auto const next(apply_to(fn, conj(a1, conj(a2, rest))));
+      validate(next);
       if(val.compare_exchange_weak(v, next.data))
       {
+        notify_watches(v, next);
         return next;
       }
     }
@@ -125,8 +195,10 @@ namespace jank::runtime::obj
     {
       auto v(val.load());
       auto const next(dynamic_call(fn, v));
+      validate(next);
       if(val.compare_exchange_weak(v, next.data))
       {
+        notify_watches(v, next);
         return make_box<persistent_vector>(std::in_place, v, next);
       }
     }
@@ -138,8 +210,10 @@ namespace jank::runtime::obj
     {
       auto v(val.load());
       auto const next(dynamic_call(fn, v, a1));
+      validate(next);
       if(val.compare_exchange_weak(v, next.data))
       {
+        notify_watches(v, next);
         return make_box<persistent_vector>(std::in_place, v, next);
       }
     }
@@ -152,8 +226,10 @@ namespace jank::runtime::obj
     {
       auto v(val.load());
       auto const next(dynamic_call(fn, v, a1, a2));
+      validate(next);
       if(val.compare_exchange_weak(v, next.data))
       {
+        notify_watches(v, next);
         return make_box<persistent_vector>(std::in_place, v, next);
       }
     }
@@ -168,8 +244,10 @@ namespace jank::runtime::obj
     {
       auto v(val.load());
       auto const next(apply_to(fn, conj(a1, conj(a2, rest))));
+      validate(next);
       if(val.compare_exchange_weak(v, next.data))
       {
+        notify_watches(v, next);
         return make_box<persistent_vector>(std::in_place, v, next);
       }
     }
@@ -177,7 +255,13 @@ namespace jank::runtime::obj
 
   object_ref atom::compare_and_set(object_ref const old_val, object_ref const new_val)
   {
+    validate(new_val);
     object *old{ old_val.data };
-    return make_box(val.compare_exchange_weak(old, new_val.data));
+    if(!val.compare_exchange_strong(old, new_val.data))
+    {
+      return jank_false;
+    }
+    notify_watches(old_val, new_val);
+    return jank_true;
   }
 }
@@ -1,3 +1,7 @@
+#include <array>
+#include <limits>
+#include <utility>
+
 #include <jank/runtime/obj/character.hpp>
 #include <jank/runtime/rtti.hpp>
 #include <jank/util/escape.hpp>
@@ -74,3 +78,20 @@ namespace jank::runtime::obj
     return data.to_hash();
   }
 }
+
+namespace jank::runtime
+{
+  template <usize... Is>
+  static std::array<obj::character, sizeof...(Is)>
+  make_character_cache(std::index_sequence<Is...> const)
+  {
+    return { obj::character{ static_cast<char>(Is) }... };
+  }
+
+  obj::character_ref cached_character(char const ch)
+  {
+    static auto cache{ make_character_cache(
+      std::make_index_sequence<std::numeric_limits<unsigned char>::max() + 1>{}) };
+    return &cache[static_cast<unsigned char>(ch)];
+  }
+}
@@ -0,0 +1,173 @@
+#include <chrono>
+
+#include <jank/runtime/obj/future.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/runtime/behavior/callable.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/thread_pool.hpp>
+#include <jank/runtime/rtti.hpp>
+#include <jank/util/fmt.hpp>
+
+namespace jank::runtime::obj
+{
+  static bool is_finished(future_state const state)
+  {
+    return state == future_state::done || state == future_state::failed
+      || state == future_state::cancelled;
+  }
+
+  static void run_future(object_ref const o)
+  {
+    expect_object<future>(o)->run();
+  }
+
+  future::future(object_ref const fn, thread_binding_frame const * const bindings)
+    : fn{ fn }
+    , bindings{ bindings }
+  {
+  }
+
+  future_ref future::create(object_ref const fn)
+  {
+    auto const ret(make_box<future>(fn, __rt_ctx->capture_thread_bindings()));
+    default_thread_pool().submit(&run_future, ret);
+    return ret;
+  }
+
+  bool future::equal(object const &o) const
+  {
+    return &o == &base;
+  }
+
+  jtl::immutable_string future::to_string() const
+  {
+    util::string_builder buff;
+    to_string(buff);
+    return buff.release();
+  }
+
+  void future::to_string(util::string_builder &buff) const
+  {
+    util::format_to(buff, "{}@{}", object_type_str(base.type), &base);
+  }
+
+  jtl::immutable_string future::to_code_string() const
+  {
+    return to_string();
+  }
+
+  uhash future::to_hash() const
+  {
+    return static_cast<uhash>(reinterpret_cast<uintptr_t>(this));
+  }
+
+  void future::run()
+  {
+    auto expected(future_state::pending);
+    if(!state.compare_exchange_strong(expected, future_state::running))
+    {
+      return;
+    }
+
+    auto result(future_state::done);
+    try
+    {
+      context::binding_scope const scope{ *__rt_ctx, bindings };
+      val = dynamic_call(fn);
+    }
+    catch(std::exception const &e)
+    {
+      error = make_box(e.what());
+      result = future_state::failed;
+    }
+    catch(object_ref const e)
+    {
+      error = e;
+      result = future_state::failed;
+    }
+    catch(...)
+    {
+      native_error = std::current_exception();
+      result = future_state::failed;
+    }
+
+    {
+      std::lock_guard<std::mutex> const lock{ mutex };
+      /* The fn and bindings are no longer needed, so we let the GC have them. */
+      fn = jank_nil;
+      bindings = nullptr;
+      state.store(result);
+    }
+    cv.notify_all();
+  }
+
+  object_ref future::deref()
+  {
+    /* If nobody has picked this up yet, there's no sense in waiting for them. This is
+     * also what keeps a pool worker, which is derefing a future queued behind it, from
+     * deadlocking. */
+    if(state.load() == future_state::pending)
+    {
+      run();
+    }
+
+    std::unique_lock<std::mutex> lock{ mutex };
+    cv.wait(lock, [this]() { return is_finished(state.load()); });
+
+    switch(state.load())
+    {
+      case future_state::done:
+        return val;
+      case future_state::cancelled:
+        throw std::runtime_error{ "Unable to deref a cancelled future." };
+      default:
+        if(native_error)
+        {
+          std::rethrow_exception(native_error);
+        }
+        throw error;
+    }
+  }
+
+  object_ref future::deref(i64 const timeout_ms, object_ref const timeout_val)
+  {
+    {
+      std::unique_lock<std::mutex> lock{ mutex };
+      if(!cv.wait_for(lock, std::chrono::milliseconds{ timeout_ms }, [this]() {
+           return is_finished(state.load());
+         }))
+      {
+        return timeout_val;
+      }
+    }
+
+    return deref();
+  }
+
+  bool future::is_realized() const
+  {
+    return is_finished(state.load());
+  }
+
+  bool future::cancel()
+  {
+    auto expected(future_state::pending);
+    {
+      std::lock_guard<std::mutex> const lock{ mutex };
+      if(!state.compare_exchange_strong(expected, future_state::cancelled))
+      {
+        return false;
+      }
+      fn = jank_nil;
+      bindings = nullptr;
+    }
+    cv.notify_all();
+    return true;
+  }
+
+  bool future::is_cancelled() const
+  {
+    return state.load() == future_state::cancelled;
+  }
+}
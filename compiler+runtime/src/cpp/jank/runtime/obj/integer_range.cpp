@@ -18,9 +18,9 @@ namespace jank::runtime::obj
   }
 
   integer_range::integer_range(integer_ref const end)
-    : start{ make_box<integer>(0) }
+    : start{ make_box(0) }
     , end{ end }
-    , step{ make_box<integer>(1) }
+    , step{ make_box(1) }
     , bounds_check{ positive_step_bounds_check }
   {
   }
@@ -28,7 +28,7 @@ namespace jank::runtime::obj
   integer_range::integer_range(integer_ref const start, integer_ref const end)
     : start{ start }
     , end{ end }
-    , step{ make_box<integer>(1) }
+    , step{ make_box(1) }
     , bounds_check{ positive_step_bounds_check }
   {
   }
@@ -59,9 +59,9 @@ namespace jank::runtime::obj
   {
     if(is_pos(end))
     {
-      return make_box<integer_range>(make_box<integer>(0),
+      return make_box<integer_range>(make_box(0),
                                      end,
-                                     make_box<integer>(1),
+                                     make_box(1),
                                      positive_step_bounds_check);
     }
     return persistent_list::empty();
@@ -69,7 +69,7 @@ namespace jank::runtime::obj
 
   object_ref integer_range::create(integer_ref const start, integer_ref const end)
   {
-    return create(start, end, make_box<integer>(1));
+    return create(start, end, make_box(1));
   }
 
   object_ref
@@ -111,7 +111,7 @@ namespace jank::runtime::obj
     {
       return {};
     }
-    return make_box<integer_range>(make_box<integer>(add(start, step)), end, step, bounds_check);
+    return make_box<integer_range>(make_box(add(start, step)), end, step, bounds_check);
   }
 
   integer_range_ref integer_range::next_in_place()
@@ -120,7 +120,7 @@ namespace jank::runtime::obj
     {
       return {};
     }
-    start = make_box<integer>(add(start, step));
+    start = make_box(add(start, step));
     return this;
   }
 
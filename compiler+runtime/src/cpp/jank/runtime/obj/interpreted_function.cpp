@@ -0,0 +1,172 @@
+#include <jank/runtime/obj/interpreted_function.hpp>
+#include <jank/runtime/obj/nil.hpp>
+#include <jank/runtime/obj/persistent_string.hpp>
+#include <jank/runtime/obj/keyword.hpp>
+#include <jank/runtime/core/to_string.hpp>
+#include <jank/runtime/core/seq.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/rtti.hpp>
+#include <jank/evaluate/interpreter.hpp>
+#include <jank/util/fmt.hpp>
+
+namespace jank::runtime::obj
+{
+  interpreted_function::interpreted_function(analyze::expr::function * const expr,
+                                             evaluate::function_tier * const tier,
+                                             evaluate::environment * const env,
+                                             arity_flag_t const arity_flags)
+    : expr{ expr }
+    , tier{ tier }
+    , env{ env }
+    , arity_flags{ arity_flags }
+  {
+  }
+
+  bool interpreted_function::equal(object const &rhs) const
+  {
+    return &base == &rhs;
+  }
+
+  jtl::immutable_string interpreted_function::to_string()
+  {
+    util::string_builder buff;
+    to_string(buff);
+    return buff.release();
+  }
+
+  void interpreted_function::to_string(util::string_builder &buff)
+  {
+    auto const name(get(meta.unwrap_or(jank_nil), __rt_ctx->intern_keyword("name").expect_ok()));
+    util::format_to(
+      buff,
+      "{} ({}@{})",
+      (name->type == object_type::nil ? "unknown" : expect_object<persistent_string>(name)->data),
+      object_type_str(base.type),
+      &base);
+  }
+
+  jtl::immutable_string interpreted_function::to_code_string()
+  {
+    return to_string();
+  }
+
+  uhash interpreted_function::to_hash() const
+  {
+    return static_cast<uhash>(reinterpret_cast<uintptr_t>(this));
+  }
+
+  interpreted_function_ref interpreted_function::with_meta(object_ref const m)
+  {
+    auto const new_meta(behavior::detail::validate_meta(m));
+    meta = new_meta;
+    return this;
+  }
+
+  object_ref interpreted_function::call()
+  {
+    return evaluate::interpret_call(*this, {});
+  }
+
+  object_ref interpreted_function::call(object_ref const a1)
+  {
+    return evaluate::interpret_call(*this, { a1 });
+  }
+
+  object_ref interpreted_function::call(object_ref const a1, object_ref const a2)
+  {
+    return evaluate::interpret_call(*this, { a1, a2 });
+  }
+
+  object_ref
+  interpreted_function::call(object_ref const a1, object_ref const a2, object_ref const a3)
+  {
+    return evaluate::interpret_call(*this, { a1, a2, a3 });
+  }
+
+  object_ref interpreted_function::call(object_ref const a1,
+                                        object_ref const a2,
+                                        object_ref const a3,
+                                        object_ref const a4)
+  {
+    return evaluate::interpret_call(*this, { a1, a2, a3, a4 });
+  }
+
+  object_ref interpreted_function::call(object_ref const a1,
+                                        object_ref const a2,
+                                        object_ref const a3,
+                                        object_ref const a4,
+                                        object_ref const a5)
+  {
+    return evaluate::interpret_call(*this, { a1, a2, a3, a4, a5 });
+  }
+
+  object_ref interpreted_function::call(object_ref const a1,
+                                        object_ref const a2,
+                                        object_ref const a3,
+                                        object_ref const a4,
+                                        object_ref const a5,
+                                        object_ref const a6)
+  {
+    return evaluate::interpret_call(*this, { a1, a2, a3, a4, a5, a6 });
+  }
+
+  object_ref interpreted_function::call(object_ref const a1,
+                                        object_ref const a2,
+                                        object_ref const a3,
+                                        object_ref const a4,
+                                        object_ref const a5,
+                                        object_ref const a6,
+                                        object_ref const a7)
+  {
+    return evaluate::interpret_call(*this, { a1, a2, a3, a4, a5, a6, a7 });
+  }
+
+  object_ref interpreted_function::call(object_ref const a1,
+                                        object_ref const a2,
+                                        object_ref const a3,
+                                        object_ref const a4,
+                                        object_ref const a5,
+                                        object_ref const a6,
+                                        object_ref const a7,
+                                        object_ref const a8)
+  {
+    return evaluate::interpret_call(*this, { a1, a2, a3, a4, a5, a6, a7, a8 });
+  }
+
+  object_ref interpreted_function::call(object_ref const a1,
+                                        object_ref const a2,
+                                        object_ref const a3,
+                                        object_ref const a4,
+                                        object_ref const a5,
+                                        object_ref const a6,
+                                        object_ref const a7,
+                                        object_ref const a8,
+                                        object_ref const a9)
+  {
+    return evaluate::interpret_call(*this, { a1, a2, a3, a4, a5, a6, a7, a8, a9 });
+  }
+
+  object_ref interpreted_function::call(object_ref const a1,
+                                        object_ref const a2,
+                                        object_ref const a3,
+                                        object_ref const a4,
+                                        object_ref const a5,
+                                        object_ref const a6,
+                                        object_ref const a7,
+                                        object_ref const a8,
+                                        object_ref const a9,
+                                        object_ref const a10)
+  {
+    return evaluate::interpret_call(*this, { a1, a2, a3, a4, a5, a6, a7, a8, a9, a10 });
+  }
+
+  behavior::callable::arity_flag_t interpreted_function::get_arity_flags() const
+  {
+    return arity_flags;
+  }
+
+  object_ref interpreted_function::this_object_ref()
+  {
+    return &this->base;
+  }
+}
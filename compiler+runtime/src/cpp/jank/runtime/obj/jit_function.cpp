@@ -220,4 +220,35 @@ namespace jank::runtime::obj
   {
     return &this->base;
   }
+
+  bool jit_function::has_arity(usize const param_count) const
+  {
+    switch(param_count)
+    {
+      case 0:
+        return arity_0 != nullptr;
+      case 1:
+        return arity_1 != nullptr;
+      case 2:
+        return arity_2 != nullptr;
+      case 3:
+        return arity_3 != nullptr;
+      case 4:
+        return arity_4 != nullptr;
+      case 5:
+        return arity_5 != nullptr;
+      case 6:
+        return arity_6 != nullptr;
+      case 7:
+        return arity_7 != nullptr;
+      case 8:
+        return arity_8 != nullptr;
+      case 9:
+        return arity_9 != nullptr;
+      case 10:
+        return arity_10 != nullptr;
+      default:
+        return false;
+    }
+  }
 }
@@ -1,4 +1,5 @@
 #include <cmath>
+#include <utility>
 
 #include <jank/runtime/obj/number.hpp>
 #include <jank/runtime/visit.hpp>
@@ -61,11 +62,6 @@ namespace jank::runtime::obj
   }
 
   /***** integer *****/
-  integer::integer(i64 const d)
-    : data{ d }
-  {
-  }
-
   bool integer::equal(object const &o) const
   {
     if(o.type != object_type::integer)
@@ -226,3 +222,20 @@ namespace jank::runtime
   /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
   obj::boolean_ref jank_false{ false_const() };
 }
+
+namespace jank::runtime
+{
+  template <usize... Is>
+  static constexpr std::array<obj::integer, sizeof...(Is)>
+  make_integer_cache(std::index_sequence<Is...> const)
+  {
+    return { obj::integer{ integer_cache_min + static_cast<i64>(Is) }... };
+  }
+}
+
+/* This is constinit, rather than being built on first use, so that it's ready before any
+ * other static init might box an integer. */
+/* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+constinit std::array<jank::runtime::obj::integer, jank::runtime::integer_cache_size>
+  jank_integer_cache{ jank::runtime::make_integer_cache(
+    std::make_index_sequence<jank::runtime::integer_cache_size>{}) };
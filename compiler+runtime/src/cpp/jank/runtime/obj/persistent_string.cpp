@@ -74,7 +74,7 @@ namespace jank::runtime::obj
       {
         return fallback;
       }
-      return make_box<character>(data[i]);
+      return make_box(data[i]);
     }
     else
     {
@@ -108,7 +108,7 @@ namespace jank::runtime::obj
           util::format("out of bounds index {}; string has a size of {}", i, data.size())
         };
       }
-      return make_box<character>(data[i]);
+      return make_box(data[i]);
     }
     else
     {
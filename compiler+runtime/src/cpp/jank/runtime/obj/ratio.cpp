@@ -3,6 +3,7 @@
 
 #include <jank/runtime/obj/ratio.hpp>
 #include <jank/runtime/obj/big_integer.hpp>
+#include <jank/runtime/core/make_box.hpp>
 #include <jank/runtime/visit.hpp>
 #include <jank/util/fmt.hpp>
 
@@ -78,7 +79,7 @@ namespace jank::runtime::obj
       if(data.numerator < std::numeric_limits<i64>::max()
          && data.numerator > std::numeric_limits<i64>::min())
       {
-        return make_box<integer>(big_integer::to_i64(data.numerator));
+        return make_box(big_integer::to_i64(data.numerator));
       }
       return make_box<big_integer>(data.numerator);
     }
@@ -1,4 +1,5 @@
 #include <jank/runtime/obj/symbol.hpp>
+#include <jank/runtime/detail/type.hpp>
 #include <jank/runtime/core/to_string.hpp>
 #include <jank/runtime/visit.hpp>
 
@@ -56,6 +57,16 @@ namespace jank::runtime::obj
   {
   }
 
+  symbol::symbol(detail::must_be_interned,
+                 jtl::immutable_string const &ns,
+                 jtl::immutable_string const &n)
+    : ns{ ns }
+    , name{ n }
+    , canonical{ this }
+  {
+    to_hash();
+  }
+
   bool symbol::equal(object const &o) const
   {
     if(o.type != object_type::symbol)
@@ -63,12 +74,15 @@ namespace jank::runtime::obj
       return false;
     }
 
-    auto const s(expect_object<symbol>(&o));
-    return ns == s->ns && name == s->name;
+    return equal(*expect_object<symbol>(&o));
   }
 
   bool symbol::equal(symbol const &s) const
   {
+    if(canonical && s.canonical)
+    {
+      return canonical == s.canonical;
+    }
     return ns == s.ns && name == s.name;
   }
 
@@ -147,7 +161,8 @@ namespace jank::runtime::obj
   symbol_ref symbol::with_meta(object_ref const m) const
   {
     auto const meta(behavior::detail::validate_meta(m));
-    auto ret(make_box<symbol>(ns, name));
+    /* Copying keeps the canonical form and the hash. */
+    auto ret(make_box<symbol>(*this));
     ret->meta = meta;
     return ret;
   }
@@ -164,7 +179,7 @@ namespace jank::runtime::obj
 
   bool symbol::operator==(symbol const &rhs) const
   {
-    return ns == rhs.ns && name == rhs.name;
+    return equal(rhs);
   }
 
   bool symbol::operator<(symbol const &rhs) const
@@ -176,12 +191,14 @@ namespace jank::runtime::obj
   {
     ns = s;
     hash = 0;
+    canonical = nullptr;
   }
 
   void symbol::set_name(jtl::immutable_string const &s)
   {
     name = s;
     hash = 0;
+    canonical = nullptr;
   }
 }
 
@@ -1,9 +1,16 @@
 #include <nanobench.h>
 
+#include <gc/gc.h>
+
 #include <jank/runtime/perf.hpp>
 #include <jank/runtime/visit.hpp>
 #include <jank/runtime/context.hpp>
 #include <jank/runtime/core/seq.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/math.hpp>
+#include <jank/runtime/detail/allocation_stats.hpp>
+#include <jank/runtime/obj/transient_hash_map.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
 #include <jank/util/fmt.hpp>
 
 namespace jank::runtime::perf
@@ -47,4 +54,72 @@ namespace jank::runtime::perf
       label_str);
     return jank_nil;
   }
+
+  object_ref gc_stats()
+  {
+    usize heap_bytes{}, free_bytes{}, unmapped_bytes{}, bytes_since_gc{}, total_bytes{};
+    GC_get_heap_usage_safe(&heap_bytes,
+                           &free_bytes,
+                           &unmapped_bytes,
+                           &bytes_since_gc,
+                           &total_bytes);
+    auto const collections(detail::current_collection_stats());
+    auto const allocations(detail::box_allocation_totals());
+
+    auto const boxes_by_type(obj::transient_hash_map::empty());
+    for(usize i{}; i < allocations.boxes_by_type.size(); ++i)
+    {
+      if(allocations.boxes_by_type[i] != 0)
+      {
+        boxes_by_type->assoc_in_place(
+          __rt_ctx->intern_keyword(object_type_str(static_cast<object_type>(i))).expect_ok(),
+          make_box(allocations.boxes_by_type[i]));
+      }
+    }
+
+    auto const ret(obj::transient_hash_map::empty());
+    auto const assoc([&](char const * const key, object_ref const value) {
+      ret->assoc_in_place(__rt_ctx->intern_keyword(key).expect_ok(), value);
+    });
+    assoc("heap-bytes", make_box(heap_bytes));
+    assoc("free-bytes", make_box(free_bytes));
+    assoc("unmapped-bytes", make_box(unmapped_bytes));
+    assoc("allocated-bytes-since-gc", make_box(bytes_since_gc));
+    assoc("allocated-bytes", make_box(total_bytes));
+    assoc("collections", make_box(collections.collections));
+    assoc("total-pause-ns", make_box(collections.total_pause_ns));
+    assoc("max-pause-ns", make_box(collections.max_pause_ns));
+    assoc("boxes", make_box(allocations.boxes));
+    assoc("cached-boxes", make_box(allocations.cached_boxes));
+    assoc("boxes-by-type", boxes_by_type->to_persistent());
+    return ret->to_persistent();
+  }
+
+  object_ref sample_allocations(object_ref const n)
+  {
+    auto const interval(to_int(n));
+    if(interval < 0)
+    {
+      throw std::runtime_error{ util::format("invalid sample interval: {}", interval) };
+    }
+    detail::allocation_sample_interval.store(static_cast<u64>(interval),
+                                             std::memory_order_relaxed);
+    return jank_nil;
+  }
+
+  object_ref allocation_sites()
+  {
+    auto const ret(obj::transient_hash_map::empty());
+    for(auto const &site : detail::sampled_allocation_sites())
+    {
+      ret->assoc_in_place(make_box<obj::persistent_string>(site.site), make_box(site.samples));
+    }
+    return ret->to_persistent();
+  }
+
+  object_ref clear_allocation_sites()
+  {
+    detail::clear_allocation_samples();
+    return jank_nil;
+  }
 }
@@ -0,0 +1,287 @@
+#include <algorithm>
+#include <chrono>
+
+#include <gc/gc.h>
+
+#include <jank/runtime/thread_pool.hpp>
+#include <jank/util/fmt/print.hpp>
+#include <jank/util/try.hpp>
+
+namespace jank::runtime
+{
+  /* The pool and worker index of the current thread, if it's a worker. This is how a task
+   * submitted from within the pool ends up on the submitting worker's own deque. */
+  static thread_local thread_pool const *current_pool{};
+  static thread_local usize current_worker{};
+  static thread_local cached_thread_pool const *current_cached_pool{};
+
+  /* Tasks are expected to hand their own errors to whoever owns their result, like a
+   * future keeping its failure for deref. Anything which still escapes has nowhere else
+   * to go, so it's reported, rather than taking the worker down with it. */
+  static void run_task(thread_pool::task const &t)
+  {
+    JANK_TRY
+    {
+      t.fn(t.arg);
+    }
+    JANK_CATCH([](auto const &e) {
+      util::println(stderr,
+                    "Uncaught exception in thread pool task: {}",
+                    util::exception_message(e));
+    })
+    catch(...)
+    {
+      util::println(stderr, "Uncaught exception in thread pool task of an unknown type");
+    }
+  }
+
+  thread_pool::thread_pool(usize const thread_count)
+  {
+    jank_debug_assert(0 < thread_count);
+
+    /* Threads may only register themselves with the GC once this has been called, from
+     * a thread which the GC already knows about. */
+    GC_allow_register_threads();
+
+    workers.reserve(thread_count);
+    for(usize i{}; i < thread_count; ++i)
+    {
+      workers.emplace_back(new(GC) worker{});
+    }
+
+    threads.reserve(thread_count);
+    for(usize i{}; i < thread_count; ++i)
+    {
+      threads.emplace_back([this, i]() { work(i); });
+    }
+  }
+
+  void thread_pool::submit(task_fn const fn, object_ref const arg)
+  {
+    /* Tasks which are already running may still queue follow up work, like an agent
+     * scheduling its next action. The workers keep going until it's all done. */
+    if(stopping.load() && current_pool != this)
+    {
+      throw std::runtime_error{ "Unable to submit a task to a thread pool which is shut down." };
+    }
+
+    auto const index(current_pool == this
+                       ? current_worker
+                       : next_worker.fetch_add(1, std::memory_order_relaxed) % workers.size());
+    {
+      auto &w(*workers[index]);
+      std::lock_guard<std::mutex> const lock{ w.mutex };
+      queued.fetch_add(1);
+      w.tasks.push_back({ fn, arg });
+    }
+
+    /* Taking the lock, even briefly, means a worker can't miss this between checking
+     * its predicate and going to sleep. */
+    {
+      std::lock_guard<std::mutex> const lock{ sleep_mutex };
+    }
+    sleep_cv.notify_one();
+  }
+
+  void thread_pool::shutdown()
+  {
+    {
+      std::lock_guard<std::mutex> const lock{ sleep_mutex };
+      if(stopping.exchange(true))
+      {
+        return;
+      }
+    }
+    sleep_cv.notify_all();
+
+    /* When a task shuts down its own pool, its worker can't wait on itself. It'll exit
+     * on its own, once it has finished its task and the queue is empty. */
+    for(auto &t : threads)
+    {
+      if(t.get_id() == std::this_thread::get_id())
+      {
+        t.detach();
+      }
+      else
+      {
+        t.join();
+      }
+    }
+  }
+
+  usize thread_pool::thread_count() const
+  {
+    return workers.size();
+  }
+
+  bool thread_pool::is_worker_thread() const
+  {
+    return current_pool == this;
+  }
+
+  jtl::option<thread_pool::task> thread_pool::next_task(usize const index)
+  {
+    {
+      auto &own(*workers[index]);
+      std::lock_guard<std::mutex> const lock{ own.mutex };
+      if(!own.tasks.empty())
+      {
+        auto const t(own.tasks.back());
+        own.tasks.pop_back();
+        queued.fetch_sub(1);
+        return t;
+      }
+    }
+
+    for(usize offset{ 1 }; offset < workers.size(); ++offset)
+    {
+      auto &victim(*workers[(index + offset) % workers.size()]);
+      std::lock_guard<std::mutex> const lock{ victim.mutex };
+      if(!victim.tasks.empty())
+      {
+        auto const t(victim.tasks.front());
+        victim.tasks.pop_front();
+        queued.fetch_sub(1);
+        return t;
+      }
+    }
+
+    return none;
+  }
+
+  void thread_pool::work(usize const index)
+  {
+    GC_stack_base stack_base{};
+    GC_get_stack_base(&stack_base);
+    GC_register_my_thread(&stack_base);
+
+    current_pool = this;
+    current_worker = index;
+
+    while(true)
+    {
+      auto const t(next_task(index));
+      if(t.is_some())
+      {
+        run_task(t.unwrap());
+        continue;
+      }
+
+      std::unique_lock<std::mutex> lock{ sleep_mutex };
+      sleep_cv.wait(lock, [this]() { return stopping.load() || queued.load() != 0; });
+      if(stopping.load() && queued.load() == 0)
+      {
+        break;
+      }
+    }
+
+    current_pool = nullptr;
+    GC_unregister_my_thread();
+  }
+
+  /* How long a cached thread will wait for a new task before exiting. */
+  static constexpr std::chrono::seconds cached_thread_keep_alive{ 60 };
+
+  cached_thread_pool::cached_thread_pool()
+  {
+    GC_allow_register_threads();
+  }
+
+  void cached_thread_pool::submit(task_fn const fn, object_ref const arg)
+  {
+    {
+      std::lock_guard<std::mutex> const lock{ mutex };
+      if(stopping && current_cached_pool != this)
+      {
+        throw std::runtime_error{
+          "Unable to submit a task to a thread pool which is shut down."
+        };
+      }
+
+      tasks.push_back({ fn, arg });
+      if(idle_threads < tasks.size())
+      {
+        ++threads;
+        std::thread{ [this]() { work(); } }.detach();
+      }
+    }
+    task_cv.notify_one();
+  }
+
+  void cached_thread_pool::shutdown()
+  {
+    std::unique_lock<std::mutex> lock{ mutex };
+    stopping = true;
+    task_cv.notify_all();
+
+    /* Like with the fixed pool, a task which shuts down its own pool doesn't wait for its
+     * own thread. */
+    usize const own_threads{ current_cached_pool == this ? 1u : 0u };
+    exit_cv.wait(lock, [this, own_threads]() { return threads == own_threads; });
+  }
+
+  usize cached_thread_pool::thread_count() const
+  {
+    std::lock_guard<std::mutex> const lock{ mutex };
+    return threads;
+  }
+
+  void cached_thread_pool::work()
+  {
+    GC_stack_base stack_base{};
+    GC_get_stack_base(&stack_base);
+    GC_register_my_thread(&stack_base);
+
+    current_cached_pool = this;
+
+    std::unique_lock<std::mutex> lock{ mutex };
+    while(true)
+    {
+      if(!tasks.empty())
+      {
+        auto const t(tasks.front());
+        tasks.pop_front();
+        lock.unlock();
+        run_task(t);
+        lock.lock();
+        continue;
+      }
+
+      if(stopping)
+      {
+        break;
+      }
+
+      ++idle_threads;
+      auto const woken(task_cv.wait_for(lock, cached_thread_keep_alive, [this]() {
+        return stopping || !tasks.empty();
+      }));
+      --idle_threads;
+      if(!woken)
+      {
+        break;
+      }
+    }
+
+    current_cached_pool = nullptr;
+    --threads;
+    exit_cv.notify_all();
+    lock.unlock();
+    GC_unregister_my_thread();
+  }
+
+  thread_pool &default_thread_pool()
+  {
+    /* Unless shutdown-agents is called, this is never shut down. The workers just sleep
+     * until the process exits. */
+    static thread_pool * const pool{ new(GC) thread_pool{
+      std::max(1u, std::thread::hardware_concurrency()) } };
+    return *pool;
+  }
+
+  cached_thread_pool &default_cached_thread_pool()
+  {
+    static cached_thread_pool * const pool{ new(GC) cached_thread_pool{} };
+    return *pool;
+  }
+}
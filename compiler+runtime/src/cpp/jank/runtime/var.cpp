@@ -16,14 +16,14 @@ namespace jank::runtime
   var::var(ns_ref const &n, obj::symbol_ref const &name)
     : n{ n }
     , name{ name }
-    , root{ make_box<var_unbound_root>(this) }
+    , root{ make_box<var_unbound_root>(this).erase() }
   {
   }
 
   var::var(ns_ref const &n, obj::symbol_ref const &name, object_ref const root)
     : n{ n }
     , name{ name }
-    , root{ root }
+    , root{ root.data }
   {
   }
 
@@ -31,12 +31,12 @@ namespace jank::runtime
            obj::symbol_ref const &name,
            object_ref const root,
            bool const dynamic,
-           bool const thread_bound)
+           u32 const binding_slot)
     : n{ n }
     , name{ name }
-    , root{ root }
+    , root{ root.data }
     , dynamic{ dynamic }
-    , thread_bound{ thread_bound }
+    , binding_slot{ binding_slot }
   {
   }
 
@@ -102,21 +102,23 @@ namespace jank::runtime
   object_ref var::get_root() const
   {
     profile::timer const timer{ "var get_root" };
-    return *root.rlock();
+    return root.load(std::memory_order_acquire);
   }
 
   var_ref var::bind_root(object_ref const r)
   {
     profile::timer const timer{ "var bind_root" };
-    *root.wlock() = r;
+    std::lock_guard<std::mutex> const lock{ root_mutex };
+    root.store(r.data, std::memory_order_release);
     return this;
   }
 
   object_ref var::alter_root(object_ref const f, object_ref const args)
   {
-    auto locked_root(root.wlock());
-    *locked_root = apply_to(f, cons(*locked_root, args));
-    return *locked_root;
+    std::lock_guard<std::mutex> const lock{ root_mutex };
+    auto const next(apply_to(f, cons(root.load(std::memory_order_acquire), args)));
+    root.store(next.data, std::memory_order_release);
+    return next;
   }
 
   jtl::string_result<void> var::set(object_ref const r) const
@@ -134,7 +136,7 @@ namespace jank::runtime
                               to_string()));
     }
 
-    binding->value = r;
+    binding->value.store(r.data, std::memory_order_release);
     return ok();
   }
 
@@ -146,25 +148,39 @@ namespace jank::runtime
 
   var_thread_binding_ref var::get_thread_binding() const
   {
-    if(!thread_bound.load())
+    auto const slot(binding_slot.load(std::memory_order_relaxed));
+    if(slot == 0)
     {
       return {};
     }
 
-    auto &tbfs(n->rt_ctx.thread_binding_frames[&n->rt_ctx]);
-    if(tbfs.empty())
+    auto const &slots(n->rt_ctx.current_thread_bindings().slots);
+    if(slots.size() <= slot)
     {
       return {};
     }
+    return slots[slot];
+  }
+
+  /* Slots start at one, since zero means a var has none. */
+  /* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
+  static std::atomic<u32> next_binding_slot{ 1 };
 
-    auto const found(tbfs.front().bindings->get_entry(this));
-    if(found == jank_nil)
+  u32 var::get_binding_slot()
+  {
+    auto slot(binding_slot.load(std::memory_order_relaxed));
+    if(slot != 0)
     {
-      return {};
+      return slot;
     }
 
-    auto const ret(expect_object<obj::persistent_vector>(found)->data[1]);
-    return expect_object<var_thread_binding>(ret);
+    /* If another thread beats us to it, the slot we took just goes unused. */
+    auto const fresh(next_binding_slot.fetch_add(1, std::memory_order_relaxed));
+    if(binding_slot.compare_exchange_strong(slot, fresh, std::memory_order_relaxed))
+    {
+      return fresh;
+    }
+    return slot;
   }
 
   object_ref var::deref() const
@@ -172,18 +188,69 @@ namespace jank::runtime
     auto const binding(get_thread_binding());
     if(binding.is_some())
     {
-      return binding->value;
+      return binding->value.load(std::memory_order_acquire);
     }
-    return *root.rlock();
+    return root.load(std::memory_order_acquire);
   }
 
   var_ref var::clone() const
   {
-    return make_box<var>(n, name, get_root(), dynamic.load(), thread_bound.load());
+    /* The clone shares the slot, since it's equal to this var, so it's bound wherever this is. */
+    return make_box<var>(n, name, get_root(), dynamic.load(), binding_slot.load());
+  }
+
+  thread_binding_frame::thread_binding_frame(thread_binding_frame const * const parent)
+    : parent{ parent }
+  {
+  }
+
+  bool thread_binding_frame::equal(object const &o) const
+  {
+    return &base == &o;
+  }
+
+  jtl::immutable_string thread_binding_frame::to_string() const
+  {
+    util::string_builder buff;
+    to_string(buff);
+    return buff.release();
+  }
+
+  void thread_binding_frame::to_string(util::string_builder &buff) const
+  {
+    util::format_to(buff, "thread_binding_frame@{}", &base);
+  }
+
+  jtl::immutable_string thread_binding_frame::to_code_string() const
+  {
+    return thread_binding_frame::to_string();
+  }
+
+  uhash thread_binding_frame::to_hash() const
+  {
+    return static_cast<uhash>(reinterpret_cast<uintptr_t>(this));
+  }
+
+  obj::persistent_hash_map_ref thread_binding_frame::bindings() const
+  {
+    if(auto const cached(cached_bindings.load(std::memory_order_acquire)); cached)
+    {
+      return cached;
+    }
+
+    /* If another thread builds this at the same time, it'll build the same map. */
+    auto ret(parent ? parent->bindings() : obj::persistent_hash_map::empty());
+    for(auto const &b : pushed)
+    {
+      ret = ret->assoc(b.var, b.value);
+    }
+    cached_bindings.store(static_cast<obj::persistent_hash_map *>(ret.data),
+                          std::memory_order_release);
+    return ret;
   }
 
   var_thread_binding::var_thread_binding(object_ref const value, std::thread::id const id)
-    : value{ value }
+    : value{ value.data }
     , thread_id{ id }
   {
   }
@@ -195,7 +262,7 @@ namespace jank::runtime
 
   jtl::immutable_string var_thread_binding::to_string() const
   {
-    return runtime::to_string(value);
+    return runtime::to_string(value.load(std::memory_order_acquire));
   }
 
   jtl::immutable_string var_thread_binding::to_code_string() const
@@ -205,12 +272,12 @@ namespace jank::runtime
 
   void var_thread_binding::to_string(util::string_builder &buff) const
   {
-    runtime::to_string(value, buff);
+    runtime::to_string(value.load(std::memory_order_acquire), buff);
   }
 
   uhash var_thread_binding::to_hash() const
   {
-    return hash::visit(value.get());
+    return hash::visit(value.load(std::memory_order_acquire));
   }
 
   var_unbound_root::var_unbound_root(var_ref const var)
@@ -0,0 +1,124 @@
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+#include <gc/gc.h>
+
+#include <jank/util/arena.hpp>
+
+namespace jank::util
+{
+  static usize align_up(usize const n, usize const alignment)
+  {
+    return (n + alignment - 1) & ~(alignment - 1);
+  }
+
+  arena::scope::scope(arena &a)
+    : a{ a }
+    , m{ a.current_mark() }
+  {
+  }
+
+  arena::scope::~scope()
+  {
+    a.rewind(m);
+  }
+
+  arena::arena(usize const chunk_size)
+    : chunk_size{ chunk_size }
+  {
+  }
+
+  arena::~arena()
+  {
+    for(auto const &c : chunks)
+    {
+      GC_FREE(c.data);
+    }
+  }
+
+  void *arena::allocate(usize const size, usize const alignment)
+  {
+    ++stats.allocations;
+    stats.allocated_bytes += size;
+
+    /* Chunks come from the GC, so they're aligned for anything. */
+    while(current < chunks.size())
+    {
+      auto const &c(chunks[current]);
+      auto const start(align_up(used, alignment));
+      if(start + size <= c.size)
+      {
+        used = start + size;
+        return c.data + start;
+      }
+
+      /* Chunks past the current one are only there from an earlier rewind, so they can be
+       * reused as is. */
+      ++current;
+      used = 0;
+    }
+
+    /* Anything bigger than a chunk gets a chunk of its own. */
+    auto const size_to_reserve(std::max(chunk_size, align_up(size, alignment)));
+    auto const data(static_cast<char *>(GC_MALLOC_UNCOLLECTABLE(size_to_reserve)));
+    if(data == nullptr)
+    {
+      throw std::bad_alloc{};
+    }
+    chunks.push_back({ data, size_to_reserve });
+    stats.reserved_bytes += size_to_reserve;
+    current = chunks.size() - 1;
+    used = size;
+    return data;
+  }
+
+  struct arena::mark arena::current_mark() const
+  {
+    return { current, used };
+  }
+
+  /* The GC scans the chunks, so anything left in the released part would keep whatever it
+   * points to alive. */
+  void arena::clear_since(struct mark const &m)
+  {
+    if(chunks.empty())
+    {
+      return;
+    }
+
+    for(auto i(m.chunk); i <= current && i < chunks.size(); ++i)
+    {
+      auto const from(i == m.chunk ? m.used : 0);
+      auto const to(i == current ? used : chunks[i].size);
+      if(from < to)
+      {
+        std::memset(chunks[i].data + from, 0, to - from);
+      }
+    }
+  }
+
+  void arena::rewind(struct mark const &m)
+  {
+    clear_since(m);
+    current = m.chunk;
+    used = m.used;
+  }
+
+  void arena::release()
+  {
+    clear_since({});
+    /* The first chunk is kept, since we'll most likely need it again right away. */
+    for(usize i{ 1 }; i < chunks.size(); ++i)
+    {
+      stats.reserved_bytes -= chunks[i].size;
+      GC_FREE(chunks[i].data);
+    }
+    if(chunks.size() > 1)
+    {
+      chunks.resize(1);
+    }
+    current = 0;
+    used = 0;
+  }
+}
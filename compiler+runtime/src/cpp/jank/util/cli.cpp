@@ -25,8 +25,29 @@ namespace jank::util::cli
                    opts.profiler_file,
                    "The file to write profile entries (will be overwritten).");
     cli.add_flag("--gc-incremental", opts.gc_incremental, "Enable incremental GC collection.");
+    cli.add_flag("--interpret,!--no-interpret",
+                 opts.interpret,
+                 "Interpret top-level forms and cold fns, rather than JIT compiling everything.");
+    cli.add_option("--jit-threshold",
+                   opts.jit_threshold,
+                   "How many calls an interpreted fn gets before it's JIT compiled (0 for never).")
+      ->check(CLI::NonNegativeNumber);
+    cli.add_flag("--background-jit,!--no-background-jit",
+                 opts.background_jit,
+                 "Compile hot fns on a background thread, interpreting them until they're ready.");
+    cli.add_flag("--intern-symbols,!--no-intern-symbols",
+                 opts.intern_symbols,
+                 "Read symbols as copies of canonical symbols, so they compare by identity.");
+    cli.add_flag("--jit-cache",
+                 opts.jit_cache,
+                 "Compile each evaluated form, rather than interpreting it, and cache its objects, "
+                 "keyed on its content.");
     cli.add_option("-O,--optimization", opts.optimization_level, "The optimization level to use.")
       ->check(CLI::Range(0, 3));
+    cli.add_option("-j,--jobs",
+                   opts.jobs,
+                   "How many threads write object files while compiling (0 for one per core).")
+      ->check(CLI::NonNegativeNumber);
 
     /* Native dependencies. */
     cli.add_option("-I,--include-dir",
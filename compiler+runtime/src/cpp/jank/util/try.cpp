@@ -139,4 +139,28 @@ namespace jank::util
       print_exception_stack_trace(*deepest_trace);
     }
   }
+
+  jtl::immutable_string exception_message(std::exception const &e)
+  {
+    return e.what();
+  }
+
+  jtl::immutable_string exception_message(runtime::object_ref const e)
+  {
+    if(e->type == runtime::object_type::persistent_string)
+    {
+      return runtime::to_string(e);
+    }
+    return runtime::to_code_string(e);
+  }
+
+  jtl::immutable_string exception_message(jtl::immutable_string const &e)
+  {
+    return e;
+  }
+
+  jtl::immutable_string exception_message(error_ref const e)
+  {
+    return e->message;
+  }
 }
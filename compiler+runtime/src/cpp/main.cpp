@@ -5,6 +5,7 @@
 #include <llvm/LineEditor/LineEditor.h>
 
 #include <jank/aot/processor.hpp>
+#include <jank/aot/driver.hpp>
 #include <jank/read/lex.hpp>
 #include <jank/read/parse.hpp>
 #include <jank/runtime/context.hpp>
@@ -28,6 +29,7 @@
 #include <jank/perf_native.hpp>
 #include <clojure/core_native.hpp>
 #include <clojure/string_native.hpp>
+#include <clojure/edn_native.hpp>
 
 namespace jank
 {
@@ -106,7 +108,8 @@ namespace jank
     {
       __rt_ctx->load_module("/clojure.core", module::origin::latest).expect_ok();
     }
-    __rt_ctx->compile_module(opts.target_module).expect_ok();
+    aot::driver driver{ opts };
+    driver.compile(opts.target_module).expect_ok();
   }
 
   static void repl(util::cli::options const &opts)
@@ -241,11 +244,12 @@ namespace jank
     using namespace jank;
     using namespace jank::runtime;
 
+    aot::driver driver{ opts };
     if(opts.target_module != "clojure.core")
     {
-      __rt_ctx->compile_module("clojure.core").expect_ok();
+      driver.compile("clojure.core").expect_ok();
     }
-    __rt_ctx->compile_module(opts.target_module).expect_ok();
+    driver.compile(opts.target_module).expect_ok();
 
     auto const main_var(__rt_ctx->find_var(opts.target_module, "-main"));
     if(main_var.is_nil())
@@ -285,6 +289,7 @@ int main(int const argc, char const **argv)
 
     jank_load_clojure_core_native();
     jank_load_clojure_string_native();
+    jank_load_clojure_edn_native();
     jank_load_jank_compiler_native();
     jank_load_jank_perf_native();
 
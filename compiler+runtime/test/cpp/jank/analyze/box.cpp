@@ -3,6 +3,10 @@
 #include <jank/runtime/core/make_box.hpp>
 #include <jank/runtime/core/equal.hpp>
 #include <jank/jit/processor.hpp>
+#include <jank/analyze/rtti.hpp>
+#include <jank/analyze/local_frame.hpp>
+#include <jank/analyze/expr/let.hpp>
+#include <jank/analyze/step/infer_primitive_types.hpp>
 
 /* This must go last; doctest and glog both define CHECK and family. */
 #include <doctest/doctest.h>
@@ -231,5 +235,58 @@ namespace jank::analyze
         CHECK(equal(runtime::get(a_binding, make_box("has_unboxed_usage")), make_box(false)));
       }
     }
+
+    /* Finds the primitive types of the params for the fn which a loop* turns into. */
+    static native_vector<primitive_type> loop_param_types(native_persistent_string_view const &code)
+    {
+      auto const res(__rt_ctx->analyze_string(code));
+      auto const let(llvm::cast<expr::let>(res[0].data));
+      auto const call(llvm::cast<expr::call>(let->body->values.back().data));
+      auto const &arity(llvm::cast<expr::function>(call->source_expr.data)->arities[0]);
+
+      native_vector<primitive_type> ret;
+      for(auto const &param : arity.params)
+      {
+        ret.emplace_back(step::local_primitive_type(arity.frame->locals.find(param)->second));
+      }
+      return ret;
+    }
+
+    TEST_CASE("Primitive loop params")
+    {
+      SUBCASE("Inferred from init and recur")
+      {
+        auto const types(loop_param_types(
+          "(loop* [i 0 x 0.0] (if (clojure.core/< i 10) (recur (clojure.core/inc i) "
+          "(clojure.core/+ x i)) x))"));
+        CHECK_EQ(types[0], primitive_type::i64);
+        CHECK_EQ(types[1], primitive_type::f64);
+      }
+
+      SUBCASE("Mixed types stay boxed")
+      {
+        auto const types(loop_param_types(
+          "(loop* [i 0 x 0] (if (clojure.core/< i 10) (recur (clojure.core/inc i) "
+          "(clojure.core/* x 0.5)) x))"));
+        CHECK_EQ(types[0], primitive_type::i64);
+        CHECK_EQ(types[1], primitive_type::none);
+      }
+
+      SUBCASE("Demotion propagates")
+      {
+        auto const types(
+          loop_param_types("(loop* [i 0 j 0] (if (clojure.core/< i 10) (recur (clojure.core/inc "
+                           "i) (clojure.core/str j)) (recur j i)))"));
+        CHECK_EQ(types[0], primitive_type::none);
+        CHECK_EQ(types[1], primitive_type::none);
+      }
+
+      SUBCASE("Hinted")
+      {
+        auto const types(loop_param_types("(loop* [^double x 0] (if (clojure.core/< x 10) (recur "
+                                          "(clojure.core/inc x)) x))"));
+        CHECK_EQ(types[0], primitive_type::f64);
+      }
+    }
   }
 }
@@ -0,0 +1,127 @@
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+#include <unistd.h>
+
+#include <jank/aot/driver.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/util/cli.hpp>
+#include <jank/util/fmt.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::aot
+{
+  using namespace jank::runtime;
+
+  /* Writes modules into a fresh dir and puts them on the module path, so the driver finds
+   * them like any other source module. */
+  struct module_fixture
+  {
+    module_fixture()
+      : dir{ std::filesystem::temp_directory_path()
+             / util::format(
+                 "jank-aot-driver-{}-{}",
+                 getpid(),
+                 static_cast<i64>(std::chrono::steady_clock::now().time_since_epoch().count()))
+                 .c_str() }
+    {
+      std::filesystem::create_directories(dir);
+    }
+
+    ~module_fixture()
+    {
+      std::error_code ec;
+      std::filesystem::remove_all(dir, ec);
+    }
+
+    void add_module(jtl::immutable_string const &name, jtl::immutable_string const &source)
+    {
+      auto const path(dir / util::format("{}.jank", name).c_str());
+      std::ofstream{ path } << source;
+      __rt_ctx->module_loader.entries[name].jank
+        = module::file_entry{ none, jtl::immutable_string{ path.native() } };
+    }
+
+    std::filesystem::path dir;
+  };
+
+  static native_vector<jtl::immutable_string> deps_of(native_persistent_string_view const code)
+  {
+    return ns_form_deps(__rt_ctx->read_string(code));
+  }
+
+  static usize position(native_vector<jtl::immutable_string> const &order,
+                        jtl::immutable_string const &module)
+  {
+    return static_cast<usize>(std::ranges::find(order, module) - order.begin());
+  }
+
+  TEST_SUITE("aot driver")
+  {
+    TEST_CASE("ns form deps")
+    {
+      SUBCASE("symbols and vector specs")
+      {
+        CHECK(deps_of("(ns foo (:require bar [baz :as b] [qux :refer [x]]))")
+              == native_vector<jtl::immutable_string>{ "bar", "baz", "qux" });
+      }
+
+      SUBCASE("prefix lists")
+      {
+        CHECK(deps_of("(ns foo (:require (clojure set [string :as str])))")
+              == native_vector<jtl::immutable_string>{ "clojure.set", "clojure.string" });
+      }
+
+      SUBCASE("use clauses and options")
+      {
+        CHECK(deps_of("(ns foo \"Docs.\" (:use bar) (:require baz :reload) (:import Qux))")
+              == native_vector<jtl::immutable_string>{ "bar", "baz" });
+      }
+
+      SUBCASE("other forms")
+      {
+        CHECK(deps_of("(def foo 1)").empty());
+        CHECK(deps_of("[ns foo (:require bar)]").empty());
+        CHECK(deps_of("(ns foo)").empty());
+      }
+    }
+
+    TEST_CASE_FIXTURE(module_fixture, "build graph")
+    {
+      util::cli::options const opts;
+
+      SUBCASE("dependencies come first")
+      {
+        add_module("jank-test-aot.a",
+                   "(ns jank-test-aot.a (:require jank-test-aot.b jank-test-aot.c))");
+        add_module("jank-test-aot.b", "(ns jank-test-aot.b (:require [jank-test-aot.c]))");
+        add_module("jank-test-aot.c", "(ns jank-test-aot.c)");
+
+        driver d{ opts };
+        REQUIRE(d.build_graph("jank-test-aot.a").is_ok());
+        CHECK(d.order.size() == 3);
+        CHECK(position(d.order, "jank-test-aot.c") < position(d.order, "jank-test-aot.b"));
+        CHECK(position(d.order, "jank-test-aot.b") < position(d.order, "jank-test-aot.a"));
+
+        /* Modules already in the graph aren't added again. */
+        REQUIRE(d.build_graph("jank-test-aot.b").is_ok());
+        CHECK(d.order.size() == 3);
+      }
+
+      SUBCASE("cycles are reported")
+      {
+        add_module("jank-test-aot.x", "(ns jank-test-aot.x (:require jank-test-aot.y))");
+        add_module("jank-test-aot.y", "(ns jank-test-aot.y (:require jank-test-aot.x))");
+
+        driver d{ opts };
+        auto const res(d.build_graph("jank-test-aot.x"));
+        REQUIRE(res.is_err());
+        CHECK(res.expect_err().find("Cyclic") != jtl::immutable_string::npos);
+      }
+    }
+  }
+}
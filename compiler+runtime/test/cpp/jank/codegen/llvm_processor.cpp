@@ -0,0 +1,303 @@
+#include <nanobench.h>
+
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/equal.hpp>
+#include <jank/runtime/behavior/callable.hpp>
+#include <jank/runtime/obj/keyword.hpp>
+#include <jank/runtime/obj/interpreted_function.hpp>
+#include <jank/runtime/obj/jit_function.hpp>
+#include <jank/runtime/rtti.hpp>
+#include <jank/evaluate/interpreter.hpp>
+#include <jank/analyze/rtti.hpp>
+#include <jank/analyze/expr/call.hpp>
+#include <jank/util/fmt.hpp>
+#include <jank/util/scope_exit.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::codegen
+{
+  using runtime::__rt_ctx;
+
+  /* These run with the default options, so code starts out interpreted. Calling a fn until
+   * it's hot gets it compiled, which is how codegen runs by default. Once this returns, the
+   * interpreted fn forwards every call to its compiled fn. */
+  template <typename... Args>
+  static runtime::object_ref compile_hot(runtime::object_ref const fn, Args const &...args)
+  {
+    auto const typed_fn(runtime::expect_object<runtime::obj::interpreted_function>(fn));
+    /* Loop iterations count as calls, so a long loop may be hot after a single call. */
+    for(u32 i{}; i < __rt_ctx->jit_threshold
+        && typed_fn->tier->state.load() == evaluate::function_tier_state::interpreted;
+        ++i)
+    {
+      runtime::dynamic_call(fn, args...);
+    }
+    evaluate::await_background_jit();
+    /* A compiled fn is only picked up by the next call. */
+    runtime::dynamic_call(fn, args...);
+    REQUIRE(typed_fn->compiled.load() != nullptr);
+    return fn;
+  }
+
+  /* Compiles the code as the body of a fn and returns what the compiled fn returns. */
+  static runtime::object_ref eval_compiled(native_persistent_string_view const code)
+  {
+    auto const fn(
+      compile_hot(__rt_ctx->eval_string(util::format("(fn* [] {})", code).c_str())));
+    return runtime::dynamic_call(fn);
+  }
+
+  TEST_SUITE("llvm_processor")
+  {
+    TEST_CASE("direct call")
+    {
+      __rt_ctx->eval_string("(def direct-call-target (fn* [x] (clojure.core/inc x)))");
+      __rt_ctx->eval_string("(def direct-call-caller (fn* [] (direct-call-target 1)))");
+      compile_hot(__rt_ctx->eval_string("direct-call-target"), runtime::make_box(1));
+      compile_hot(__rt_ctx->eval_string("direct-call-caller"));
+      CHECK(runtime::equal(__rt_ctx->eval_string("(direct-call-caller)"), runtime::make_box(2)));
+
+      SUBCASE("guard follows rebinding to another fixed arity fn")
+      {
+        __rt_ctx->eval_string("(def direct-call-target (fn* [x] (clojure.core/dec x)))");
+        CHECK(
+          runtime::equal(__rt_ctx->eval_string("(direct-call-caller)"), runtime::make_box(0)));
+        compile_hot(__rt_ctx->eval_string("direct-call-target"), runtime::make_box(1));
+        CHECK(
+          runtime::equal(__rt_ctx->eval_string("(direct-call-caller)"), runtime::make_box(0)));
+      }
+
+      SUBCASE("guard falls back for variadic fns")
+      {
+        __rt_ctx->eval_string("(def direct-call-target (fn* [& args] args))");
+        CHECK(runtime::equal(__rt_ctx->eval_string("(direct-call-caller)"),
+                             __rt_ctx->read_string("(1)")));
+      }
+
+      SUBCASE("guard falls back for non-functions")
+      {
+        __rt_ctx->eval_string("(def direct-call-target {1 :one})");
+        CHECK(runtime::equal(__rt_ctx->eval_string("(direct-call-caller)"),
+                             __rt_ctx->intern_keyword("one").expect_ok()));
+      }
+    }
+
+    TEST_CASE("direct call analysis with default options")
+    {
+      /* Nothing here changes the options, so this is what every program gets. */
+      REQUIRE(__rt_ctx->interpret);
+      __rt_ctx->eval_string("(def direct-call-default (fn* ([x] x) ([x y] y)))");
+      auto const target(__rt_ctx->eval_string("direct-call-default"));
+      REQUIRE(target->type == runtime::object_type::interpreted_function);
+
+      auto const flags([](native_persistent_string_view const code) {
+        auto const res(__rt_ctx->analyze_string(code, false));
+        REQUIRE(res.size() == 1);
+        auto const call(llvm::dyn_cast<analyze::expr::call>(res[0].data));
+        REQUIRE(call);
+        return call->direct_call_arity_flags;
+      });
+
+      CHECK(flags("(direct-call-default 1)").is_some());
+      CHECK(flags("(direct-call-default 1 2)").is_some());
+      CHECK(flags("(direct-call-default 1 2 3)").is_none());
+
+      SUBCASE("once the callee is compiled")
+      {
+        compile_hot(target, runtime::make_box(1));
+        auto const compiled(
+          runtime::expect_object<runtime::obj::interpreted_function>(target)->compiled.load());
+        REQUIRE(compiled->type == runtime::object_type::jit_function);
+
+        /* The guard checks the compiled fn's flags at runtime, so they need to match. */
+        auto const one(flags("(direct-call-default 1)"));
+        REQUIRE(one.is_some());
+        CHECK(one.unwrap()
+              == runtime::expect_object<runtime::obj::jit_function>(compiled)->get_arity_flags());
+        CHECK(flags("(direct-call-default 1 2)").is_some());
+      }
+
+      SUBCASE("not for variadic fns")
+      {
+        __rt_ctx->eval_string("(def direct-call-default (fn* [& args] args))");
+        CHECK(flags("(direct-call-default 1)").is_none());
+      }
+    }
+
+    TEST_CASE("unboxed math")
+    {
+      SUBCASE("integer loop")
+      {
+        CHECK(runtime::equal(eval_compiled("(loop* [i 0 sum 0] (if (clojure.core/< i 100) (recur "
+                                           "(clojure.core/inc i) (clojure.core/+ sum i)) sum))"),
+                             runtime::make_box(4950)));
+      }
+
+      SUBCASE("real loop")
+      {
+        CHECK(runtime::equal(eval_compiled("(loop* [i 0 x 1.0] (if (clojure.core/< i 4) (recur "
+                                           "(clojure.core/inc i) (clojure.core/* x 2)) x))"),
+                             runtime::make_box(16.0)));
+      }
+
+      SUBCASE("mixed loop stays boxed")
+      {
+        CHECK(runtime::equal(eval_compiled("(loop* [i 0 x 1] (if (clojure.core/< i 2) (recur "
+                                           "(clojure.core/inc i) (clojure.core/* x 0.5)) x))"),
+                             runtime::make_box(0.25)));
+      }
+
+      SUBCASE("hinted coercion")
+      {
+        CHECK(runtime::equal(eval_compiled("(let* [^long x 7.9] (clojure.core/+ x 1))"),
+                             runtime::make_box(8)));
+      }
+
+      SUBCASE("escape into a closure")
+      {
+        CHECK(runtime::equal(eval_compiled("(let* [x (clojure.core/- 5 2) f (fn* [] "
+                                           "(clojure.core/* x 2))] (f))"),
+                             runtime::make_box(6)));
+      }
+
+      SUBCASE("comparison as a value")
+      {
+        CHECK(runtime::equal(
+          eval_compiled("(let* [a 1 b 2.0] [(clojure.core/< a b) (clojure.core/== a 1.0)])"),
+          __rt_ctx->read_string("[true true]")));
+      }
+
+      SUBCASE("long let chain")
+      {
+        /* Each binding refers to the previous one twice, so without memoization, inferring
+         * the last one would walk 2^n paths. */
+        util::string_builder sb;
+        sb("(let* [b0 1");
+        for(usize i{ 1 }; i <= 60; ++i)
+        {
+          util::format_to(sb,
+                          " b{} (clojure.core/- (clojure.core/+ b{} b{}) b{})",
+                          i,
+                          i - 1,
+                          i - 1,
+                          i - 1);
+        }
+        sb("] b60)");
+        CHECK(runtime::equal(eval_compiled(sb.view()), runtime::make_box(1)));
+      }
+    }
+
+    TEST_CASE("unboxed math benchmark")
+    {
+      /* The first loop is all primitives, so nothing in it allocates. The second goes through
+       * a local fn, which keeps everything boxed. */
+      auto const unboxed(compile_hot(__rt_ctx->eval_string(
+        "(fn* [] (loop* [i 0 sum 0] (if (clojure.core/< i 1000000) (recur (clojure.core/inc i) "
+        "(clojure.core/+ sum i)) sum)))")));
+      auto const boxed(compile_hot(__rt_ctx->eval_string(
+        "(fn* [] (let* [add clojure.core/+] (loop* [i 0 sum 0] (if (clojure.core/< i 1000000) "
+        "(recur (add i 1) (add sum i)) sum))))")));
+      CHECK(runtime::equal(runtime::dynamic_call(unboxed), runtime::dynamic_call(boxed)));
+
+      ankerl::nanobench::Bench bench;
+      bench.title("numeric loop").unit("1M iterations").minEpochIterations(5);
+      bench.run("unboxed", [&] {
+        ankerl::nanobench::doNotOptimizeAway(runtime::dynamic_call(unboxed));
+      });
+      bench.run("boxed", [&] {
+        ankerl::nanobench::doNotOptimizeAway(runtime::dynamic_call(boxed));
+      });
+    }
+
+    TEST_CASE("direct call benchmark")
+    {
+      __rt_ctx->eval_string("(def direct-call-bench-inc (fn* [x] (clojure.core/inc x)))");
+      compile_hot(__rt_ctx->eval_string("direct-call-bench-inc"), runtime::make_box(1));
+
+      /* Calling through the var gets a direct call. Calling through a local always goes
+       * through jank_call1, which is the dynamic path. */
+      auto const direct(compile_hot(__rt_ctx->eval_string(
+        "(fn* [] (loop* [i 0] (if (clojure.core/< i 1000000) (recur (direct-call-bench-inc i)) "
+        "i)))")));
+      auto const dynamic(compile_hot(__rt_ctx->eval_string(
+        "(fn* [] (let* [f direct-call-bench-inc] (loop* [i 0] (if (clojure.core/< i 1000000) "
+        "(recur (f i)) i))))")));
+
+      ankerl::nanobench::Bench bench;
+      bench.title("fn call through var").unit("1M calls").minEpochIterations(5);
+      bench.run("direct", [&] {
+        ankerl::nanobench::doNotOptimizeAway(runtime::dynamic_call(direct));
+      });
+      bench.run("dynamic", [&] {
+        ankerl::nanobench::doNotOptimizeAway(runtime::dynamic_call(dynamic));
+      });
+    }
+
+    TEST_CASE("optimization level benchmark")
+    {
+      /* Only modules made after the level changes are affected, so each level gets fresh
+       * fns. */
+      auto const original_level(__rt_ctx->jit_prc.optimization_level);
+      auto const interpret(__rt_ctx->interpret);
+      auto const background(__rt_ctx->background_jit);
+      util::scope_exit const restore{ [=] {
+        __rt_ctx->jit_prc.optimization_level = original_level;
+        __rt_ctx->interpret = interpret;
+        __rt_ctx->background_jit = background;
+      } };
+
+      /* The level is read whenever a module is made, including on the background JIT
+       * thread. So everything is compiled up front, on this thread, and nothing can still
+       * be compiling in the background while we change the level. */
+      __rt_ctx->interpret = false;
+      __rt_ctx->background_jit = false;
+      evaluate::await_background_jit();
+
+      ankerl::nanobench::Bench numeric_bench;
+      numeric_bench.title("numeric code by -O").unit("call").minEpochIterations(5);
+      ankerl::nanobench::Bench collection_bench;
+      collection_bench.title("collection code by -O").unit("call").minEpochIterations(5);
+
+      object_ref expected_numeric{}, expected_collection{};
+      for(i64 level{}; level <= 3; ++level)
+      {
+        __rt_ctx->jit_prc.optimization_level = level;
+
+        /* Arithmetic spread over a few fns, which the higher levels can inline together. */
+        auto const numeric(__rt_ctx->eval_string(
+          "(let* [square (fn* [x] (clojure.core/* x x)) "
+          "       step (fn* [acc i] (clojure.core/+ acc (clojure.core/rem (square i) 7)))] "
+          "  (fn* [] (loop* [i 0 acc 0] "
+          "    (if (clojure.core/< i 100000) (recur (clojure.core/inc i) (step acc i)) acc))))"));
+        auto const collection(__rt_ctx->eval_string(
+          "(fn* [] (let* [v (loop* [i 0 v []] "
+          "                   (if (clojure.core/< i 10000) "
+          "                     (recur (clojure.core/inc i) (clojure.core/conj v i)) v)) "
+          "               m (clojure.core/reduce "
+          "                   (fn* [m x] (clojure.core/assoc m (clojure.core/rem x 100) x)) {} v)] "
+          "  (clojure.core/+ (clojure.core/count v) (clojure.core/count m))))"));
+
+        auto const numeric_result(runtime::dynamic_call(numeric));
+        auto const collection_result(runtime::dynamic_call(collection));
+        if(level == 0)
+        {
+          expected_numeric = numeric_result;
+          expected_collection = collection_result;
+        }
+        CHECK(runtime::equal(numeric_result, expected_numeric));
+        CHECK(runtime::equal(collection_result, expected_collection));
+
+        auto const name(util::format("-O{}", level));
+        numeric_bench.run(name.c_str(), [&] {
+          ankerl::nanobench::doNotOptimizeAway(runtime::dynamic_call(numeric));
+        });
+        collection_bench.run(name.c_str(), [&] {
+          ankerl::nanobench::doNotOptimizeAway(runtime::dynamic_call(collection));
+        });
+      }
+    }
+  }
+}
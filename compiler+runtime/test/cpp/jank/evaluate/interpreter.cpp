@@ -0,0 +1,161 @@
+#include <nanobench.h>
+
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/obj/interpreted_function.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/equal.hpp>
+#include <jank/runtime/behavior/callable.hpp>
+#include <jank/runtime/rtti.hpp>
+#include <jank/evaluate/interpreter.hpp>
+#include <jank/util/scope_exit.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::evaluate
+{
+  using namespace jank::runtime;
+
+  TEST_SUITE("interpreter")
+  {
+    TEST_CASE("special forms")
+    {
+      CHECK(equal(__rt_ctx->eval_string("(let* [a 1 b (clojure.core/+ a 1)] [a b])"),
+                  __rt_ctx->read_string("[1 2]")));
+      CHECK(equal(__rt_ctx->eval_string("(let* [a 1] (let* [a 2] a))"), make_box(2)));
+      CHECK(equal(__rt_ctx->eval_string(
+                    "(loop* [i 0 acc []] (if (clojure.core/< i 3) (recur (clojure.core/inc i) "
+                    "(clojure.core/conj acc i)) acc))"),
+                  __rt_ctx->read_string("[0 1 2]")));
+      CHECK(equal(__rt_ctx->eval_string(
+                    "(letfn* [even? (fn* even? [n] (if (clojure.core/= 0 n) true (odd? "
+                    "(clojure.core/dec n)))) odd? (fn* odd? [n] (if (clojure.core/= 0 n) false "
+                    "(even? (clojure.core/dec n))))] (even? 10))"),
+                  jank_true));
+      CHECK(equal(__rt_ctx->eval_string("(clojure.core/case 2 1 :one 2 :two :other)"),
+                  __rt_ctx->intern_keyword("two").expect_ok()));
+      CHECK(equal(__rt_ctx->eval_string("(clojure.core/case 3 1 :one 2 :two :other)"),
+                  __rt_ctx->intern_keyword("other").expect_ok()));
+    }
+
+    TEST_CASE("try")
+    {
+      __rt_ctx->eval_string("(def interpreter-finally (clojure.core/atom 0))");
+      CHECK(equal(__rt_ctx->eval_string("(try (throw :boom) (catch e e) (finally "
+                                        "(clojure.core/swap! interpreter-finally "
+                                        "clojure.core/inc)))"),
+                  __rt_ctx->intern_keyword("boom").expect_ok()));
+      CHECK(equal(__rt_ctx->eval_string("(let* [e 1] (try e (catch e 2)))"), make_box(1)));
+      CHECK_THROWS(__rt_ctx->eval_string("(try (throw :boom) (finally (clojure.core/swap! "
+                                         "interpreter-finally clojure.core/inc)))"));
+      CHECK(equal(__rt_ctx->eval_string("@interpreter-finally"), make_box(2)));
+    }
+
+    TEST_CASE("fns")
+    {
+      auto const f(__rt_ctx->eval_string("(let* [x 10] (fn* ([] x) ([a] (clojure.core/+ a x)) "
+                                         "([a & more] (clojure.core/apply clojure.core/+ a x "
+                                         "more))))"));
+      CHECK(f->type == object_type::interpreted_function);
+      CHECK(equal(dynamic_call(f), make_box(10)));
+      CHECK(equal(dynamic_call(f, make_box(1)), make_box(11)));
+      CHECK(equal(dynamic_call(f, make_box(1), make_box(2), make_box(3)), make_box(16)));
+
+      auto const fact(__rt_ctx->eval_string(
+        "(fn* fact [n] (if (clojure.core/< n 2) 1 (clojure.core/* n (fact (clojure.core/dec "
+        "n)))))"));
+      CHECK(equal(dynamic_call(fact, make_box(5)), make_box(120)));
+      CHECK(__rt_ctx->eval_string("((fn* self [] self))")->type
+            == object_type::interpreted_function);
+
+      /* A later binding which shadows a closed over local doesn't change the closure. */
+      CHECK(equal(__rt_ctx->eval_string("(let* [x 1 f (fn* [] x) x 2] (f))"), make_box(1)));
+      CHECK(equal(__rt_ctx->eval_string("(let* [x 1 f (fn* [] x) x 2] [(f) x])"),
+                  __rt_ctx->read_string("[1 2]")));
+    }
+
+    TEST_CASE("hot fns are compiled")
+    {
+      auto const threshold(__rt_ctx->jit_threshold);
+      auto const background(__rt_ctx->background_jit);
+      __rt_ctx->jit_threshold = 5;
+      __rt_ctx->background_jit = false;
+      util::scope_exit const restore{ [=]() {
+        __rt_ctx->jit_threshold = threshold;
+        __rt_ctx->background_jit = background;
+      } };
+
+      auto const f(__rt_ctx->eval_string(
+        "(let* [y 2] (fn* [x] (clojure.core/* (clojure.core/inc x) y)))"));
+      auto const typed_f(expect_object<obj::interpreted_function>(f));
+      for(i64 i{}; i < 10; ++i)
+      {
+        CHECK(equal(dynamic_call(f, make_box(i)), make_box((i + 1) * 2)));
+      }
+      CHECK(typed_f->tier->state.load() == function_tier_state::compiled);
+      CHECK(typed_f->compiled.load() != nullptr);
+
+      /* Long running loops are compiled part way through. */
+      CHECK(equal(__rt_ctx->eval_string("(loop* [i 0 acc 0] (if (clojure.core/< i 100) (recur "
+                                        "(clojure.core/inc i) (clojure.core/+ acc i)) acc))"),
+                  make_box(4950)));
+
+      /* A fn which recurses into the fn enclosing it can't be compiled on its own. */
+      auto const outer(__rt_ctx->eval_string(
+        "(fn* outer [n] (if (clojure.core/< n 1) :done ((fn* [] (outer (clojure.core/dec "
+        "n))))))"));
+      CHECK(equal(dynamic_call(outer, make_box(20)), __rt_ctx->intern_keyword("done").expect_ok()));
+
+      /* Compiled instances capture the same values as the interpreted ones. */
+      auto const shadowed(__rt_ctx->eval_string("(let* [x 1 f (fn* [] x) x 2] f)"));
+      for(i64 i{}; i < 10; ++i)
+      {
+        CHECK(equal(dynamic_call(shadowed), make_box(1)));
+      }
+      CHECK(expect_object<obj::interpreted_function>(shadowed)->compiled.load() != nullptr);
+    }
+
+    TEST_CASE("hot fns are compiled in the background")
+    {
+      auto const threshold(__rt_ctx->jit_threshold);
+      auto const background(__rt_ctx->background_jit);
+      __rt_ctx->jit_threshold = 5;
+      __rt_ctx->background_jit = true;
+      util::scope_exit const restore{ [=]() {
+        __rt_ctx->jit_threshold = threshold;
+        __rt_ctx->background_jit = background;
+      } };
+
+      auto const f(__rt_ctx->eval_string("(fn* [x] (clojure.core/* x 3))"));
+      auto const typed_f(expect_object<obj::interpreted_function>(f));
+      for(i64 i{}; i < 5; ++i)
+      {
+        CHECK(equal(dynamic_call(f, make_box(i)), make_box(i * 3)));
+      }
+
+      /* Calls keep being interpreted while the fn is compiled. */
+      CHECK(typed_f->tier->state.load() != function_tier_state::interpreted);
+      CHECK(equal(dynamic_call(f, make_box(7)), make_box(21)));
+
+      await_background_jit();
+      CHECK(typed_f->tier->state.load() == function_tier_state::compiled);
+      CHECK(equal(dynamic_call(f, make_box(8)), make_box(24)));
+      CHECK(typed_f->compiled.load() != nullptr);
+    }
+
+    TEST_CASE("interpret vs JIT benchmark")
+    {
+      auto const interpret(__rt_ctx->interpret);
+      util::scope_exit const restore{ [=]() { __rt_ctx->interpret = interpret; } };
+      static constexpr auto form{ "(let* [m {:a 1 :b 2}] (clojure.core/+ (:a m) (:b m)))" };
+
+      ankerl::nanobench::Bench bench;
+      bench.title("top-level form").unit("form").minEpochIterations(10);
+      __rt_ctx->interpret = true;
+      bench.run("interpret",
+                [&] { ankerl::nanobench::doNotOptimizeAway(__rt_ctx->eval_string(form)); });
+      __rt_ctx->interpret = false;
+      bench.run("jit", [&] { ankerl::nanobench::doNotOptimizeAway(__rt_ctx->eval_string(form)); });
+    }
+  }
+}
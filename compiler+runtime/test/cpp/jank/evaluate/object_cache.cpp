@@ -0,0 +1,126 @@
+#include <chrono>
+#include <filesystem>
+
+#include <unistd.h>
+
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/equal.hpp>
+#include <jank/evaluate/object_cache.hpp>
+#include <jank/util/fmt.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::evaluate::object_cache
+{
+  using namespace jank::runtime;
+
+  static usize cached_object_count()
+  {
+    std::filesystem::path const dir{ util::format("{}/forms", __rt_ctx->binary_cache_dir) };
+    if(!std::filesystem::exists(dir))
+    {
+      return 0;
+    }
+    return static_cast<usize>(std::distance(std::filesystem::directory_iterator{ dir },
+                                            std::filesystem::directory_iterator{}));
+  }
+
+  /* Turns on the cache, pointed at a fresh dir, for the lifetime of the fixture. The real
+   * binary cache dir is left alone and the fresh one is removed afterward. Everything else
+   * keeps the default options, including the interpreter. */
+  struct cache_fixture
+  {
+    cache_fixture()
+      : jit_cache{ __rt_ctx->jit_cache }
+      , binary_cache_dir{ __rt_ctx->binary_cache_dir }
+      , dir{ std::filesystem::temp_directory_path()
+             / util::format(
+                 "jank-object-cache-{}-{}",
+                 getpid(),
+                 static_cast<i64>(std::chrono::steady_clock::now().time_since_epoch().count()))
+                 .c_str() }
+    {
+      __rt_ctx->jit_cache = true;
+      __rt_ctx->binary_cache_dir = dir.c_str();
+    }
+
+    ~cache_fixture()
+    {
+      __rt_ctx->jit_cache = jit_cache;
+      __rt_ctx->binary_cache_dir = binary_cache_dir;
+      std::error_code ec;
+      std::filesystem::remove_all(dir, ec);
+    }
+
+    bool jit_cache{};
+    jtl::immutable_string binary_cache_dir;
+    std::filesystem::path dir;
+  };
+
+  TEST_SUITE("object_cache")
+  {
+    TEST_CASE_FIXTURE(cache_fixture, "forms are keyed on their content and dependencies")
+    {
+      REQUIRE(__rt_ctx->interpret);
+
+      /* Vars live for the whole process, so these names are unique to this run. */
+      auto const dep(util::format("object-cache-dep-{}", getpid()));
+      __rt_ctx->eval_string(util::format("(def {} 1)", dep));
+      auto const form(util::format("(let* [f (fn* [] {})] (f))", dep));
+
+      CHECK(equal(__rt_ctx->eval_string(form), make_box(1)));
+      auto const after(cached_object_count());
+      CHECK(after > 0);
+
+      /* The same form is only compiled once. */
+      CHECK(equal(__rt_ctx->eval_string(form), make_box(1)));
+      CHECK(cached_object_count() == after);
+
+      /* Redefining a var it depends on gives the form a new key. */
+      __rt_ctx->eval_string(util::format("(def {} 2)", dep));
+      CHECK(equal(__rt_ctx->eval_string(form), make_box(2)));
+      CHECK(cached_object_count() > after);
+    }
+
+    TEST_CASE_FIXTURE(cache_fixture, "dependencies are followed transitively")
+    {
+      /* The form only refers to outer, which expands into inner. Redefining inner doesn't
+       * redefine outer, but the form still needs a new key, since its expansion changed. */
+      auto const outer(util::format("object-cache-outer-{}", getpid()));
+      auto const inner(util::format("object-cache-inner-{}", getpid()));
+      __rt_ctx->eval_string(util::format("(clojure.core/defmacro {} [] 1)", inner));
+      __rt_ctx->eval_string(
+        util::format("(clojure.core/defmacro {} [] (clojure.core/list (quote {})))", outer, inner));
+      auto const form(util::format("(let* [f (fn* [] ({}))] (f))", outer));
+
+      CHECK(equal(__rt_ctx->eval_string(form), make_box(1)));
+      auto const after(cached_object_count());
+
+      __rt_ctx->eval_string(util::format("(clojure.core/defmacro {} [] 2)", inner));
+      CHECK(equal(__rt_ctx->eval_string(form), make_box(2)));
+      CHECK(cached_object_count() > after);
+    }
+
+    TEST_CASE_FIXTURE(cache_fixture, "cached forms are compiled")
+    {
+      /* With the cache on, the fn isn't interpreted, so the var holds the compiled fn. */
+      auto const name(util::format("object-cache-compiled-{}", getpid()));
+      __rt_ctx->eval_string(util::format("(def {} (fn* [] 1))", name));
+      CHECK(__rt_ctx->eval_string(name)->type == object_type::jit_function);
+
+      /* Without it, the interpreter is used as usual. */
+      __rt_ctx->jit_cache = false;
+      __rt_ctx->eval_string(util::format("(def {} (fn* [] 2))", name));
+      CHECK(__rt_ctx->eval_string(name)->type == object_type::interpreted_function);
+    }
+
+    TEST_CASE_FIXTURE(cache_fixture, "eval isn't cached")
+    {
+      auto const before(cached_object_count());
+      CHECK(equal(__rt_ctx->eval(__rt_ctx->read_string("(let* [a 1] a)")), make_box(1)));
+      CHECK(cached_object_count() == before);
+    }
+  }
+}
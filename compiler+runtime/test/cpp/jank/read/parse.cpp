@@ -906,6 +906,17 @@ namespace jank::read::parse
         CHECK(equal(get(m, __rt_ctx->intern_keyword("foo").expect_ok()), jank_true));
       }
 
+      SUBCASE("Symbol meta for a metadatable target")
+      {
+        lex::processor lp{ "^long foo" };
+        processor p{ lp.begin(), lp.end() };
+        auto const r(p.next());
+        CHECK(equal(r.expect_ok().unwrap().ptr, make_box<obj::symbol>("foo")));
+        auto const m{ meta(r.expect_ok().unwrap().ptr) };
+        CHECK(equal(get(m, __rt_ctx->intern_keyword("tag").expect_ok()),
+                    make_box<obj::symbol>("long")));
+      }
+
       SUBCASE("Keyword meta for non-metadatable target")
       {
         lex::processor lp{ "^:foo nil" };
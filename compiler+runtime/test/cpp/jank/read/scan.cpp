@@ -0,0 +1,267 @@
+#include <algorithm>
+
+#include <nanobench.h>
+
+#include <jank/read/lex.hpp>
+#include <jank/read/scan.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/module/loader.hpp>
+#include <jank/util/fmt.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+using namespace std::string_view_literals;
+
+namespace jank::read::lex
+{
+  /* Every ISA this CPU supports, from the scalar one up. */
+  static native_vector<scan::isa> supported_isas()
+  {
+    native_vector<scan::isa> ret;
+    for(auto i(static_cast<u8>(scan::isa::scalar)); i <= static_cast<u8>(scan::best_isa()); ++i)
+    {
+      ret.emplace_back(static_cast<scan::isa>(i));
+    }
+    return ret;
+  }
+
+  /* Runs the fn once with each supported ISA, going back to the best one afterward. */
+  template <typename F>
+  static void with_each_isa(F const &f)
+  {
+    for(auto const i : supported_isas())
+    {
+      scan::use_isa(i);
+      f(i);
+    }
+    scan::use_isa(scan::best_isa());
+  }
+
+  static native_vector<token> lex_all(native_persistent_string_view const source)
+  {
+    native_vector<token> ret;
+    processor p{ source };
+    for(auto const &t : p)
+    {
+      if(t.is_err())
+      {
+        break;
+      }
+      ret.emplace_back(t.expect_ok());
+    }
+    return ret;
+  }
+
+  static token first_token(native_persistent_string_view const source)
+  {
+    processor p{ source };
+    auto const res(*p.begin());
+    REQUIRE(res.is_ok());
+    return res.expect_ok();
+  }
+
+  /* A big EDN map of vectors of maps, like a config, or data dump, might be. */
+  static jtl::immutable_string generate_edn(usize const entries)
+  {
+    native_transient_string ret{ "{" };
+    for(usize i{}; i < entries; ++i)
+    {
+      ret += util::format(":entry/k{} [", i);
+      ret += util::format("{:id {} :name \"entry number {}\"", i, i);
+      ret += " :tags #{:a :b :c} :ratio 1/3}\n";
+      ret += "           {:nested {:deep [1 2 3 4.5 \\c nil true false]}}]";
+      ret += util::format(" ; entry {}\n", i);
+    }
+    ret += "}";
+    return ret;
+  }
+
+  static jtl::immutable_string read_core_source()
+  {
+    auto const found(
+      runtime::__rt_ctx->module_loader.find("clojure.core", runtime::module::origin::source));
+    REQUIRE(found.is_ok());
+    auto const &entry(found.expect_ok().sources.jank.unwrap());
+    auto const file(runtime::module::loader::read_file(entry.path));
+    REQUIRE(file.is_ok());
+    return file.expect_ok().view();
+  }
+
+  TEST_SUITE("scan")
+  {
+    TEST_CASE("ISAs agree with scalar")
+    {
+      /* Long enough to go through the vector loops, with every interesting byte landing
+       * in each lane at some point. */
+      native_vector<jtl::immutable_string> inputs{
+        "",
+        " ",
+        "  \t\n\r\f\v,,, x",
+        "abcdefghijklmnopqrstuvwxyz-ABCDEFGHIJKLMNOPQRSTUVWXYZ_0123456789?!*+=<>.&#%/ x",
+        "some-long-symbol-name-which-spans-several-vectors/and-a-namespace-too(",
+        "this is a comment which goes on for quite a while, past a few vectors\nnext",
+        "a string with an \\n escape and a \"quote\" inside of it, plus more text",
+        "λ-symbols-are-not-ascii-so-they-stop-the-run",
+        "                                                    \xce\xbb trailing",
+        "no newline in here at all, but it is a fairly long line of text, really",
+      };
+      std::string every_byte;
+      for(usize i{}; i < 4; ++i)
+      {
+        for(int c{ 1 }; c < 256; ++c)
+        {
+          every_byte.push_back(static_cast<char>(c));
+        }
+      }
+      inputs.emplace_back(every_byte);
+
+      for(auto const &input : inputs)
+      {
+        for(usize offset{}; offset < std::min<usize>(input.size(), 40); ++offset)
+        {
+          auto const data(input.data() + offset);
+          auto const size(input.size() - offset);
+
+          scan::use_isa(scan::isa::scalar);
+          auto const whitespace(scan::whitespace(data, size));
+          auto const comment(scan::comment(data, size));
+          auto const symbol(scan::symbol(data, size));
+          auto const string(scan::string(data, size));
+          auto const newlines(scan::find_newlines(data, size));
+
+          with_each_isa([&](scan::isa const i) {
+            CAPTURE(scan::isa_str(i));
+            CAPTURE(offset);
+            CHECK(scan::whitespace(data, size) == whitespace);
+            CHECK(scan::comment(data, size) == comment);
+            CHECK(scan::symbol(data, size) == symbol);
+            CHECK(scan::string(data, size) == string);
+            auto const found(scan::find_newlines(data, size));
+            CHECK(found.count == newlines.count);
+            if(newlines.count != 0)
+            {
+              CHECK(found.last == newlines.last);
+            }
+          });
+        }
+      }
+    }
+
+    TEST_CASE("Runs")
+    {
+      CHECK(scan::whitespace(" ,\t\n x", 6) == 5);
+      CHECK(scan::comment("; foo bar\nbaz", 13) == 9);
+      CHECK(scan::symbol("foo/bar-baz? 1", 14) == 12);
+      CHECK(scan::symbol("foo(bar)", 8) == 3);
+      CHECK(scan::symbol("a'b", 3) == 1);
+      CHECK(scan::symbol("a:b@c", 5) == 1);
+      CHECK(scan::string("foo bar\\\"baz\"", 13) == 7);
+      CHECK(scan::string("foo\"", 4) == 3);
+      /* Non-ASCII is left for the lexer to decode. */
+      CHECK(scan::symbol("ab\xce\xbb", 4) == 2);
+      CHECK(scan::comment("ab\xce\xbb", 4) == 2);
+
+      auto const found(scan::find_newlines("a\nb\nc", 5));
+      CHECK(found.count == 2);
+      CHECK(found.last == 3);
+    }
+
+    TEST_CASE("Lexing is the same with each ISA")
+    {
+      auto const core(read_core_source());
+      auto const edn(generate_edn(500));
+
+      scan::use_isa(scan::isa::scalar);
+      auto const core_tokens(lex_all(core));
+      auto const edn_tokens(lex_all(edn));
+      CHECK(!core_tokens.empty());
+      CHECK(!edn_tokens.empty());
+
+      with_each_isa([&](scan::isa const i) {
+        CAPTURE(scan::isa_str(i));
+        CHECK(lex_all(core) == core_tokens);
+        CHECK(lex_all(edn) == edn_tokens);
+      });
+    }
+
+    TEST_CASE("Symbols end where the lexer says")
+    {
+      /* Each of these chars is printable, but can't be within a symbol or keyword. The
+       * long inputs get the vector loops to the char. */
+      static native_persistent_string_view const long_name{
+        "a-symbol-name-which-is-long-enough-to-span-vectors"
+      };
+      for(auto const c : { '\'', ':', '@', '$', '|' })
+      {
+        CAPTURE(c);
+        auto const short_source(util::format("x{}y", c));
+        auto const long_source(util::format("{}{}y", long_name, c));
+        auto const keyword_source(util::format(":a{}b", c));
+        with_each_isa([&](scan::isa const i) {
+          CAPTURE(scan::isa_str(i));
+          CHECK(first_token(short_source) == token{ 0, 1, token_kind::symbol, "x"sv });
+          CHECK(first_token(long_source)
+                == token{ 0, long_name.size(), token_kind::symbol, long_name });
+          CHECK(first_token(keyword_source) == token{ 0, 2, token_kind::keyword, "a"sv });
+        });
+      }
+
+      with_each_isa([&](scan::isa const i) {
+        CAPTURE(scan::isa_str(i));
+        CHECK(first_token("x'") == token{ 0, 1, token_kind::symbol, "x"sv });
+      });
+    }
+
+    TEST_CASE("Unicode in comments")
+    {
+      auto const tokens(lex_all("; λ → ∀ ok\n1"));
+      REQUIRE(tokens.size() == 2);
+      CHECK(tokens[0].kind == token_kind::comment);
+      CHECK(std::get<native_persistent_string_view>(tokens[0].data) == " λ → ∀ ok"sv);
+      CHECK(tokens[1].kind == token_kind::integer);
+      CHECK(tokens[1].start.line == 2);
+      CHECK(tokens[1].start.col == 1);
+    }
+
+    TEST_CASE("Positions across long runs")
+    {
+      native_transient_string source;
+      for(usize i{}; i < 40; ++i)
+      {
+        source += "a-long-symbol-name-to-skip-over ; and a comment after it\n";
+      }
+      source += "  done";
+
+      auto const tokens(lex_all(source));
+      REQUIRE(!tokens.empty());
+      auto const &last(tokens.back());
+      CHECK(last.start.line == 41);
+      CHECK(last.start.col == 3);
+      CHECK(last.end.col == 7);
+    }
+
+    TEST_CASE("Lexer throughput benchmark")
+    {
+      auto const core(read_core_source());
+      auto const edn(generate_edn(20'000));
+
+      ankerl::nanobench::Bench bench;
+      bench.title("lexer throughput").unit("byte").minEpochIterations(5);
+      auto const lex([](native_persistent_string_view const source) {
+        processor p{ source };
+        for(auto const &t : p)
+        {
+          ankerl::nanobench::doNotOptimizeAway(t);
+        }
+      });
+      with_each_isa([&](scan::isa const i) {
+        bench.batch(core.size())
+          .run(util::format("clojure/core.jank {}", scan::isa_str(i)).c_str(),
+               [&] { lex(core); });
+        bench.batch(edn.size())
+          .run(util::format("generated EDN {}", scan::isa_str(i)).c_str(), [&] { lex(edn); });
+      });
+    }
+  }
+}
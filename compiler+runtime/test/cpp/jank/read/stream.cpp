@@ -0,0 +1,196 @@
+#include <thread>
+
+#include <unistd.h>
+
+#include <jank/read/stream.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core/equal.hpp>
+#include <jank/runtime/core/to_string.hpp>
+#include <jank/util/fmt.hpp>
+#include <jank/util/string_builder.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::read
+{
+  using namespace jank::runtime;
+
+  /* Writes the input into a pipe from another thread, a few bytes at a time, so the
+   * stream sees it arrive in pieces, like it would from a socket. */
+  struct pipe_writer
+  {
+    pipe_writer(native_persistent_string_view const input, usize const piece_size)
+    {
+      REQUIRE(::pipe(fds) == 0);
+      writer = std::thread{ [this, input, piece_size] {
+        for(usize offset{}; offset < input.size(); offset += piece_size)
+        {
+          auto const size(std::min(piece_size, input.size() - offset));
+          static_cast<void>(::write(fds[1], input.data() + offset, size));
+        }
+        ::close(fds[1]);
+      } };
+    }
+
+    ~pipe_writer()
+    {
+      writer.join();
+      ::close(fds[0]);
+    }
+
+    int fds[2]{};
+    std::thread writer;
+  };
+
+  static native_vector<object_ref> read_all(stream &s)
+  {
+    native_vector<object_ref> ret;
+    while(true)
+    {
+      auto const res(s.next());
+      REQUIRE(res.is_ok());
+      if(res.expect_ok().is_none())
+      {
+        break;
+      }
+      ret.emplace_back(res.expect_ok().unwrap().ptr);
+    }
+    return ret;
+  }
+
+  static native_vector<object_ref> read_string_all(native_persistent_string_view const input)
+  {
+    lex::processor l_prc{ input };
+    parse::processor p_prc{ l_prc.begin(), l_prc.end() };
+    native_vector<object_ref> ret;
+    for(auto const &form : p_prc)
+    {
+      ret.emplace_back(form.expect_ok().unwrap().ptr);
+    }
+    return ret;
+  }
+
+  TEST_SUITE("stream")
+  {
+    TEST_CASE("Forms split across chunks")
+    {
+      static constexpr native_persistent_string_view input{
+        "(def a 1) ; a comment\n"
+        "{:name \"some string which spans a few chunks\" :tags #{:x :y}}\n"
+        "12345 6789 some/symbol :some/keyword\n"
+        "[1 2.5 3/4 \\a \\newline \"esc\\\"aped\"]\n"
+        ";; λ a comment with unicode\n"
+        "\"λ→∀\" #_ (ignored form) (f #(inc %))\n"
+        "last-symbol"
+      };
+      auto const expected(read_string_all(input));
+
+      for(usize const chunk_size : { 1, 3, 7, 16, 64, 4096 })
+      {
+        for(usize const piece_size : { 1, 5, 4096 })
+        {
+          CAPTURE(chunk_size);
+          CAPTURE(piece_size);
+          pipe_writer const writer{ input, piece_size };
+          stream s{ writer.fds[0], false, chunk_size };
+          auto const forms(read_all(s));
+          REQUIRE(forms.size() == expected.size());
+          for(usize i{}; i < forms.size(); ++i)
+          {
+            CAPTURE(runtime::to_code_string(expected[i]));
+            CHECK(runtime::equal(forms[i], expected[i]));
+          }
+        }
+      }
+    }
+
+    TEST_CASE("Forms bigger than a chunk")
+    {
+      /* A pipe only holds 64 KiB, so every refill of the default chunk size, or bigger,
+       * takes more than one read. */
+      util::string_builder sb;
+      sb("[");
+      for(usize i{}; i < 40'000; ++i)
+      {
+        util::format_to(sb, "{} ", i);
+      }
+      sb("] :after");
+      auto const input(sb.view());
+      REQUIRE(input.size() > 3 * stream::default_chunk_size);
+      auto const expected(read_string_all(input));
+
+      for(usize const piece_size : { 1000, 4096, 100'000 })
+      {
+        CAPTURE(piece_size);
+        pipe_writer const writer{ input, piece_size };
+        stream s{ writer.fds[0], false };
+        auto const forms(read_all(s));
+        REQUIRE(forms.size() == expected.size());
+        for(usize i{}; i < forms.size(); ++i)
+        {
+          CHECK(runtime::equal(forms[i], expected[i]));
+        }
+        CHECK(s.eof);
+      }
+    }
+
+    TEST_CASE("Empty input")
+    {
+      pipe_writer const writer{ "  ; nothing here\n", 4 };
+      stream s{ writer.fds[0], false, 4 };
+      CHECK(read_all(s).empty());
+    }
+
+    TEST_CASE("Memory is bounded by the biggest form")
+    {
+      native_transient_string input;
+      for(usize i{}; i < 20'000; ++i)
+      {
+        input += "{:event :tick :n 1234567 :tags [:a :b :c]}\n";
+      }
+
+      pipe_writer const writer{ input, 4096 };
+      stream s{ writer.fds[0], false, 1024 };
+      usize count{};
+      while(true)
+      {
+        auto const res(s.next());
+        REQUIRE(res.is_ok());
+        if(res.expect_ok().is_none())
+        {
+          break;
+        }
+        ++count;
+      }
+      CHECK(count == 20'000);
+      CHECK(s.eof);
+    }
+
+    TEST_CASE("Errors")
+    {
+      SUBCASE("Unterminated at the end of input")
+      {
+        pipe_writer const writer{ "(a b) (c d", 3 };
+        stream s{ writer.fds[0], false, 2 };
+        CHECK(s.next().is_ok());
+        CHECK(s.next().is_err());
+        /* There's nowhere to go on from, so it keeps failing. */
+        CHECK(s.next().is_err());
+      }
+
+      SUBCASE("Invalid input in the middle")
+      {
+        pipe_writer const writer{ "(a b) ) (c d)", 64 };
+        stream s{ writer.fds[0], false, 64 };
+        CHECK(s.next().is_ok());
+        CHECK(s.next().is_err());
+      }
+    }
+
+    TEST_CASE("Opening a file")
+    {
+      CHECK(stream::open("/this/file/does/not/exist.edn").is_err());
+    }
+  }
+}
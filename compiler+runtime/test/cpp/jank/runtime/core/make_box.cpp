@@ -0,0 +1,221 @@
+#include <thread>
+
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/math.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/detail/allocation_stats.hpp>
+#include <jank/runtime/perf.hpp>
+#include <jank/runtime/detail/gc_layout.hpp>
+#include <jank/runtime/obj/persistent_string.hpp>
+#include <jank/runtime/obj/symbol.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/runtime/core/equal.hpp>
+#include <jank/runtime/core/seq.hpp>
+#include <jank/runtime/behavior/callable.hpp>
+#include <jank/runtime/ns.hpp>
+#include <jank/util/fmt.hpp>
+#include <jank/util/scope_exit.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::runtime
+{
+  TEST_SUITE("make_box")
+  {
+    TEST_CASE("small integer cache")
+    {
+      CHECK(make_box(0) == make_box(0));
+      CHECK(make_box(integer_cache_min) == make_box(integer_cache_min));
+      CHECK(make_box(integer_cache_max) == make_box(integer_cache_max));
+      CHECK(make_box(integer_cache_max)->data == integer_cache_max);
+      CHECK(make_box(5u) == make_box(5ll));
+      CHECK(make_box(integer_cache_max + 1) != make_box(integer_cache_max + 1));
+      CHECK(make_box(integer_cache_min - 1) != make_box(integer_cache_min - 1));
+
+      SUBCASE("math results")
+      {
+        CHECK(add(make_box(3).erase(), make_box(4).erase()) == make_box(7).erase());
+        CHECK(inc(make_box(integer_cache_max - 1)) == make_box(integer_cache_max).erase());
+      }
+
+      SUBCASE("literals in generated code")
+      {
+        CHECK(__rt_ctx->eval_string("42") == make_box(42).erase());
+        CHECK(__rt_ctx->eval_string("((fn* [] -128))") == make_box(-128).erase());
+      }
+    }
+
+    TEST_CASE("character cache")
+    {
+      CHECK(make_box('a') == make_box('a'));
+      CHECK(make_box('a') != make_box('b'));
+      CHECK(make_box('\0')->data.size() == 1);
+    }
+
+    TEST_CASE("allocation stats")
+    {
+      auto const before(detail::box_allocation_totals());
+
+      for(i64 i{}; i < 100; ++i)
+      {
+        make_box(i);
+      }
+      auto const after_cached(detail::box_allocation_totals());
+      CHECK(after_cached.boxes == before.boxes);
+      CHECK(after_cached.cached_boxes == before.cached_boxes + 100);
+
+      for(i64 i{}; i < 100; ++i)
+      {
+        make_box(integer_cache_max + 1 + i);
+      }
+      auto const after(detail::box_allocation_totals());
+      CHECK(after.boxes == before.boxes + 100);
+      auto const integers(static_cast<u8>(object_type::integer));
+      CHECK(after.boxes_by_type[integers] == before.boxes_by_type[integers] + 100);
+
+      SUBCASE("other threads")
+      {
+        GC_allow_register_threads();
+        std::thread{ [] {
+          GC_stack_base stack_base{};
+          GC_get_stack_base(&stack_base);
+          GC_register_my_thread(&stack_base);
+          for(i64 i{}; i < 100; ++i)
+          {
+            make_box(integer_cache_max + 1 + i);
+          }
+          GC_unregister_my_thread();
+        } }.join();
+        /* The thread has exited, but its counts are kept. */
+        CHECK(detail::box_allocation_totals().boxes_by_type[integers]
+              == after.boxes_by_type[integers] + 100);
+      }
+    }
+
+    TEST_CASE("gc stats")
+    {
+      auto const collections_before(detail::current_collection_stats().collections);
+      GC_gcollect();
+      CHECK(detail::current_collection_stats().collections > collections_before);
+
+      auto const stats(perf::gc_stats());
+      auto const stat([&](char const * const key) {
+        return get(stats, __rt_ctx->intern_keyword(key).expect_ok());
+      });
+      CHECK(to_int(stat("heap-bytes")) > 0);
+      CHECK(to_int(stat("collections")) > 0);
+      CHECK(to_int(stat("total-pause-ns")) > 0);
+      CHECK(to_int(get(stat("boxes-by-type"), __rt_ctx->intern_keyword("integer").expect_ok()))
+            > 0);
+    }
+
+    TEST_CASE("sampled allocation sites")
+    {
+      perf::clear_allocation_sites();
+      perf::sample_allocations(make_box(1));
+      for(i64 i{}; i < 10; ++i)
+      {
+        make_box(integer_cache_max + 1 + i);
+      }
+      perf::sample_allocations(make_box(0));
+
+      auto const sites(perf::allocation_sites());
+      i64 samples{};
+      for(auto it(seq(sites)); !it.is_nil(); it = next(it))
+      {
+        samples += to_int(second(first(it)));
+      }
+      CHECK(samples >= 10);
+      perf::clear_allocation_sites();
+    }
+
+    TEST_CASE("sampled allocations are attributed to jank fns")
+    {
+      auto const interpret(__rt_ctx->interpret);
+      util::scope_exit const restore{ [=]() {
+        __rt_ctx->interpret = interpret;
+        perf::sample_allocations(make_box(0));
+        perf::clear_allocation_sites();
+      } };
+
+      /* Each call boxes a vector in the fn's own body, rather than in another jank fn which
+       * it calls, since samples go to the innermost jank fn. */
+      auto const sampled_calls([](bool const interpreted) {
+        __rt_ctx->interpret = interpreted;
+        perf::clear_allocation_sites();
+        perf::sample_allocations(make_box(1));
+        auto const fn(__rt_ctx->eval_string("(fn* allocation-site-fn [n] [n n])"));
+        for(i64 i{}; i < 10; ++i)
+        {
+          dynamic_call(fn, make_box(i));
+        }
+        perf::sample_allocations(make_box(0));
+
+        auto const site(make_box<obj::persistent_string>(
+          util::format("{}/allocation-site-fn", __rt_ctx->current_ns()->to_string())));
+        auto const samples(get(perf::allocation_sites(), site));
+        return samples.is_nil() ? 0 : to_int(samples);
+      });
+
+      SUBCASE("interpreted")
+      {
+        CHECK(sampled_calls(true) >= 10);
+      }
+
+      /* Sampling is on while the fn is compiled, so it tracks itself. */
+      SUBCASE("compiled")
+      {
+        CHECK(sampled_calls(false) >= 10);
+      }
+    }
+
+    TEST_CASE("typed layouts")
+    {
+      static constexpr usize word_size{ sizeof(GC_word) };
+      GC_word bitmap[GC_BITMAP_SIZE(obj::symbol)]{};
+      detail::gc_layout layout{ bitmap };
+      obj::symbol::gc_layout(layout);
+      auto const is_marked([&](usize const offset) {
+        return GC_get_bit(bitmap, offset / word_size) != 0;
+      });
+
+      CHECK(!is_marked(offsetof(obj::symbol, base)));
+      CHECK(is_marked(offsetof(obj::symbol, ns)));
+      CHECK(!is_marked(offsetof(obj::symbol, ns) + word_size));
+      CHECK(is_marked(offsetof(obj::symbol, name)));
+      CHECK(is_marked(offsetof(obj::symbol, meta)));
+      CHECK(!is_marked(offsetof(obj::symbol, hash)));
+      CHECK(is_marked(offsetof(obj::symbol, canonical)));
+    }
+
+    TEST_CASE("typed allocations survive collection")
+    {
+      native_vector<obj::persistent_string_ref> strings;
+      native_vector<obj::symbol_ref> symbols;
+      for(usize i{}; i < 1000; ++i)
+      {
+        /* Long enough to need their own buffers, which only the boxes point to. */
+        jtl::immutable_string const s{ util::format("some string which is long enough {}", i) };
+        strings.emplace_back(make_box<obj::persistent_string>(s));
+        auto const meta(obj::persistent_hash_map::create_unique(
+          std::make_pair(make_box(i), make_box<obj::persistent_string>(s))));
+        symbols.emplace_back(
+          make_box<obj::symbol>(meta, util::format("some.long.enough.namespace{}", i), s));
+      }
+
+      GC_gcollect();
+      GC_gcollect();
+
+      for(usize i{}; i < 1000; ++i)
+      {
+        jtl::immutable_string const s{ util::format("some string which is long enough {}", i) };
+        CHECK(strings[i]->data == s);
+        CHECK(symbols[i]->ns == util::format("some.long.enough.namespace{}", i));
+        CHECK(symbols[i]->name == s);
+        CHECK(equal(get(symbols[i]->meta.unwrap(), make_box(i)),
+                    make_box<obj::persistent_string>(s)));
+      }
+    }
+  }
+}
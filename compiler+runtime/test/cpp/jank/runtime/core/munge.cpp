@@ -0,0 +1,34 @@
+#include <jank/runtime/core/munge.hpp>
+#include <jank/runtime/module/loader.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::runtime::core
+{
+  TEST_SUITE("core runtime for munge")
+  {
+    TEST_CASE("demunge")
+    {
+      CHECK(demunge("foo_bar") == "foo-bar");
+      CHECK(demunge("_GT_") == ">");
+      CHECK(demunge("swap_BANG__GT_") == "swap!->");
+      CHECK(demunge("__") == "--");
+    }
+
+    TEST_CASE("demunge round trips")
+    {
+      for(auto const s : { "->", "=>", "<=", "a-b", "*ns*", "+'", "=GT-", "a?b!" })
+      {
+        CHECK(demunge(munge(s)) == s);
+      }
+    }
+
+    TEST_CASE("path_to_module")
+    {
+      CHECK(module::path_to_module("foo_bar/spam/meow.cljc") == "foo-bar.spam.meow");
+      CHECK(module::path_to_module("clojure/core.jank") == "clojure.core");
+      CHECK(module::path_to_module("meow.jank") == "meow");
+    }
+  }
+}
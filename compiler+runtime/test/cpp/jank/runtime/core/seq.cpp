@@ -2,6 +2,11 @@
 #include <jank/runtime/core/make_box.hpp>
 #include <jank/runtime/obj/persistent_vector.hpp>
 #include <jank/runtime/obj/persistent_list.hpp>
+#include <jank/runtime/core/equal.hpp>
+#include <jank/runtime/behavior/callable.hpp>
+#include <jank/runtime/context.hpp>
+
+#include <nanobench.h>
 
 /* This must go last; doctest and glog both define CHECK and family. */
 #include <doctest/doctest.h>
@@ -32,5 +37,137 @@ namespace jank::runtime::core
         make_box<obj::persistent_vector>(std::in_place, make_box('f'), make_box('g')),
         make_box<obj::persistent_list>(std::in_place, make_box('g'))));
     }
+
+    TEST_CASE("reduce")
+    {
+      auto const plus(__rt_ctx->eval_string("clojure.core/+"));
+      auto const sum([&](char const * const code) {
+        return reduce(plus, make_box(0), __rt_ctx->eval_string(code));
+      });
+
+      CHECK(equal(sum("(clojure.core/vec (clojure.core/range 1000))"), make_box(499500)));
+      CHECK(equal(sum("(clojure.core/nthnext (clojure.core/vec (clojure.core/range 1000)) 500)"),
+                  make_box(374750)));
+      CHECK(equal(sum("(clojure.core/set (clojure.core/range 1000))"), make_box(499500)));
+      CHECK(equal(sum("(clojure.core/range 1000)"), make_box(499500)));
+      CHECK(equal(sum("(clojure.core/range 10 0 -3)"), make_box(22)));
+      CHECK(equal(sum("(clojure.core/range 0.0 100.0)"), make_box(4950.0)));
+      CHECK(equal(sum("(clojure.core/map clojure.core/inc (clojure.core/range 100))"),
+                  make_box(5050)));
+      CHECK(equal(sum("nil"), make_box(0)));
+      CHECK(equal(reduce(__rt_ctx->eval_string("clojure.core/conj"),
+                         make_box<obj::persistent_vector>(),
+                         __rt_ctx->eval_string("{1 2}")),
+                  __rt_ctx->read_string("[[1 2]]")));
+
+      SUBCASE("reduced stops early")
+      {
+        auto const until_100(__rt_ctx->eval_string(
+          "(fn* [acc x] (if (clojure.core/<= 100 x) (clojure.core/reduced acc) "
+          "(clojure.core/+ acc x)))"));
+        CHECK(equal(reduce(until_100,
+                           make_box(0),
+                           __rt_ctx->eval_string("(clojure.core/vec (clojure.core/range 1000))")),
+                    make_box(4950)));
+        CHECK(equal(reduce(until_100,
+                           make_box(0),
+                           __rt_ctx->eval_string("(clojure.core/range 0.0 1000.0)")),
+                    make_box(4950.0)));
+        CHECK(equal(reduce(until_100, make_box(0), __rt_ctx->eval_string("(clojure.core/range)")),
+                    make_box(4950)));
+      }
+    }
+
+    TEST_CASE("reduce benchmark")
+    {
+      auto const sum_range(__rt_ctx->eval_string("(fn* [] (clojure.core/reduce clojure.core/+ "
+                                                  "(clojure.core/range 1e7)))"));
+      auto const big_vec(__rt_ctx->eval_string("(clojure.core/vec (clojure.core/range 1000000))"));
+      auto const into_vec(__rt_ctx->eval_string(
+        "(fn* [v] (clojure.core/into [] (clojure.core/map clojure.core/inc) v))"));
+
+      ankerl::nanobench::Bench bench;
+      bench.title("reduce").minEpochIterations(1);
+      bench.run("(reduce + (range 1e7))",
+                [&] { ankerl::nanobench::doNotOptimizeAway(dynamic_call(sum_range)); });
+      bench.run("(into [] (map inc) big-vec)",
+                [&] { ankerl::nanobench::doNotOptimizeAway(dynamic_call(into_vec, big_vec)); });
+    }
+
+    TEST_CASE("fold")
+    {
+      auto const plus(__rt_ctx->eval_string("clojure.core/+"));
+      auto const n(make_box(64));
+
+      SUBCASE("vector")
+      {
+        auto const v(__rt_ctx->eval_string("(clojure.core/vec (clojure.core/range 10000))"));
+        CHECK(equal(fold(n, plus, plus, v), make_box(49995000)));
+        CHECK(equal(fold(n, plus, plus, make_box<obj::persistent_vector>()), make_box(0)));
+      }
+
+      SUBCASE("order is preserved")
+      {
+        auto const v(__rt_ctx->eval_string("(clojure.core/vec (clojure.core/range 1000))"));
+        auto const res(fold(n,
+                            __rt_ctx->eval_string("(fn* ([] []) ([l r] (clojure.core/into l r)))"),
+                            __rt_ctx->eval_string("clojure.core/conj"),
+                            v));
+        CHECK(equal(res, v));
+      }
+
+      SUBCASE("hash map")
+      {
+        auto const m(__rt_ctx->eval_string(
+          "(clojure.core/zipmap (clojure.core/range 5000) (clojure.core/range 5000))"));
+        auto const res(
+          fold(n,
+               plus,
+               __rt_ctx->eval_string("(fn* [acc k v] (clojure.core/+ acc k v))"),
+               m));
+        CHECK(equal(res, make_box(24995000)));
+      }
+
+      SUBCASE("hash set")
+      {
+        auto const s(__rt_ctx->eval_string("(clojure.core/set (clojure.core/range 5000))"));
+        CHECK(equal(fold(n, plus, plus, s), make_box(12497500)));
+      }
+
+      SUBCASE("other seqables")
+      {
+        CHECK(equal(fold(n, plus, plus, __rt_ctx->eval_string("(clojure.core/range 100)")),
+                    make_box(4950)));
+        CHECK(equal(fold(n,
+                         plus,
+                         __rt_ctx->eval_string("(fn* [acc k v] (clojure.core/+ acc k v))"),
+                         __rt_ctx->eval_string("{1 2 3 4}")),
+                    make_box(10)));
+      }
+
+      SUBCASE("errors are rethrown")
+      {
+        auto const v(__rt_ctx->eval_string("(clojure.core/vec (clojure.core/range 1000))"));
+        CHECK_THROWS(fold(n,
+                          plus,
+                          __rt_ctx->eval_string("(fn* [acc x] (if (clojure.core/= x 500) "
+                                                "(throw :boom) (clojure.core/+ acc x)))"),
+                          v));
+      }
+    }
+
+    TEST_CASE("fold benchmark")
+    {
+      auto const v(__rt_ctx->eval_string("(clojure.core/vec (clojure.core/range 1000000))"));
+      auto const plus(__rt_ctx->eval_string("clojure.core/+"));
+      auto const n(make_box(512));
+      CHECK(equal(reduce(plus, make_box(0), v), fold(n, plus, plus, v)));
+
+      ankerl::nanobench::Bench bench;
+      bench.title("sum of a 1M vector").unit("vector").minEpochIterations(2);
+      bench.run("reduce",
+                [&] { ankerl::nanobench::doNotOptimizeAway(reduce(plus, make_box(0), v)); });
+      bench.run("fold", [&] { ankerl::nanobench::doNotOptimizeAway(fold(n, plus, plus, v)); });
+    }
   }
 }
@@ -0,0 +1,167 @@
+#include <array>
+#include <thread>
+
+#include <nanobench.h>
+#include <gc/gc_mark.h>
+
+#include <jank/runtime/detail/box_cache.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/equal.hpp>
+#include <jank/runtime/obj/cons.hpp>
+#include <jank/runtime/obj/number.hpp>
+#include <jank/runtime/obj/persistent_vector.hpp>
+#include <jank/runtime/rtti.hpp>
+#include <jank/util/fmt.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::runtime::detail
+{
+  template <typename F>
+  static void on_threads(usize const thread_count, F const &f)
+  {
+    GC_allow_register_threads();
+    native_vector<std::thread> threads;
+    for(usize i{}; i < thread_count; ++i)
+    {
+      threads.emplace_back([&f, i]() {
+        GC_stack_base stack_base{};
+        GC_get_stack_base(&stack_base);
+        GC_register_my_thread(&stack_base);
+        f(i);
+        GC_unregister_my_thread();
+      });
+    }
+    for(auto &t : threads)
+    {
+      t.join();
+    }
+  }
+
+  /* Past the small integer cache, so every one of these is a fresh box. */
+  static constexpr i64 first_uncached_integer{ 1'000'000 };
+
+  TEST_SUITE("box_cache")
+  {
+    TEST_CASE("boxes come from the thread's cache")
+    {
+      auto const a(make_box<obj::cons>(jank_nil, jank_nil));
+      REQUIRE(thread_box_cache != nullptr);
+      auto const size_class((sizeof(obj::cons) + box_cache::granule_size - 1)
+                              / box_cache::granule_size
+                            - 1);
+      auto const next(thread_box_cache->free_lists[size_class]);
+      if(next)
+      {
+        auto const b(make_box<obj::cons>(jank_nil, jank_nil));
+        CHECK(static_cast<void *>(b.data) == next);
+      }
+      CHECK(a->head.is_nil());
+    }
+
+    TEST_CASE("pointer free boxes stay pointer free")
+    {
+      auto const a(make_box<obj::integer>(first_uncached_integer));
+      REQUIRE(thread_box_cache != nullptr);
+      auto const size_class((sizeof(obj::integer) + box_cache::granule_size - 1)
+                              / box_cache::granule_size
+                            - 1);
+      auto const count(thread_box_cache->pointer_free_counts[size_class]);
+      if(count)
+      {
+        auto const next(thread_box_cache->pointer_free_boxes[size_class][count - 1]);
+        auto const b(make_box<obj::integer>(first_uncached_integer + 1));
+        CHECK(static_cast<void *>(b.data) == next);
+        CHECK(thread_box_cache->pointer_free_boxes[size_class][count - 1] == nullptr);
+      }
+      CHECK(a->data == first_uncached_integer);
+
+      /* The GC never scans their payloads, just as with GC_malloc_atomic. */
+      usize size{};
+      CHECK(GC_get_kind_and_size(a.data, &size) == GC_I_PTRFREE);
+      CHECK(GC_get_kind_and_size(make_box<obj::real>(1.5).data, &size) == GC_I_PTRFREE);
+      CHECK(GC_get_kind_and_size(make_box<obj::cons>(jank_nil, jank_nil).data, &size)
+            != GC_I_PTRFREE);
+    }
+
+    TEST_CASE("cached boxes survive collection")
+    {
+      static constexpr usize box_count{ 10'000 };
+      native_vector<obj::cons_ref> lists(4);
+      on_threads(lists.size(), [&](usize const thread) {
+        object_ref list{ jank_nil };
+        for(usize i{}; i < box_count; ++i)
+        {
+          list = make_box<obj::cons>(make_box(first_uncached_integer + static_cast<i64>(i)),
+                                     list);
+          if(i % 1000 == 0)
+          {
+            GC_gcollect();
+          }
+        }
+        lists[thread] = expect_object<obj::cons>(list);
+      });
+      GC_gcollect();
+
+      for(auto const &list : lists)
+      {
+        object_ref it{ list };
+        for(usize i{ box_count }; i > 0; --i)
+        {
+          auto const c(expect_object<obj::cons>(it));
+          CHECK(equal(c->head, make_box(first_uncached_integer + static_cast<i64>(i - 1))));
+          it = c->tail;
+        }
+        CHECK(it.is_nil());
+      }
+    }
+
+    TEST_CASE("allocation benchmark")
+    {
+      static constexpr usize box_count{ 100'000 };
+      ankerl::nanobench::Bench bench;
+      bench.title("box allocation").unit("box").minEpochIterations(5);
+      static constexpr std::array<usize, 4> thread_counts{ 1, 4, 16, 64 };
+      for(auto const thread_count : thread_counts)
+      {
+        bench.batch(thread_count * box_count)
+          .run(util::format("GC_malloc {} threads", thread_count).c_str(), [&] {
+            on_threads(thread_count, [&](usize) {
+              for(usize i{}; i < box_count; ++i)
+              {
+                ankerl::nanobench::doNotOptimizeAway(
+                  new(PointerFreeGC) obj::integer{ static_cast<i64>(i) });
+              }
+            });
+          });
+        bench.batch(thread_count * box_count)
+          .run(util::format("make_box {} threads", thread_count).c_str(), [&] {
+            on_threads(thread_count, [&](usize) {
+              for(usize i{}; i < box_count; ++i)
+              {
+                ankerl::nanobench::doNotOptimizeAway(
+                  make_box<obj::integer>(static_cast<i64>(i)));
+              }
+            });
+          });
+        bench.batch(thread_count * box_count)
+          .run(util::format("make_box mixed {} threads", thread_count).c_str(), [&] {
+            on_threads(thread_count, [&](usize) {
+              object_ref list{ jank_nil };
+              for(usize i{}; i < box_count; ++i)
+              {
+                list = make_box<obj::cons>(make_box<obj::real>(static_cast<f64>(i)), list);
+                if(i % 64 == 0)
+                {
+                  ankerl::nanobench::doNotOptimizeAway(make_box<obj::persistent_vector>());
+                  list = jank_nil;
+                }
+              }
+            });
+          });
+      }
+    }
+  }
+}
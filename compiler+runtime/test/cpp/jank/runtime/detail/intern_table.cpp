@@ -0,0 +1,203 @@
+#include <array>
+#include <thread>
+
+#include <nanobench.h>
+
+#include <jank/runtime/detail/intern_table.hpp>
+#include <jank/runtime/obj/keyword.hpp>
+#include <jank/runtime/obj/symbol.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/equal.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/runtime/rtti.hpp>
+#include <jank/util/fmt.hpp>
+#include <jank/util/scope_exit.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::runtime::detail
+{
+  /* Runs the fn on each of the given number of threads, all at once. */
+  template <typename F>
+  static void on_threads(usize const thread_count, F const &f)
+  {
+    GC_allow_register_threads();
+    native_vector<std::thread> threads;
+    for(usize i{}; i < thread_count; ++i)
+    {
+      threads.emplace_back([&f, i]() {
+        GC_stack_base stack_base{};
+        GC_get_stack_base(&stack_base);
+        GC_register_my_thread(&stack_base);
+        f(i);
+        GC_unregister_my_thread();
+      });
+    }
+    for(auto &t : threads)
+    {
+      t.join();
+    }
+  }
+
+  TEST_SUITE("intern_table")
+  {
+    TEST_CASE("keywords")
+    {
+      keyword_table table;
+      auto const a(table.intern("", "a"));
+      CHECK(a->sym->ns.empty());
+      CHECK(a->sym->name == "a");
+      CHECK(table.intern("", "a").data == a.data);
+
+      auto const qualified(table.intern("foo.bar", "a"));
+      CHECK(qualified.data != a.data);
+      CHECK(qualified->sym->ns == "foo.bar");
+      CHECK(table.intern("foo.bar", "a").data == qualified.data);
+      CHECK(table.size() == 2);
+    }
+
+    TEST_CASE("symbols")
+    {
+      symbol_table table;
+      auto const a(table.intern("foo", "a"));
+      CHECK(a->canonical == a.data);
+      CHECK(a->hash != 0);
+      CHECK(table.intern("foo", "a").data == a.data);
+
+      /* Copies, like the ones which carry meta, still compare by identity. */
+      auto const with_meta(a->with_meta(obj::persistent_hash_map::empty()));
+      CHECK(with_meta.data != a.data);
+      CHECK(with_meta->canonical == a.data);
+      CHECK(equal(with_meta, a));
+      CHECK(!equal(with_meta, table.intern("foo", "b")));
+
+      /* Symbols which didn't come from the table compare by their strings. */
+      CHECK(equal(make_box<obj::symbol>("foo", "a"), a));
+      CHECK(!equal(make_box<obj::symbol>("bar", "a"), a));
+
+      auto const renamed(make_box<obj::symbol>(*a));
+      renamed->set_name("b");
+      CHECK(renamed->canonical == nullptr);
+      CHECK(!equal(renamed, a));
+    }
+
+    TEST_CASE("growth")
+    {
+      keyword_table table;
+      native_vector<obj::keyword_ref> interned;
+      for(usize i{}; i < 5000; ++i)
+      {
+        interned.emplace_back(table.intern("growth", util::format("k{}", i)));
+      }
+      CHECK(table.size() == 5000);
+      for(usize i{}; i < 5000; ++i)
+      {
+        CHECK(table.intern("growth", util::format("k{}", i)).data == interned[i].data);
+      }
+    }
+
+    TEST_CASE("context splits like symbols")
+    {
+      auto const qualified(__rt_ctx->intern_keyword("foo/bar").expect_ok());
+      CHECK(__rt_ctx->intern_keyword("foo", "bar", true).expect_ok().data == qualified.data);
+      CHECK(qualified->sym->ns == "foo");
+      CHECK(qualified->sym->name == "bar");
+      CHECK(__rt_ctx->intern_keyword("/").expect_ok()->sym->name == "/");
+      CHECK(__rt_ctx->intern_keyword("", "baz/qux", true).expect_ok()->sym->ns == "baz");
+    }
+
+    TEST_CASE("read symbols are canonical")
+    {
+      auto const intern(__rt_ctx->intern_symbols);
+      util::scope_exit const restore{ [=]() { __rt_ctx->intern_symbols = intern; } };
+      __rt_ctx->intern_symbols = true;
+
+      auto const sym(expect_object<obj::symbol>(__rt_ctx->read_string("intern-table-sym")));
+      CHECK(sym->canonical == __rt_ctx->intern_symbol("intern-table-sym").data);
+      CHECK(sym->meta.is_some());
+    }
+
+    TEST_CASE("contended interning")
+    {
+      static constexpr usize thread_count{ 8 };
+      static constexpr usize keyword_count{ 2000 };
+      keyword_table table;
+      native_vector<native_vector<obj::keyword *>> seen(thread_count);
+
+      /* Every thread races to intern the same keywords, so some of them miss and insert
+       * while others are looking up. They must all agree on the keyword objects. */
+      on_threads(thread_count, [&](usize const thread) {
+        for(usize i{}; i < keyword_count; ++i)
+        {
+          seen[thread].push_back(table.intern("contended", util::format("k{}", i)).data);
+        }
+      });
+
+      CHECK(table.size() == keyword_count);
+      for(usize thread{ 1 }; thread < thread_count; ++thread)
+      {
+        CHECK(seen[thread] == seen[0]);
+      }
+    }
+
+    TEST_CASE("var lookup benchmark")
+    {
+      static constexpr usize var_count{ 2000 };
+      auto const n(__rt_ctx->intern_ns(make_box<obj::symbol>("intern-table.bench")));
+      native_vector<obj::symbol_ref> canonical, fresh;
+      for(usize i{}; i < var_count; ++i)
+      {
+        auto const name(util::format("v{}", i));
+        n->intern_var(__rt_ctx->intern_symbol("", name));
+        canonical.emplace_back(make_box<obj::symbol>(*__rt_ctx->intern_symbol("", name)));
+        fresh.emplace_back(make_box<obj::symbol>("", name));
+      }
+
+      ankerl::nanobench::Bench bench;
+      bench.title("var lookup").unit("var").batch(var_count).minEpochIterations(10);
+      bench.run("interned symbols", [&] {
+        for(auto const &sym : canonical)
+        {
+          ankerl::nanobench::doNotOptimizeAway(n->find_var(sym));
+        }
+      });
+      bench.run("fresh symbols", [&] {
+        for(auto const &sym : fresh)
+        {
+          /* Fresh symbols, like the reader made, have no cached hash. */
+          sym->hash = 0;
+          ankerl::nanobench::doNotOptimizeAway(n->find_var(sym));
+        }
+      });
+    }
+
+    TEST_CASE("contended interning benchmark")
+    {
+      static constexpr usize keyword_count{ 256 };
+      native_vector<jtl::immutable_string> names;
+      for(usize i{}; i < keyword_count; ++i)
+      {
+        names.emplace_back(util::format("k{}", i));
+      }
+
+      ankerl::nanobench::Bench bench;
+      bench.title("contended keyword interning").unit("keyword").minEpochIterations(10);
+      static constexpr std::array<usize, 4> thread_counts{ 1, 2, 4, 8 };
+      for(auto const thread_count : thread_counts)
+      {
+        bench.batch(thread_count * keyword_count)
+          .run(util::format("{} threads", thread_count).c_str(), [&] {
+            on_threads(thread_count, [&](usize) {
+              for(auto const &name : names)
+              {
+                ankerl::nanobench::doNotOptimizeAway(
+                  __rt_ctx->intern_keyword("bench", name, true).expect_ok());
+              }
+            });
+          });
+      }
+    }
+  }
+}
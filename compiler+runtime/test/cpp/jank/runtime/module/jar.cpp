@@ -0,0 +1,287 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include <unistd.h>
+
+#include <jank/runtime/module/jar.hpp>
+#include <jank/util/fmt.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::runtime::module
+{
+  /* Builds a zip with stored entries, byte by byte, so each test controls exactly what the
+   * jar reader sees. CRCs are left as zero, since only libzippp checks them and it's only
+   * used for compressed entries. */
+  struct zip_builder
+  {
+    static void put(std::string &out, u64 const value, usize const size)
+    {
+      for(usize i{}; i < size; ++i)
+      {
+        out.push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+      }
+    }
+
+    /* With zip64, the central header's sizes and offset are saturated and the real values
+     * are in its zip64 extra field instead. */
+    void add(std::string const &name, std::string const &data, bool const zip64 = false)
+    {
+      auto const offset(local.size());
+      put(local, 0x04034b50, 4);
+      put(local, 20, 2);
+      put(local, 0, 2);
+      put(local, 0, 2);
+      put(local, 0, 4);
+      put(local, 0, 4);
+      put(local, data.size(), 4);
+      put(local, data.size(), 4);
+      put(local, name.size(), 2);
+      put(local, 0, 2);
+      local += name;
+      local += data;
+
+      std::string extra;
+      if(zip64)
+      {
+        put(extra, 0x0001, 2);
+        put(extra, 24, 2);
+        put(extra, data.size(), 8);
+        put(extra, data.size(), 8);
+        put(extra, offset, 8);
+      }
+
+      static constexpr u64 saturated{ 0xFFFFFFFF };
+      put(central, 0x02014b50, 4);
+      put(central, 20, 2);
+      put(central, 20, 2);
+      put(central, 0, 2);
+      put(central, 0, 2);
+      put(central, 0, 4);
+      put(central, 0, 4);
+      put(central, zip64 ? saturated : data.size(), 4);
+      put(central, zip64 ? saturated : data.size(), 4);
+      put(central, name.size(), 2);
+      put(central, extra.size(), 2);
+      put(central, 0, 2);
+      put(central, 0, 2);
+      put(central, 0, 2);
+      put(central, 0, 4);
+      put(central, zip64 ? saturated : offset, 4);
+      central += name;
+      central += extra;
+      ++count;
+    }
+
+    std::string finish() const
+    {
+      auto ret(local + central);
+      put(ret, 0x06054b50, 4);
+      put(ret, 0, 2);
+      put(ret, 0, 2);
+      put(ret, count, 2);
+      put(ret, count, 2);
+      put(ret, central.size(), 4);
+      put(ret, local.size(), 4);
+      put(ret, 0, 2);
+      return ret;
+    }
+
+    std::string local;
+    std::string central;
+    usize count{};
+  };
+
+  /* Jars stay open for the whole process, keyed by their path, so every jar written here
+   * gets a fresh path. */
+  struct jar_fixture
+  {
+    jar_fixture()
+      : dir{ std::filesystem::temp_directory_path()
+             / util::format(
+                 "jank-jar-{}-{}",
+                 getpid(),
+                 static_cast<i64>(std::chrono::steady_clock::now().time_since_epoch().count()))
+                 .c_str() }
+    {
+      std::filesystem::create_directories(dir);
+    }
+
+    ~jar_fixture()
+    {
+      std::error_code ec;
+      std::filesystem::remove_all(dir, ec);
+    }
+
+    jtl::immutable_string write(std::string const &name, std::string const &contents) const
+    {
+      auto const path(dir / name);
+      std::ofstream{ path, std::ios::binary } << contents;
+      return path.native();
+    }
+
+    static std::string sample()
+    {
+      zip_builder zip;
+      zip.add("dir/", "");
+      zip.add("dir/a.jank", "(ns dir.a)");
+      zip.add("b.cljc", "(ns b)");
+      return zip.finish();
+    }
+
+    std::filesystem::path dir;
+  };
+
+  TEST_SUITE("jar")
+  {
+    TEST_CASE_FIXTURE(jar_fixture, "stored entries")
+    {
+      auto const opened(jar::open(write("stored.jar", sample())));
+      REQUIRE(opened.is_ok());
+      auto const j(opened.expect_ok());
+      CHECK(j->contains("dir/a.jank"));
+      CHECK(j->contains("b.cljc"));
+      /* Directories aren't entries. */
+      CHECK(!j->contains("dir/"));
+      CHECK(j->read("missing.jank").is_err());
+
+      auto const first(j->read("dir/a.jank"));
+      REQUIRE(first.is_ok());
+      CHECK(first.expect_ok().view() == "(ns dir.a)");
+
+      /* Stored entries are views into the jar's mapping, so reading again copies nothing. */
+      auto const second(j->read("dir/a.jank"));
+      REQUIRE(second.is_ok());
+      CHECK(second.expect_ok().data() == first.expect_ok().data());
+      CHECK(jar::open(j->path).expect_ok() == j);
+    }
+
+    TEST_CASE_FIXTURE(jar_fixture, "zip64 extra field")
+    {
+      zip_builder zip;
+      zip.add("small.jank", "(ns small)");
+      auto const big_offset(zip.local.size());
+      zip.add("big.jank", "(ns big)", true);
+      auto const opened(jar::open(write("zip64.jar", zip.finish())));
+      REQUIRE(opened.is_ok());
+      auto const j(opened.expect_ok());
+
+      auto const &e(j->entries.at("big.jank"));
+      CHECK(e.size == 8);
+      CHECK(e.compressed_size == 8);
+      CHECK(e.header_offset == big_offset);
+      auto const read(j->read("big.jank"));
+      REQUIRE(read.is_ok());
+      CHECK(read.expect_ok().view() == "(ns big)");
+    }
+
+    TEST_CASE_FIXTURE(jar_fixture, "corrupt archives")
+    {
+      auto const contents(sample());
+
+      SUBCASE("not a zip")
+      {
+        CHECK(jar::open(write("text.jar", "this is not a zip")).is_err());
+      }
+
+      SUBCASE("empty")
+      {
+        CHECK(jar::open(write("empty.jar", "")).is_err());
+      }
+
+      SUBCASE("truncated")
+      {
+        /* Without its end, there's no central directory to be found. */
+        CHECK(jar::open(write("truncated.jar", contents.substr(0, contents.size() / 2))).is_err());
+      }
+
+      SUBCASE("central directory past the end")
+      {
+        auto broken(contents);
+        /* The directory offset is the last field before the comment size, so this is its
+         * high byte. */
+        broken[broken.size() - 3] = static_cast<char>(0x7F);
+        CHECK(jar::open(write("offset.jar", broken)).is_err());
+      }
+
+      SUBCASE("entry past the end")
+      {
+        zip_builder zip;
+        zip.add("a.jank", "(ns a)");
+        auto broken(zip.finish());
+        /* The local header's size fields aren't used, but the central header's are. Its
+         * size field is at offset 24. */
+        broken[zip.local.size() + 24] = static_cast<char>(0x7F);
+        auto const opened(jar::open(write("entry.jar", broken)));
+        REQUIRE(opened.is_ok());
+        CHECK(opened.expect_ok()->read("a.jank").is_err());
+      }
+    }
+
+    TEST_CASE_FIXTURE(jar_fixture, "index")
+    {
+      auto const index_dir((dir / "index").native());
+      auto const contents(sample());
+      auto const original(write("original.jar", contents));
+      REQUIRE(jar::open(original, index_dir).is_ok());
+      auto const original_index(jar::index_file(original, index_dir));
+      REQUIRE(std::filesystem::exists(original_index.c_str()));
+
+      /* Copies the jar, with the same mtime, and gives the copy the original's index, after
+       * changing it. The copy only sees the change if it used the index. */
+      auto const copy_with_index([&](std::string const &name, auto const &change) {
+        auto const copy(write(name, contents));
+        std::filesystem::last_write_time(copy.c_str(),
+                                         std::filesystem::last_write_time(original.c_str()));
+        std::ifstream in{ original_index.c_str() };
+        std::string index{ std::istreambuf_iterator<char>{ in }, {} };
+        change(index);
+        std::ofstream{ jar::index_file(copy, index_dir).c_str() } << index;
+        return copy;
+      });
+      auto const rename_entry([](std::string &index) {
+        index.replace(index.find("b.cljc"), 6, "c.cljc");
+      });
+
+      SUBCASE("round trip")
+      {
+        auto const opened(jar::open(copy_with_index("indexed.jar", rename_entry), index_dir));
+        REQUIRE(opened.is_ok());
+        CHECK(opened.expect_ok()->contains("c.cljc"));
+        CHECK(!opened.expect_ok()->contains("b.cljc"));
+        auto const read(opened.expect_ok()->read("dir/a.jank"));
+        REQUIRE(read.is_ok());
+        CHECK(read.expect_ok().view() == "(ns dir.a)");
+      }
+
+      SUBCASE("stale after a change")
+      {
+        auto const copy(copy_with_index("stale.jar", rename_entry));
+        std::filesystem::last_write_time(copy.c_str(),
+                                         std::filesystem::last_write_time(copy.c_str())
+                                           + std::chrono::seconds{ 10 });
+        auto const opened(jar::open(copy, index_dir));
+        REQUIRE(opened.is_ok());
+        CHECK(opened.expect_ok()->contains("b.cljc"));
+        CHECK(!opened.expect_ok()->contains("c.cljc"));
+      }
+
+      SUBCASE("corrupt")
+      {
+        /* The header is still valid, but the entries after it aren't. */
+        auto const copy(copy_with_index("corrupt.jar", [](std::string &index) {
+          index.resize(index.find('\n') + 1);
+          index += "12 garbage\n";
+        }));
+        auto const opened(jar::open(copy, index_dir));
+        REQUIRE(opened.is_ok());
+        CHECK(opened.expect_ok()->contains("b.cljc"));
+        CHECK(opened.expect_ok()->contains("dir/a.jank"));
+      }
+    }
+  }
+}
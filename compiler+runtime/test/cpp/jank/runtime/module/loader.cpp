@@ -0,0 +1,190 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include <unistd.h>
+
+#include <jank/runtime/module/loader.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/util/fmt.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::runtime::module
+{
+  /* A directory on the module path, with a module at its root and one in a subdirectory.
+   * Its index goes in the binary cache dir, like any other directory's. */
+  struct directory_fixture
+  {
+    directory_fixture()
+    {
+      auto const tmp(
+        std::filesystem::temp_directory_path()
+        / util::format(
+            "jank-module-index-{}-{}",
+            getpid(),
+            static_cast<i64>(std::chrono::steady_clock::now().time_since_epoch().count()))
+            .c_str());
+      std::filesystem::create_directories(tmp / "sub");
+      dir = std::filesystem::canonical(tmp);
+      index_path = loader::directory_index_file(dir, __rt_ctx->binary_cache_dir).c_str();
+      write("index-test-a.jank");
+      write("sub/index-test-b.jank");
+    }
+
+    ~directory_fixture()
+    {
+      std::error_code ec;
+      std::filesystem::remove_all(dir, ec);
+      std::filesystem::remove(index_path, ec);
+    }
+
+    void write(std::string const &name) const
+    {
+      std::ofstream{ dir / name } << "(ns index-test)";
+    }
+
+    /* Adding or removing a file changes the directory's mtime, but a coarse timestamp may
+     * not show that within a test, so we move it along ourselves. */
+    void bump(std::string const &name) const
+    {
+      auto const p(dir / name);
+      std::filesystem::last_write_time(p,
+                                       std::filesystem::last_write_time(p)
+                                         + std::chrono::seconds{ 10 });
+    }
+
+    loader load() const
+    {
+      return loader{ *__rt_ctx, dir.c_str() };
+    }
+
+    std::string read_index() const
+    {
+      std::ifstream in{ index_path };
+      return { std::istreambuf_iterator<char>{ in }, {} };
+    }
+
+    /* Adds a file to the root's listing in the index, which doesn't exist on disk. A loader
+     * only has its module if it reused the root's listing, rather than listing it again. */
+    void add_fake_to_index() const
+    {
+      auto index(read_index());
+      /* The root's path is empty, so its line ends with the space after its mtime. */
+      auto const root(index.find(" \n"));
+      REQUIRE(root != std::string::npos);
+      index.insert(root + 2, "f index-test-fake.jank\n");
+      std::ofstream{ index_path } << index;
+    }
+
+    std::filesystem::path dir;
+    std::filesystem::path index_path;
+  };
+
+  TEST_SUITE("module loader")
+  {
+    TEST_CASE_FIXTURE(directory_fixture, "directory index")
+    {
+      auto const first(load());
+      CHECK(first.entries.contains("index-test-a"));
+      CHECK(first.entries.contains("sub.index-test-b"));
+      REQUIRE(read_index().starts_with("jank-module-index 1\n"));
+      add_fake_to_index();
+
+      SUBCASE("reused while unchanged")
+      {
+        auto const l(load());
+        CHECK(l.entries.contains("index-test-fake"));
+        CHECK(l.entries.contains("index-test-a"));
+        CHECK(l.entries.contains("sub.index-test-b"));
+      }
+
+      SUBCASE("invalidated by an mtime change")
+      {
+        bump("");
+        auto const l(load());
+        CHECK(!l.entries.contains("index-test-fake"));
+        CHECK(l.entries.contains("index-test-a"));
+        CHECK(read_index().find("index-test-fake") == std::string::npos);
+      }
+
+      SUBCASE("new file")
+      {
+        write("index-test-c.jank");
+        bump("");
+        auto const l(load());
+        CHECK(l.entries.contains("index-test-c"));
+        CHECK(!l.entries.contains("index-test-fake"));
+        CHECK(read_index().find("f index-test-c.jank\n") != std::string::npos);
+      }
+
+      SUBCASE("new file in a subdirectory")
+      {
+        /* Only the subdirectory is listed again. */
+        write("sub/index-test-c.jank");
+        bump("sub");
+        auto const l(load());
+        CHECK(l.entries.contains("sub.index-test-c"));
+        CHECK(l.entries.contains("sub.index-test-b"));
+        CHECK(l.entries.contains("index-test-fake"));
+      }
+
+      SUBCASE("removed file")
+      {
+        std::filesystem::remove(dir / "sub/index-test-b.jank");
+        bump("sub");
+        auto const l(load());
+        CHECK(!l.entries.contains("sub.index-test-b"));
+        CHECK(l.entries.contains("index-test-a"));
+        CHECK(read_index().find("index-test-b") == std::string::npos);
+      }
+
+      SUBCASE("new subdirectory")
+      {
+        std::filesystem::create_directories(dir / "sub/nested");
+        write("sub/nested/index-test-d.jank");
+        bump("sub");
+        auto const l(load());
+        CHECK(l.entries.contains("sub.nested.index-test-d"));
+      }
+    }
+
+    TEST_CASE_FIXTURE(directory_fixture, "corrupt directory index")
+    {
+      std::filesystem::create_directories(index_path.parent_path());
+
+      SUBCASE("bad line")
+      {
+        std::ofstream{ index_path } << "jank-module-index 1\nx garbage\n";
+      }
+
+      SUBCASE("file before any directory")
+      {
+        std::ofstream{ index_path } << "jank-module-index 1\nf index-test-fake.jank\n";
+      }
+
+      SUBCASE("truncated")
+      {
+        std::ofstream{ index_path } << "jank-module-index 1\nd 12";
+      }
+
+      SUBCASE("other version")
+      {
+        std::ofstream{ index_path } << "jank-module-index 0\nd 12 \nf index-test-fake.jank\n";
+      }
+
+      /* The whole index is thrown out, so everything is listed again and a good index
+       * replaces the bad one. */
+      auto const l(load());
+      CHECK(l.entries.contains("index-test-a"));
+      CHECK(l.entries.contains("sub.index-test-b"));
+      CHECK(!l.entries.contains("index-test-fake"));
+      auto const index(read_index());
+      CHECK(index.starts_with("jank-module-index 1\n"));
+      CHECK(index.find("f index-test-a.jank\n") != std::string::npos);
+    }
+  }
+}
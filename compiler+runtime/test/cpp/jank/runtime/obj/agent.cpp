@@ -0,0 +1,194 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <jank/runtime/obj/agent.hpp>
+#include <jank/runtime/obj/native_function_wrapper.hpp>
+#include <jank/runtime/obj/native_pointer_wrapper.hpp>
+#include <jank/runtime/obj/persistent_vector.hpp>
+#include <jank/runtime/thread_pool.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/equal.hpp>
+#include <jank/runtime/rtti.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::runtime
+{
+  static object_ref throw_native_error(object_ref)
+  {
+    throw jtl::immutable_string{ "native error" };
+  }
+
+  static std::atomic_bool own_pool_shut_down{};
+
+  template <typename Pool>
+  static void shut_down_own_pool(object_ref const o)
+  {
+    expect_object<obj::native_pointer_wrapper>(o)->as<Pool>()->shutdown();
+    own_pool_shut_down.store(true);
+  }
+
+  template <typename Pool>
+  static bool shuts_down_from_own_task(Pool * const pool)
+  {
+    own_pool_shut_down.store(false);
+    pool->submit(&shut_down_own_pool<Pool>, make_box<obj::native_pointer_wrapper>(pool));
+    auto const deadline(std::chrono::steady_clock::now() + std::chrono::seconds{ 10 });
+    while(!own_pool_shut_down.load() && std::chrono::steady_clock::now() < deadline)
+    {
+      std::this_thread::yield();
+    }
+    return own_pool_shut_down.load();
+  }
+
+  TEST_SUITE("agent")
+  {
+    TEST_CASE("actions run in send order")
+    {
+      auto const res(__rt_ctx->eval_string(
+        "(let* [a (clojure.core/agent [])] (clojure.core/dotimes [i 100] (clojure.core/send a "
+        "clojure.core/conj i)) (clojure.core/await a) @a)"));
+      CHECK(equal(res, __rt_ctx->eval_string("(clojure.core/vec (clojure.core/range 100))")));
+    }
+
+    TEST_CASE("send-off")
+    {
+      auto const res(__rt_ctx->eval_string(
+        "(let* [a (clojure.core/agent 0)] (clojure.core/send-off a (fn* [s] "
+        "(clojure.core/sleep 10) (clojure.core/+ s 1))) (clojure.core/send a clojure.core/+ 2 3) "
+        "(clojure.core/await a) @a)"));
+      CHECK(equal(res, make_box(6)));
+    }
+
+    TEST_CASE("await-for")
+    {
+      CHECK(equal(__rt_ctx->eval_string(
+                    "(let* [a (clojure.core/agent 0)] (clojure.core/send-off a (fn* [s] "
+                    "(clojure.core/sleep 500) s)) (clojure.core/await-for 10 a))"),
+                  jank_false));
+      CHECK(equal(__rt_ctx->eval_string("(clojure.core/await-for 5000 (clojure.core/agent 0))"),
+                  jank_true));
+    }
+
+    TEST_CASE("*agent* is bound within actions")
+    {
+      auto const res(__rt_ctx->eval_string(
+        "(let* [a (clojure.core/agent nil)] (clojure.core/send a (fn* [_] "
+        "clojure.core/*agent*)) (clojure.core/await a) (clojure.core/identical? a @a))"));
+      CHECK(equal(res, jank_true));
+    }
+
+    TEST_CASE("nested sends are held until the action is done")
+    {
+      auto const res(__rt_ctx->eval_string(
+        "(let* [a (clojure.core/agent 0) b (clojure.core/agent nil)] (clojure.core/send a (fn* "
+        "[s] (clojure.core/send b (fn* [_] @a)) (clojure.core/+ s 1))) (clojure.core/await a) "
+        "(clojure.core/await b) @b)"));
+      CHECK(equal(res, make_box(1)));
+    }
+
+    TEST_CASE("fail mode")
+    {
+      __rt_ctx->eval_string(
+        "(def failing-agent (clojure.core/agent 1 :validator clojure.core/pos?))");
+      auto const a(__rt_ctx->eval_string("failing-agent"));
+      CHECK(expect_object<obj::agent>(a)->get_error_mode() == obj::agent_error_mode::fail);
+
+      /* The failing action sleeps, so the second send is queued before the agent fails. */
+      __rt_ctx->eval_string("(do (clojure.core/send failing-agent (fn* [s] (clojure.core/sleep "
+                            "100) (clojure.core/- s 5))) (clojure.core/send failing-agent "
+                            "clojure.core/+ 5))");
+      while(expect_object<obj::agent>(a)->get_error().is_nil())
+      {
+        std::this_thread::yield();
+      }
+
+      /* The failed action doesn't change the state and the held one doesn't run. */
+      CHECK(equal(deref(a), make_box(1)));
+      CHECK_THROWS(__rt_ctx->eval_string("(clojure.core/send failing-agent clojure.core/inc)"));
+      CHECK_THROWS(__rt_ctx->eval_string("(clojure.core/restart-agent failing-agent -1)"));
+
+      __rt_ctx->eval_string("(clojure.core/restart-agent failing-agent 10)");
+      __rt_ctx->eval_string("(clojure.core/await failing-agent)");
+      CHECK(expect_object<obj::agent>(a)->get_error().is_nil());
+      CHECK(equal(deref(a), make_box(15)));
+    }
+
+    TEST_CASE("continue mode with an error handler")
+    {
+      auto const res(__rt_ctx->eval_string(
+        "(let* [errors (clojure.core/atom 0) a (clojure.core/agent 0 :error-handler (fn* [a e] "
+        "(clojure.core/swap! errors clojure.core/inc)))] (clojure.core/send a (fn* [s] (throw "
+        ":boom))) (clojure.core/send a clojure.core/inc) (clojure.core/await a) [@a @errors "
+        "(clojure.core/agent-error a) (clojure.core/error-mode a)])"));
+      CHECK(equal(res, __rt_ctx->read_string("[1 1 nil :continue]")));
+    }
+
+    TEST_CASE("watches")
+    {
+      auto const res(__rt_ctx->eval_string(
+        "(let* [seen (clojure.core/atom []) a (clojure.core/agent 0)] (clojure.core/add-watch a "
+        ":w (fn* [k r old new] (clojure.core/swap! seen clojure.core/conj [k old new]))) "
+        "(clojure.core/send a clojure.core/inc) (clojure.core/await a) (clojure.core/remove-watch "
+        "a :w) (clojure.core/send a clojure.core/inc) (clojure.core/await a) @seen)"));
+      CHECK(equal(res, __rt_ctx->read_string("[[:w 0 1]]")));
+    }
+  
+    TEST_CASE("errors which aren't objects")
+    {
+      auto const a(make_box<obj::agent>(make_box(1)));
+      a->dispatch(make_box<obj::native_function_wrapper>(
+                    obj::detail::function_type{ &throw_native_error }),
+                  jank_nil,
+                  obj::agent_executor::send);
+      while(a->get_error().is_nil())
+      {
+        std::this_thread::yield();
+      }
+      CHECK(equal(a->get_error(), make_box("native error")));
+
+      /* The agent is failed, rather than wedged, so it can be restarted. */
+      a->restart(make_box(2), false);
+      a->dispatch(__rt_ctx->eval_string("clojure.core/inc"), jank_nil, obj::agent_executor::send);
+      CHECK(obj::agent::await_for(5000, make_box<obj::persistent_vector>(std::in_place, a)));
+      CHECK(equal(deref(a), make_box(3)));
+    }
+
+    TEST_CASE("pools can be shut down from their own tasks")
+    {
+      CHECK(shuts_down_from_own_task(new(GC) thread_pool{ 2 }));
+      CHECK(shuts_down_from_own_task(new(GC) cached_thread_pool{}));
+    }
+  }
+
+  TEST_SUITE("atom")
+  {
+    TEST_CASE("validators")
+    {
+      auto const res(__rt_ctx->eval_string(
+        "(let* [a (clojure.core/atom 1 :validator clojure.core/pos?)] (clojure.core/swap! a "
+        "clojure.core/inc) (clojure.core/reset! a 5) [@a (clojure.core/some? "
+        "(clojure.core/get-validator a))])"));
+      CHECK(equal(res, __rt_ctx->read_string("[5 true]")));
+      CHECK_THROWS(__rt_ctx->eval_string(
+        "(clojure.core/swap! (clojure.core/atom 1 :validator clojure.core/pos?) clojure.core/-)"));
+      CHECK_THROWS(
+        __rt_ctx->eval_string("(clojure.core/set-validator! (clojure.core/atom -1) "
+                              "clojure.core/pos?)"));
+    }
+
+    TEST_CASE("watches")
+    {
+      auto const res(__rt_ctx->eval_string(
+        "(let* [seen (clojure.core/atom []) a (clojure.core/atom 0)] (clojure.core/add-watch a "
+        ":w (fn* [k r old new] (clojure.core/swap! seen clojure.core/conj [k old new]))) "
+        "(clojure.core/swap! a clojure.core/inc) (clojure.core/reset! a 5) "
+        "(clojure.core/compare-and-set! a @a 6) (clojure.core/compare-and-set! a :other 7) "
+        "(clojure.core/remove-watch a :w) (clojure.core/swap! a clojure.core/inc) @seen)"));
+      CHECK(equal(res, __rt_ctx->read_string("[[:w 0 1] [:w 1 5] [:w 5 6]]")));
+    }
+  }
+}
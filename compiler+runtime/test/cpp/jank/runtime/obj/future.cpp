@@ -0,0 +1,244 @@
+#include <thread>
+
+#include <nanobench.h>
+
+#include <jank/runtime/obj/future.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/thread_pool.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/equal.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/runtime/obj/native_pointer_wrapper.hpp>
+#include <jank/runtime/core.hpp>
+#include <jank/runtime/ns.hpp>
+#include <jank/runtime/var.hpp>
+#include <jank/runtime/behavior/callable.hpp>
+#include <jank/runtime/rtti.hpp>
+#include <jank/util/fmt.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::runtime
+{
+  TEST_SUITE("future")
+  {
+    TEST_CASE("deref")
+    {
+      auto const f(__rt_ctx->eval_string("(clojure.core/future (clojure.core/+ 1 2))"));
+      CHECK(f->type == object_type::future);
+      CHECK(equal(__rt_ctx->eval_string("@(clojure.core/future (clojure.core/+ 1 2))"),
+                  make_box(3)));
+      CHECK(equal(deref(f), make_box(3)));
+      CHECK(expect_object<obj::future>(f)->is_realized());
+    }
+
+    TEST_CASE("timed deref")
+    {
+      CHECK(equal(__rt_ctx->eval_string("(clojure.core/deref (clojure.core/future "
+                                        "(clojure.core/sleep 500) :done) 10 :timeout)"),
+                  __rt_ctx->intern_keyword("timeout").expect_ok()));
+      CHECK(equal(__rt_ctx->eval_string("(clojure.core/deref (clojure.core/future :done) 5000 "
+                                        ":timeout)"),
+                  __rt_ctx->intern_keyword("done").expect_ok()));
+    }
+
+    TEST_CASE("binding conveyance")
+    {
+      __rt_ctx->eval_string("(def ^:dynamic *future-binding* :root)");
+      CHECK(equal(__rt_ctx->eval_string("(clojure.core/binding [*future-binding* :bound] "
+                                        "@(clojure.core/future *future-binding*))"),
+                  __rt_ctx->intern_keyword("bound").expect_ok()));
+    }
+
+    TEST_CASE("bound-fn")
+    {
+      __rt_ctx->eval_string("(def ^:dynamic *bound-fn-binding* :root)");
+      auto const f(__rt_ctx->eval_string("(clojure.core/binding [*bound-fn-binding* :bound] "
+                                         "(clojure.core/bound-fn [x] [x *bound-fn-binding*]))"));
+      CHECK(equal(__rt_ctx->eval_string("*bound-fn-binding*"),
+                  __rt_ctx->intern_keyword("root").expect_ok()));
+      CHECK(equal(dynamic_call(f, make_box(1)), __rt_ctx->read_string("[1 :bound]")));
+      CHECK(equal(__rt_ctx->eval_string("*bound-fn-binding*"),
+                  __rt_ctx->intern_keyword("root").expect_ok()));
+
+      SUBCASE("sits on top of the caller's bindings")
+      {
+        auto const ns(__rt_ctx->intern_ns("jank.test.future"));
+        auto const v(ns->intern_var("bound-fn-other")->set_dynamic(true));
+        v->bind_root(make_box(1));
+        auto const g(
+          __rt_ctx->eval_string("(clojure.core/bound-fn [] (clojure.core/deref (var jank.test.future/bound-fn-other)))"));
+        __rt_ctx
+          ->push_thread_bindings(
+            obj::persistent_hash_map::create_unique(std::make_pair(v, make_box(2))))
+          .expect_ok();
+        CHECK(equal(dynamic_call(g), make_box(2)));
+        CHECK(equal(v->deref(), make_box(2)));
+        __rt_ctx->pop_thread_bindings().expect_ok();
+      }
+    }
+
+    TEST_CASE("captured bindings on another thread")
+    {
+      auto const ns(__rt_ctx->intern_ns("jank.test.future"));
+      auto const v(ns->intern_var("captured-binding")->set_dynamic(true));
+      v->bind_root(make_box(0));
+      __rt_ctx
+        ->push_thread_bindings(
+          obj::persistent_hash_map::create_unique(std::make_pair(v, make_box(1))))
+        .expect_ok();
+      auto const captured(__rt_ctx->capture_thread_bindings());
+      __rt_ctx->pop_thread_bindings().expect_ok();
+
+      object_ref seen;
+      bool set_failed{};
+      GC_allow_register_threads();
+      std::thread{ [&] {
+        GC_stack_base stack_base{};
+        GC_get_stack_base(&stack_base);
+        GC_register_my_thread(&stack_base);
+        {
+          context::binding_scope const scope{ *__rt_ctx, captured };
+          seen = v->deref();
+          /* Only the thread which made a binding can set! it. */
+          set_failed = v->set(make_box(2)).is_err();
+        }
+        CHECK(v->get_thread_binding().is_nil());
+        GC_unregister_my_thread();
+      } }.join();
+
+      CHECK(equal(seen, make_box(1)));
+      CHECK(set_failed);
+      CHECK(v->get_thread_binding().is_nil());
+
+      SUBCASE("replaces the installing thread's bindings")
+      {
+        auto const other(ns->intern_var("captured-other")->set_dynamic(true));
+        other->bind_root(make_box(0));
+        __rt_ctx
+          ->push_thread_bindings(obj::persistent_hash_map::create_unique(
+            std::make_pair(v, make_box(5)),
+            std::make_pair(other, make_box(6))))
+          .expect_ok();
+        {
+          context::binding_scope const scope{ *__rt_ctx, captured };
+          CHECK(equal(v->deref(), make_box(1)));
+          CHECK(equal(other->deref(), make_box(0)));
+          CHECK(equal(__rt_ctx->get_thread_bindings(), captured->bindings()));
+        }
+        CHECK(equal(v->deref(), make_box(5)));
+        CHECK(equal(other->deref(), make_box(6)));
+        __rt_ctx->pop_thread_bindings().expect_ok();
+      }
+
+      SUBCASE("as objects")
+      {
+        __rt_ctx
+          ->push_thread_bindings(
+            obj::persistent_hash_map::create_unique(std::make_pair(v, make_box(3))))
+          .expect_ok();
+        auto const frame(runtime::capture_thread_bindings());
+        __rt_ctx->pop_thread_bindings().expect_ok();
+        CHECK(frame->type == object_type::thread_binding_frame);
+        CHECK(runtime::capture_thread_bindings().is_nil());
+
+        auto const deref_fn(__rt_ctx->eval_string("(fn* [] jank.test.future/captured-binding)"));
+        CHECK(equal(call_with_thread_bindings(frame, deref_fn, jank_nil), make_box(3)));
+        CHECK(equal(call_with_thread_bindings(jank_nil, deref_fn, jank_nil), make_box(0)));
+        /* Only captured frames are accepted, not just any pointer. */
+        CHECK_THROWS(
+          call_with_thread_bindings(make_box<obj::native_pointer_wrapper>(&v), deref_fn, jank_nil));
+      }
+    }
+
+    TEST_CASE("binding conveyance benchmark")
+    {
+      ankerl::nanobench::Bench bench;
+      bench.title("binding conveyance").unit("task").minEpochIterations(1000);
+      auto const noop(__rt_ctx->eval_string("(fn* [] nil)"));
+      auto const ns(__rt_ctx->intern_ns("jank.test.future"));
+      for(usize const var_count : { 0, 8, 64 })
+      {
+        for(usize i{}; i < var_count; ++i)
+        {
+          auto const v(ns->intern_var(util::format("conveyed-{}", i))->set_dynamic(true));
+          v->bind_root(make_box(0));
+          __rt_ctx
+            ->push_thread_bindings(
+              obj::persistent_hash_map::create_unique(std::make_pair(v, make_box(static_cast<i64>(i)))))
+            .expect_ok();
+        }
+
+        bench.run(util::format("capture and install {} vars", var_count).c_str(), [&] {
+          auto const captured(__rt_ctx->capture_thread_bindings());
+          __rt_ctx->push_thread_bindings(captured).expect_ok();
+          __rt_ctx->pop_thread_bindings().expect_ok();
+        });
+        bench.run(util::format("copy and push {} vars", var_count).c_str(), [&] {
+          __rt_ctx->push_thread_bindings(__rt_ctx->get_thread_bindings()).expect_ok();
+          __rt_ctx->pop_thread_bindings().expect_ok();
+        });
+        bench.run(util::format("future {} vars", var_count).c_str(), [&] {
+          ankerl::nanobench::doNotOptimizeAway(deref(obj::future::create(noop)));
+        });
+
+        for(usize i{}; i < var_count; ++i)
+        {
+          __rt_ctx->pop_thread_bindings().expect_ok();
+        }
+      }
+    }
+
+    TEST_CASE("errors are rethrown on deref")
+    {
+      auto const f(__rt_ctx->eval_string("(clojure.core/future (throw :boom))"));
+      CHECK_THROWS(deref(f));
+      CHECK(expect_object<obj::future>(f)->is_realized());
+    }
+
+    TEST_CASE("nested futures don't deadlock the pool")
+    {
+      /* More outer futures than workers, each blocking on an inner future which is queued
+       * behind it. Derefing runs the inner future inline, if nobody has started it. */
+      auto const count(default_thread_pool().thread_count() * 4);
+      auto const res(__rt_ctx->eval_string(
+        util::format("(clojure.core/reduce clojure.core/+ (clojure.core/map clojure.core/deref "
+                     "(clojure.core/doall (clojure.core/map (fn* [i] (clojure.core/future "
+                     "@(clojure.core/future i))) (clojure.core/range {})))))",
+                     count)));
+      CHECK(equal(res, make_box(static_cast<i64>(count * (count - 1) / 2))));
+    }
+
+    TEST_CASE("pmap and pcalls")
+    {
+      CHECK(equal(__rt_ctx->eval_string(
+                    "(clojure.core/pmap clojure.core/inc (clojure.core/range 100))"),
+                  __rt_ctx->eval_string("(clojure.core/map clojure.core/inc "
+                                        "(clojure.core/range 100))")));
+      CHECK(equal(__rt_ctx->eval_string("(clojure.core/pmap clojure.core/+ [1 2 3] [10 20 30])"),
+                  __rt_ctx->read_string("(11 22 33)")));
+      CHECK(equal(
+        __rt_ctx->eval_string("(clojure.core/pcalls (fn* [] 1) (fn* [] 2) (fn* [] 3))"),
+        __rt_ctx->read_string("(1 2 3)")));
+    }
+
+    TEST_CASE("pmap benchmark")
+    {
+      auto const work(__rt_ctx->eval_string(
+        "(fn* [x] (loop* [i 0 acc x] (if (clojure.core/< i 100000) (recur (clojure.core/inc i) "
+        "(clojure.core/rem (clojure.core/+ (clojure.core/* acc 31) i) 1000003)) acc)))"));
+      auto const serial(__rt_ctx->eval_string(
+        "(fn* [f] (clojure.core/doall (clojure.core/map f (clojure.core/range 64))))"));
+      auto const parallel(__rt_ctx->eval_string(
+        "(fn* [f] (clojure.core/doall (clojure.core/pmap f (clojure.core/range 64))))"));
+      CHECK(equal(dynamic_call(serial, work), dynamic_call(parallel, work)));
+
+      ankerl::nanobench::Bench bench;
+      bench.title("map vs pmap").unit("64 records").minEpochIterations(2);
+      bench.run("map", [&] { ankerl::nanobench::doNotOptimizeAway(dynamic_call(serial, work)); });
+      bench.run("pmap",
+                [&] { ankerl::nanobench::doNotOptimizeAway(dynamic_call(parallel, work)); });
+    }
+  }
+}
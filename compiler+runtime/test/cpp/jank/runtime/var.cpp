@@ -0,0 +1,242 @@
+#include <atomic>
+#include <thread>
+
+#include <nanobench.h>
+
+#include <jank/runtime/var.hpp>
+#include <jank/runtime/ns.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core/make_box.hpp>
+#include <jank/runtime/core/equal.hpp>
+#include <jank/runtime/core/seq.hpp>
+#include <jank/runtime/obj/persistent_hash_map.hpp>
+#include <jank/runtime/rtti.hpp>
+#include <jank/util/fmt.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::runtime
+{
+  TEST_SUITE("var")
+  {
+    TEST_CASE("bind_root and deref")
+    {
+      auto const ns(__rt_ctx->intern_ns("jank.test.var"));
+      auto const v(ns->intern_var("bind-root"));
+      CHECK(!v->is_bound());
+
+      v->bind_root(make_box(5));
+      CHECK(v->is_bound());
+      CHECK(equal(v->deref(), make_box(5)));
+      CHECK(equal(v->get_root(), make_box(5)));
+
+      v->bind_root(make_box(6));
+      CHECK(equal(v->deref(), make_box(6)));
+    }
+
+    TEST_CASE("concurrent deref during bind_root")
+    {
+      auto const ns(__rt_ctx->intern_ns("jank.test.var"));
+      auto const v(ns->intern_var("concurrent-deref"));
+
+      /* All boxes are allocated up front, so the reader threads never allocate and don't
+       * need to be registered with the GC. */
+      object_ref const a{ make_box(1) }, b{ make_box(2) };
+      v->bind_root(a);
+
+      std::atomic_bool done{ false };
+      std::atomic_bool torn{ false };
+      native_vector<std::thread> readers;
+      for(usize i{}; i < 4; ++i)
+      {
+        readers.emplace_back([&]() {
+          while(!done.load())
+          {
+            auto const r(v->deref());
+            if(r != a && r != b)
+            {
+              torn.store(true);
+            }
+          }
+        });
+      }
+
+      for(usize i{}; i < 100'000; ++i)
+      {
+        v->bind_root(i % 2 == 0 ? b : a);
+      }
+      done.store(true);
+      for(auto &t : readers)
+      {
+        t.join();
+      }
+
+      CHECK(!torn.load());
+    }
+
+    TEST_CASE("deref throughput scaling")
+    {
+      auto const ns(__rt_ctx->intern_ns("jank.test.var"));
+      auto const v(ns->intern_var("deref-throughput"));
+      object_ref const expected{ make_box(42) };
+      v->bind_root(expected);
+
+      /* Doubling from one thread, always ending with one per hardware thread. */
+      static constexpr usize derefs_per_thread{ 1'000'000 };
+      usize const max_threads{ std::max(1u, std::thread::hardware_concurrency()) };
+      native_vector<usize> thread_counts;
+      for(usize thread_count{ 1 }; thread_count < max_threads; thread_count *= 2)
+      {
+        thread_counts.emplace_back(thread_count);
+      }
+      thread_counts.emplace_back(max_threads);
+
+      ankerl::nanobench::Bench bench;
+      bench.title("var deref throughput").unit("deref").minEpochIterations(2);
+      std::atomic_bool stale{ false };
+      for(auto const thread_count : thread_counts)
+      {
+        bench.batch(thread_count * derefs_per_thread)
+          .run(util::format("{} threads", thread_count).c_str(), [&] {
+            std::atomic_bool go{ false };
+            native_vector<std::thread> threads;
+            for(usize i{}; i < thread_count; ++i)
+            {
+              threads.emplace_back([&]() {
+                while(!go.load())
+                {
+                }
+                object *last{};
+                for(usize n{}; n < derefs_per_thread; ++n)
+                {
+                  last = v->deref().data;
+                  ankerl::nanobench::doNotOptimizeAway(last);
+                }
+                if(last != expected.data)
+                {
+                  stale.store(true);
+                }
+              });
+            }
+
+            go.store(true);
+            for(auto &t : threads)
+            {
+              t.join();
+            }
+          });
+      }
+
+      CHECK(!stale.load());
+    }
+
+    TEST_CASE("thread bindings")
+    {
+      auto const ns(__rt_ctx->intern_ns("jank.test.var"));
+      auto const a(ns->intern_var("binding-a")->set_dynamic(true));
+      auto const b(ns->intern_var("binding-b")->set_dynamic(true));
+      a->bind_root(make_box(1));
+      b->bind_root(make_box(2));
+
+      CHECK(a->get_thread_binding().is_nil());
+      __rt_ctx->push_thread_bindings(obj::persistent_hash_map::create_unique(
+                                       std::make_pair(a, make_box(10)),
+                                       std::make_pair(b, make_box(20))))
+        .expect_ok();
+      CHECK(a->get_binding_slot() != 0);
+      CHECK(a->get_binding_slot() != b->get_binding_slot());
+      CHECK(equal(a->deref(), make_box(10)));
+      CHECK(equal(b->deref(), make_box(20)));
+
+      SUBCASE("nested")
+      {
+        __rt_ctx
+          ->push_thread_bindings(
+            obj::persistent_hash_map::create_unique(std::make_pair(a, make_box(100))))
+          .expect_ok();
+        CHECK(equal(a->deref(), make_box(100)));
+        CHECK(equal(b->deref(), make_box(20)));
+        a->set(make_box(101)).expect_ok();
+        CHECK(equal(a->deref(), make_box(101)));
+        /* The map holds each var's binding box, rather than its value. */
+        auto const binding(get(__rt_ctx->get_thread_bindings(), a));
+        REQUIRE(binding->type == object_type::var_thread_binding);
+        CHECK(equal(expect_object<var_thread_binding>(binding)->value.load(), make_box(101)));
+        __rt_ctx->pop_thread_bindings().expect_ok();
+        CHECK(equal(a->deref(), make_box(10)));
+      }
+
+      SUBCASE("non-dynamic vars undo the frame")
+      {
+        auto const c(ns->intern_var("binding-c"));
+        auto const res(__rt_ctx->push_thread_bindings(obj::persistent_hash_map::create_unique(
+          std::make_pair(a, make_box(100)),
+          std::make_pair(c, make_box(300)))));
+        CHECK(res.is_err());
+        CHECK(equal(a->deref(), make_box(10)));
+      }
+
+      SUBCASE("other threads")
+      {
+        bool bound{ true };
+        GC_allow_register_threads();
+        std::thread{ [&] {
+          GC_stack_base stack_base{};
+          GC_get_stack_base(&stack_base);
+          GC_register_my_thread(&stack_base);
+          bound = a->get_thread_binding().is_some();
+          GC_unregister_my_thread();
+        } }.join();
+        CHECK(!bound);
+      }
+
+      __rt_ctx->pop_thread_bindings().expect_ok();
+      CHECK(a->get_thread_binding().is_nil());
+      CHECK(equal(a->deref(), make_box(1)));
+      CHECK(equal(b->deref(), make_box(2)));
+    }
+
+    TEST_CASE("dynamic deref benchmark")
+    {
+      auto const ns(__rt_ctx->intern_ns("jank.test.var"));
+      auto const v(ns->intern_var("dynamic-deref")->set_dynamic(true));
+      v->bind_root(make_box(1));
+
+      /* Other vars bound around it shouldn't matter. */
+      native_vector<var_ref> others;
+      for(usize i{}; i < 32; ++i)
+      {
+        others.emplace_back(
+          ns->intern_var(util::format("dynamic-deref-other-{}", i))->set_dynamic(true));
+        __rt_ctx
+          ->push_thread_bindings(
+            obj::persistent_hash_map::create_unique(std::make_pair(others.back(), make_box(i))))
+          .expect_ok();
+      }
+
+      ankerl::nanobench::Bench bench;
+      bench.title("dynamic var deref").unit("deref").minEpochIterations(100'000);
+      bench.run("outside binding", [&] { ankerl::nanobench::doNotOptimizeAway(v->deref()); });
+
+      __rt_ctx
+        ->push_thread_bindings(
+          obj::persistent_hash_map::create_unique(std::make_pair(v, make_box(2))))
+        .expect_ok();
+      bench.run("inside binding", [&] { ankerl::nanobench::doNotOptimizeAway(v->deref()); });
+      __rt_ctx->pop_thread_bindings().expect_ok();
+
+      auto const frame(obj::persistent_hash_map::create_unique(std::make_pair(v, make_box(3))));
+      bench.unit("binding").minEpochIterations(10'000);
+      bench.run("push and pop", [&] {
+        __rt_ctx->push_thread_bindings(frame).expect_ok();
+        __rt_ctx->pop_thread_bindings().expect_ok();
+      });
+
+      for(usize i{}; i < others.size(); ++i)
+      {
+        __rt_ctx->pop_thread_bindings().expect_ok();
+      }
+    }
+  }
+}
@@ -0,0 +1,123 @@
+#include <cstring>
+
+#include <jank/util/arena.hpp>
+#include <jank/runtime/context.hpp>
+#include <jank/runtime/core/equal.hpp>
+
+/* This must go last; doctest and glog both define CHECK and family. */
+#include <doctest/doctest.h>
+
+namespace jank::util
+{
+  TEST_SUITE("arena")
+  {
+    TEST_CASE("allocate")
+    {
+      arena a{ 256 };
+      CHECK(a.chunks.empty());
+
+      auto const first(static_cast<char *>(a.allocate(10, 1)));
+      auto const second(static_cast<char *>(a.allocate(8, 8)));
+      CHECK(first != nullptr);
+      CHECK(second == first + 16);
+      CHECK(a.chunks.size() == 1);
+      CHECK(a.stats.allocations == 2);
+      CHECK(a.stats.allocated_bytes == 18);
+    }
+
+    TEST_CASE("new chunks")
+    {
+      arena a{ 64 };
+      a.allocate(48, 8);
+      a.allocate(48, 8);
+      CHECK(a.chunks.size() == 2);
+
+      SUBCASE("bigger than a chunk")
+      {
+        a.allocate(1000, 8);
+        CHECK(a.chunks.size() == 3);
+        CHECK(a.chunks.back().size >= 1000);
+      }
+    }
+
+    TEST_CASE("scope")
+    {
+      arena a{ 64 };
+      auto const before(a.allocate(8, 8));
+      {
+        arena::scope const s{ a };
+        a.allocate(48, 8);
+        a.allocate(48, 8);
+        CHECK(a.chunks.size() == 2);
+      }
+      /* Nothing is freed on rewind; the chunks are reused. */
+      CHECK(a.chunks.size() == 2);
+      CHECK(a.current == 0);
+      CHECK(a.used == 8);
+      CHECK(static_cast<char *>(a.allocate(8, 8)) == static_cast<char *>(before) + 8);
+
+      {
+        arena::scope const s{ a };
+        a.allocate(48, 8);
+        a.allocate(48, 8);
+      }
+      CHECK(a.chunks.size() == 2);
+    }
+
+    TEST_CASE("rewound memory is cleared")
+    {
+      arena a{ 64 };
+      char *data{};
+      {
+        arena::scope const s{ a };
+        data = static_cast<char *>(a.allocate(16, 8));
+        std::memset(data, 0xFF, 16);
+      }
+      for(usize i{}; i < 16; ++i)
+      {
+        CHECK(data[i] == 0);
+      }
+    }
+
+    TEST_CASE("release")
+    {
+      arena a{ 64 };
+      a.allocate(48, 8);
+      a.allocate(48, 8);
+      a.allocate(48, 8);
+      CHECK(a.chunks.size() == 3);
+      a.release();
+      CHECK(a.chunks.size() == 1);
+      CHECK(a.stats.reserved_bytes == a.chunks[0].size);
+      CHECK(a.used == 0);
+    }
+
+    TEST_CASE("containers")
+    {
+      arena a;
+      arena_vector<int> v{ a };
+      for(int i{}; i < 1000; ++i)
+      {
+        v.push_back(i);
+      }
+      CHECK(v.size() == 1000);
+      CHECK(v[999] == 999);
+
+      arena_unordered_map<int, int> m{ 0, a };
+      for(int i{}; i < 100; ++i)
+      {
+        m.emplace(i, i * 2);
+      }
+      CHECK(m.at(50) == 100);
+    }
+
+    TEST_CASE("reading nested collections")
+    {
+      auto const form(runtime::__rt_ctx->read_string(
+        "[(1 {:a [2 #{3 4}] :b (5 6)}) {:c {:d (7 8 9)}} #{(10) [11]}]"));
+      CHECK(runtime::equal(form,
+                           runtime::__rt_ctx->read_string(
+                             "[(1 {:b (5 6) :a [2 #{4 3}]}) {:c {:d (7 8 9)}} #{[11] (10)}]")));
+    }
+  }
+}